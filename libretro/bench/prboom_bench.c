@@ -0,0 +1,462 @@
+/*
+ * prboom_bench - headless benchmark driver for the PrBoom libretro core
+ *
+ * Loads prboom_libretro.so, runs it for a number of frames with dummy
+ * video/audio/input callbacks and reports where the time in retro_run
+ * went, using the performance counters the core registers through
+ * RETRO_ENVIRONMENT_GET_PERF_INTERFACE:
+ *
+ *   prboom_video  D_Display, including the video callback
+ *   prboom_audio  I_UpdateSound
+ *
+ * Whatever is left of retro_run is counted as game tic time.
+ * The time retro_load_game took (WAD loading and startup, and the
+ * -kernels checks if asked for) is reported on its own.
+ *
+ * Usage: prboom_bench [options] <wad or lmp>
+ *   -core <path>       core to load (default ./prboom_libretro.so)
+ *   -frames <n>        frames to run (default 1000)
+ *   -system <dir>      system directory (default: the content's directory)
+ *   -save <dir>        save directory (default: the system directory)
+ *   -o <key>=<value>   set a core option, e.g. -o prboom-resolution=1280x800
+ *   -savestate <n>     save and reload a state every n frames
+ *   -framebuffer       offer the core a framebuffer to draw into through
+ *                      RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER
+ *   -kernels           check the SIMD renderer loops against the C ones
+ *                      and time both when the core starts, then time
+ *                      sight checks on the first map (implies -v)
+ *   -v                 show all core log messages
+ *
+ * Like a frontend, the driver copies every frame it is handed into its
+ * own texture, unless the frame was drawn into that texture already.
+ *
+ * Stops early if the core asks to shut down (e.g. at the end of a
+ * timedemo, see the "Benchmark Demos" core option).
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include <dlfcn.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include <libretro.h>
+
+#define MAX_OPTIONS 64
+#define MAX_COUNTERS 16
+
+static const char *option_keys[MAX_OPTIONS];
+static const char *option_values[MAX_OPTIONS];
+static int num_options;
+
+static char system_dir[4096];
+static const char *save_dir;
+static int verbose;
+static bool shutdown_requested;
+
+static struct retro_perf_counter *counters[MAX_COUNTERS];
+static int num_counters;
+
+static unsigned video_width, video_height;
+static unsigned long video_frames, video_copies;
+static bool offer_framebuffer;
+static void *texture;
+static size_t texture_size;
+static unsigned long audio_samples;
+
+static retro_time_t now_usec(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (retro_time_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/*
+ * Callbacks handed to the core
+ */
+
+static void RETRO_CALLCONV log_printf(enum retro_log_level level, const char *fmt, ...)
+{
+   va_list ap;
+
+   if (!verbose && level < RETRO_LOG_WARN)
+      return;
+
+   va_start(ap, fmt);
+   vfprintf(stderr, fmt, ap);
+   va_end(ap);
+}
+
+static retro_time_t RETRO_CALLCONV perf_get_time_usec(void)
+{
+   return now_usec();
+}
+
+static retro_perf_tick_t RETRO_CALLCONV perf_get_counter(void)
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (retro_perf_tick_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint64_t RETRO_CALLCONV perf_get_cpu_features(void)
+{
+   return 0;
+}
+
+static void RETRO_CALLCONV perf_register(struct retro_perf_counter *counter)
+{
+   if (num_counters < MAX_COUNTERS)
+      counters[num_counters++] = counter;
+   counter->registered = true;
+}
+
+static void RETRO_CALLCONV perf_start(struct retro_perf_counter *counter)
+{
+   counter->call_cnt++;
+   counter->start = perf_get_counter();
+}
+
+static void RETRO_CALLCONV perf_stop(struct retro_perf_counter *counter)
+{
+   counter->total += perf_get_counter() - counter->start;
+}
+
+static void RETRO_CALLCONV perf_log(void)
+{
+}
+
+static bool RETRO_CALLCONV environment(unsigned cmd, void *data)
+{
+   switch (cmd)
+   {
+      case RETRO_ENVIRONMENT_GET_LOG_INTERFACE:
+         ((struct retro_log_callback *)data)->log = log_printf;
+         return true;
+      case RETRO_ENVIRONMENT_GET_PERF_INTERFACE:
+      {
+         struct retro_perf_callback *perf = data;
+         perf->get_time_usec    = perf_get_time_usec;
+         perf->get_cpu_features = perf_get_cpu_features;
+         perf->get_perf_counter = perf_get_counter;
+         perf->perf_register    = perf_register;
+         perf->perf_start       = perf_start;
+         perf->perf_stop        = perf_stop;
+         perf->perf_log         = perf_log;
+         return true;
+      }
+      case RETRO_ENVIRONMENT_SET_PIXEL_FORMAT:
+         return *(const enum retro_pixel_format *)data == RETRO_PIXEL_FORMAT_RGB565;
+      case RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY:
+         *(const char **)data = system_dir;
+         return true;
+      case RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY:
+         *(const char **)data = save_dir;
+         return true;
+      case RETRO_ENVIRONMENT_GET_VARIABLE:
+      {
+         struct retro_variable *var = data;
+         int i;
+
+         for (i = 0; i < num_options; i++)
+            if (!strcmp(var->key, option_keys[i]))
+            {
+               var->value = option_values[i];
+               return true;
+            }
+         var->value = NULL;
+         return false;
+      }
+      case RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE:
+         *(bool *)data = false;
+         return true;
+      case RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER:
+      {
+         struct retro_framebuffer *fb = data;
+         size_t size = fb->width * fb->height * 2;
+
+         if (!offer_framebuffer)
+            return false;
+         if (size > texture_size)
+         {
+            texture_size = size;
+            texture = realloc(texture, texture_size);
+         }
+         fb->data         = texture;
+         fb->pitch        = fb->width * 2;
+         fb->format       = RETRO_PIXEL_FORMAT_RGB565;
+         fb->memory_flags = RETRO_MEMORY_TYPE_CACHED;
+         return true;
+      }
+      case RETRO_ENVIRONMENT_SHUTDOWN:
+         shutdown_requested = true;
+         return true;
+      default:
+         return false;
+   }
+}
+
+static void RETRO_CALLCONV video_refresh(const void *data, unsigned width,
+      unsigned height, size_t pitch)
+{
+   size_t size = height * pitch;
+
+   video_width  = width;
+   video_height = height;
+   video_frames++;
+
+   /* Upload it, unless it was drawn in place */
+   if (!data || data == texture)
+      return;
+   if (size > texture_size)
+   {
+      texture_size = size;
+      texture = realloc(texture, texture_size);
+   }
+   memcpy(texture, data, size);
+   video_copies++;
+}
+
+static void RETRO_CALLCONV audio_sample(int16_t left, int16_t right)
+{
+   audio_samples++;
+}
+
+static size_t RETRO_CALLCONV audio_sample_batch(const int16_t *data, size_t frames)
+{
+   audio_samples += frames;
+   return frames;
+}
+
+static void RETRO_CALLCONV input_poll(void)
+{
+}
+
+static int16_t RETRO_CALLCONV input_state(unsigned port, unsigned device,
+      unsigned index, unsigned id)
+{
+   return 0;
+}
+
+/*
+ * Driver
+ */
+
+#define LOAD_SYM(name) \
+   if (!(name = (void *)dlsym(core, #name))) \
+   { \
+      fprintf(stderr, "prboom_bench: %s: missing %s\n", core_path, #name); \
+      return 1; \
+   }
+
+static retro_perf_tick_t counter_total(const char *ident)
+{
+   int i;
+
+   for (i = 0; i < num_counters; i++)
+      if (!strcmp(counters[i]->ident, ident))
+         return counters[i]->total;
+   return 0;
+}
+
+static void usage(void)
+{
+   fprintf(stderr,
+         "usage: prboom_bench [-core <path>] [-frames <n>] [-system <dir>] [-save <dir>]\n"
+         "                    [-o <key>=<value>]... [-savestate <n>] [-framebuffer]\n"
+         "                    [-kernels] [-v]\n"
+         "                    <wad or lmp>\n");
+}
+
+int main(int argc, char **argv)
+{
+   const char *core_path = "./prboom_libretro.so";
+   const char *content = NULL;
+   long frames = 1000, savestate_every = 0;
+   long frame, savestates = 0;
+   retro_time_t load_time, run_time = 0, savestate_time = 0, start;
+   size_t state_size = 0;
+   void *state = NULL;
+   struct retro_game_info info;
+   struct rusage usage_info;
+   double run_ms, video_ms, audio_ms, tic_ms;
+   void *core;
+   int i;
+
+   void (*retro_set_environment)(retro_environment_t);
+   void (*retro_set_video_refresh)(retro_video_refresh_t);
+   void (*retro_set_audio_sample)(retro_audio_sample_t);
+   void (*retro_set_audio_sample_batch)(retro_audio_sample_batch_t);
+   void (*retro_set_input_poll)(retro_input_poll_t);
+   void (*retro_set_input_state)(retro_input_state_t);
+   void (*retro_init)(void);
+   void (*retro_deinit)(void);
+   bool (*retro_load_game)(const struct retro_game_info *);
+   void (*retro_unload_game)(void);
+   void (*retro_run)(void);
+   size_t (*retro_serialize_size)(void);
+   bool (*retro_serialize)(void *, size_t);
+   bool (*retro_unserialize)(const void *, size_t);
+
+   for (i = 1; i < argc; i++)
+   {
+      if (!strcmp(argv[i], "-core") && i + 1 < argc)
+         core_path = argv[++i];
+      else if (!strcmp(argv[i], "-frames") && i + 1 < argc)
+         frames = atol(argv[++i]);
+      else if (!strcmp(argv[i], "-system") && i + 1 < argc)
+         snprintf(system_dir, sizeof(system_dir), "%s", argv[++i]);
+      else if (!strcmp(argv[i], "-save") && i + 1 < argc)
+         save_dir = argv[++i];
+      else if (!strcmp(argv[i], "-savestate") && i + 1 < argc)
+         savestate_every = atol(argv[++i]);
+      else if (!strcmp(argv[i], "-o") && i + 1 < argc && num_options < MAX_OPTIONS)
+      {
+         char *eq = strchr(argv[++i], '=');
+         if (!eq)
+         {
+            usage();
+            return 1;
+         }
+         *eq = '\0';
+         option_keys[num_options]     = argv[i];
+         option_values[num_options++] = eq + 1;
+      }
+      else if (!strcmp(argv[i], "-framebuffer"))
+         offer_framebuffer = true;
+      else if (!strcmp(argv[i], "-kernels") && num_options < MAX_OPTIONS)
+      {
+         option_keys[num_options]     = "prboom-bench_kernels";
+         option_values[num_options++] = "enabled";
+         verbose = 1;
+      }
+      else if (!strcmp(argv[i], "-v"))
+         verbose = 1;
+      else if (argv[i][0] != '-' && !content)
+         content = argv[i];
+      else
+      {
+         usage();
+         return 1;
+      }
+   }
+
+   if (!content || frames <= 0)
+   {
+      usage();
+      return 1;
+   }
+
+   if (!system_dir[0])
+   {
+      const char *slash = strrchr(content, '/');
+      if (slash)
+         snprintf(system_dir, sizeof(system_dir), "%.*s", (int)(slash - content), content);
+      else
+         strcpy(system_dir, ".");
+   }
+   if (!save_dir)
+      save_dir = system_dir;
+
+   if (!(core = dlopen(core_path, RTLD_NOW | RTLD_LOCAL)))
+   {
+      fprintf(stderr, "prboom_bench: %s\n", dlerror());
+      return 1;
+   }
+
+   LOAD_SYM(retro_set_environment)
+   LOAD_SYM(retro_set_video_refresh)
+   LOAD_SYM(retro_set_audio_sample)
+   LOAD_SYM(retro_set_audio_sample_batch)
+   LOAD_SYM(retro_set_input_poll)
+   LOAD_SYM(retro_set_input_state)
+   LOAD_SYM(retro_init)
+   LOAD_SYM(retro_deinit)
+   LOAD_SYM(retro_load_game)
+   LOAD_SYM(retro_unload_game)
+   LOAD_SYM(retro_run)
+   LOAD_SYM(retro_serialize_size)
+   LOAD_SYM(retro_serialize)
+   LOAD_SYM(retro_unserialize)
+
+   retro_set_environment(environment);
+   retro_init();
+   retro_set_video_refresh(video_refresh);
+   retro_set_audio_sample(audio_sample);
+   retro_set_audio_sample_batch(audio_sample_batch);
+   retro_set_input_poll(input_poll);
+   retro_set_input_state(input_state);
+
+   memset(&info, 0, sizeof(info));
+   info.path = content;
+   start = now_usec();
+   if (!retro_load_game(&info))
+   {
+      fprintf(stderr, "prboom_bench: failed to load %s\n", content);
+      return 1;
+   }
+   load_time = now_usec() - start;
+
+   /* Only time the frames themselves, not loading */
+   for (i = 0; i < num_counters; i++)
+      counters[i]->total = counters[i]->call_cnt = 0;
+
+   for (frame = 0; frame < frames && !shutdown_requested; frame++)
+   {
+      start = now_usec();
+      retro_run();
+      run_time += now_usec() - start;
+
+      if (savestate_every && (frame + 1) % savestate_every == 0)
+      {
+         start = now_usec();
+         if (!state)
+         {
+            state_size = retro_serialize_size();
+            state = malloc(state_size);
+         }
+         if (!retro_serialize(state, state_size) || !retro_unserialize(state, state_size))
+            fprintf(stderr, "prboom_bench: savestate failed at frame %ld\n", frame);
+         savestate_time += now_usec() - start;
+         savestates++;
+      }
+   }
+
+   run_ms   = run_time / 1000.0;
+   video_ms = counter_total("prboom_video") / 1000000.0;
+   audio_ms = counter_total("prboom_audio") / 1000000.0;
+   tic_ms   = run_ms - video_ms - audio_ms;
+
+   printf("load:          %10.1f ms\n", load_time / 1000.0);
+   printf("frames:        %ld (%ux%u, %lu audio frames)\n",
+         frame, video_width, video_height, audio_samples);
+   printf("frame copies:  %lu of %lu\n", video_copies, video_frames);
+   printf("retro_run:     %10.1f ms  %8.3f ms/frame  %8.1f fps\n",
+         run_ms, run_ms / frame, run_ms > 0 ? frame * 1000.0 / run_ms : 0.0);
+   printf("  video:       %10.1f ms  %8.3f ms/frame  %5.1f%%\n",
+         video_ms, video_ms / frame, run_ms > 0 ? video_ms * 100 / run_ms : 0.0);
+   printf("  audio:       %10.1f ms  %8.3f ms/frame  %5.1f%%\n",
+         audio_ms, audio_ms / frame, run_ms > 0 ? audio_ms * 100 / run_ms : 0.0);
+   printf("  game tic:    %10.1f ms  %8.3f ms/frame  %5.1f%%\n",
+         tic_ms, tic_ms / frame, run_ms > 0 ? tic_ms * 100 / run_ms : 0.0);
+   if (savestates)
+      printf("savestates:    %ld x %lu bytes, %.3f ms each\n",
+            savestates, (unsigned long)state_size, savestate_time / 1000.0 / savestates);
+
+   getrusage(RUSAGE_SELF, &usage_info);
+   printf("peak RSS:      %ld KiB\n", usage_info.ru_maxrss);
+   fflush(stdout);
+
+   retro_unload_game();
+   retro_deinit();
+   free(state);
+   free(texture);
+   return 0;
+}
@@ -1,10 +1,15 @@
 #include <sys/stat.h>
 #ifdef _WIN32
 #include <direct.h>
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN 1
+#endif
+#include <windows.h>
 #else
 #include <unistd.h>
 #endif
 #include <errno.h>
+#include <time.h>
 #include <stdarg.h>
 
 #include <libretro.h>
@@ -37,12 +42,19 @@
 #include "../src/w_wad.h"
 #include "../src/r_draw.h"
 #include "../src/r_fps.h"
+#include "../src/r_plane.h"
+#include "../src/r_thread.h"
+#include "../src/r_cache.h"
+#include "../src/r_data.h"
 #include "../src/lprintf.h"
 #include "../src/doomstat.h"
+#include "../src/d_net.h"
+#include "../src/hu_stuff.h"
 #include "../src/m_cheat.h"
 #include "../src/g_game.h"
 #include "../src/wi_stuff.h"
 #include "../src/p_tick.h"
+#include "../src/p_reject.h"
 #include "../src/z_zone.h"
 
 /* Don't include file_stream_transforms.h but instead
@@ -96,6 +108,11 @@ static unsigned doom_devices[1];
 dbool   mouse_on;
 /* Whether to search for IWADs on parent folders recursively */
 dbool   find_recursive_on;
+/* Whether demo lumps are played as timedemos (see d_bench.c) */
+static bool benchmark_demos;
+/* Whether to check and time the renderer loops at startup; set by
+ * prboom_bench -kernels, not offered as a core option */
+static bool benchmark_kernels;
 
 // System analog stick range is -0x8000 to 0x8000
 #define ANALOG_RANGE 0x8000
@@ -280,6 +297,31 @@ static void check_system_specs(void)
 
 static bool libretro_supports_bitmasks = false;
 
+static struct retro_perf_callback perf_cb;
+
+/* Split of retro_run time reported to the frontend's perf counters */
+static struct retro_perf_counter perf_video;
+static struct retro_perf_counter perf_audio;
+
+static void perf_counter_start(struct retro_perf_counter *counter,
+      const char *ident)
+{
+   if (!perf_cb.perf_start)
+      return;
+   if (!counter->registered)
+   {
+      counter->ident = ident;
+      perf_cb.perf_register(counter);
+   }
+   perf_cb.perf_start(counter);
+}
+
+static void perf_counter_stop(struct retro_perf_counter *counter)
+{
+   if (perf_cb.perf_stop && counter->registered)
+      perf_cb.perf_stop(counter);
+}
+
 void retro_init(void)
 {
    enum retro_pixel_format rgb565;
@@ -292,6 +334,9 @@ void retro_init(void)
    else
       log_cb = NULL;
 
+   if(!environ_cb(RETRO_ENVIRONMENT_GET_PERF_INTERFACE, &perf_cb))
+      memset(&perf_cb, 0, sizeof(perf_cb));
+
    rgb565 = RETRO_PIXEL_FORMAT_RGB565;
    if(environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &rgb565) && log_cb)
       log_cb(RETRO_LOG_DEBUG, "Frontend supports RGB565 - will use that instead of XRGB1555.\n");
@@ -304,6 +349,7 @@ void retro_init(void)
 
 void retro_deinit(void)
 {
+   R_ShutdownRenderThreads();
    D_DoomDeinit();
 
    if (screen_buf)
@@ -550,6 +596,26 @@ static void update_variables(bool startup)
          SCREENWIDTH = 320;
          SCREENHEIGHT = 200;
       }
+
+      var.key = "prboom-benchmark";
+      var.value = NULL;
+      benchmark_demos = false;
+      if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+         if (!strcmp(var.value, "enabled"))
+            benchmark_demos = true;
+
+      var.key = "prboom-bench_kernels";
+      var.value = NULL;
+      benchmark_kernels = false;
+      if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+         if (!strcmp(var.value, "enabled"))
+            benchmark_kernels = true;
+
+      var.key = "prboom-startup_cache";
+      var.value = NULL;
+      r_startupcache = false;
+      if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+         r_startupcache = !strcmp(var.value, "enabled");
    }
 
    var.key = "prboom-mouse_on";
@@ -573,6 +639,35 @@ static void update_variables(bool startup)
          find_recursive_on = false;
    }
 
+   var.key = "prboom-memory_stats";
+   var.value = NULL;
+   hud_showmemory = false;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      hud_showmemory = !strcmp(var.value, "enabled");
+
+   var.key = "prboom-prefetch";
+   var.value = NULL;
+   r_prefetch = true;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      r_prefetch = !strcmp(var.value, "enabled");
+
+   var.key = "prboom-incremental_load";
+   var.value = NULL;
+   incremental_load = true;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      incremental_load = !strcmp(var.value, "enabled");
+
+   var.key = "prboom-build_reject";
+   var.value = NULL;
+   p_buildreject = false;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      p_buildreject = !strcmp(var.value, "enabled");
+
+   var.key = "prboom-sort_visplanes";
+   var.value = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      r_sortvisplanes = !strcmp(var.value, "enabled");
+
    var.key = "prboom-rumble";
    var.value = NULL;
    rumble_enabled = false;
@@ -600,6 +695,13 @@ static void update_variables(bool startup)
       Z_SetPurgeLimit(purge_limit);
    }
 #endif
+
+#ifdef RENDER_THREADS
+   var.key = "prboom-render_threads";
+   var.value = NULL;
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      R_InitRenderThreads(atoi(var.value));
+#endif
 }
 
 void I_SafeExit(int rc);
@@ -637,7 +739,9 @@ void retro_run(void)
       return;
    }
    D_DoomLoop();
+   perf_counter_start(&perf_audio, "prboom_audio");
    I_UpdateSound();
+   perf_counter_stop(&perf_audio);
 
    if (rumble_damage_counter > -1)
    {
@@ -744,6 +848,8 @@ bool retro_load_game(const struct retro_game_info *info)
    update_variables(true);
 
    argv[argc++] = strdup("prboom");
+   if (benchmark_kernels)
+      argv[argc++] = strdup("-benchkernels");
    if(info->path)
    {
       wadinfo_t header;
@@ -760,7 +866,7 @@ bool retro_load_game(const struct retro_game_info *info)
       if(strcasecmp(extension,"lmp") == 0)
       {
         // Play as a demo file lump
-        argv[argc++] = strdup("-playdemo");
+        argv[argc++] = strdup(benchmark_demos ? "-timedemo" : "-playdemo");
         argv[argc++] = strdup(info->path);
       }
       else
@@ -826,6 +932,11 @@ bool retro_load_game(const struct retro_game_info *info)
 		}
    }
 
+   /* Go straight to the first map, for D_BenchSight to look around.
+    * Last, so that -warp isn't followed by a map number */
+   if (benchmark_kernels)
+      argv[argc++] = strdup("-warp");
+
 #if DEBUG
    argv[argc++] = "-dehout";
    argv[argc++] = "-";
@@ -985,6 +1096,10 @@ bool retro_serialize(void *data_, size_t size)
   unsigned i;
   struct extra_serialize *extra = data_;
 
+  // there's no state to save halfway through a level load
+  if (G_LevelLoading())
+    return false;
+
   if (gamestate == GS_LEVEL) {
     int ret = G_DoSaveGameToBuffer((char *) data_ + sizeof(*extra),
 				   size - sizeof(*extra));
@@ -1028,6 +1143,7 @@ bool retro_unserialize(const void *data_, size_t size)
 {
   const struct extra_serialize *extra = data_;
   int gameless = 0;
+
   if (extra->extra_size == sizeof(*extra))
     gameless = (extra->gamestate != GS_LEVEL);
   if (!gameless) {
@@ -1047,6 +1163,8 @@ bool retro_unserialize(const void *data_, size_t size)
   if (extra->extra_size == sizeof(*extra))
     {
       unsigned i;
+      // the state loaded replaces any level still being loaded
+      G_AbortLoadLevel();
       gametic = maketic = extra->gametic;
       gameaction = extra->gameaction;
       turnheld = extra->turnheld;
@@ -1562,6 +1680,7 @@ static void I_UpdateVideoMode(void)
 {
    V_InitMode();
    V_DestroyUnusedTrueColorPalettes();
+   V_FreePatchCache();
    V_FreeScreens();
 
    I_SetRes();
@@ -1574,11 +1693,53 @@ static void I_UpdateVideoMode(void)
    R_InitBuffer(SCREENWIDTH, SCREENHEIGHT);
 }
 
+/* Whether screen_buf holds the last frame drawn */
+static dbool screen_buf_current = true;
+
+static void I_SetScreenData(unsigned char *data)
+{
+   screens[0].data        = data;
+   drawvars.short_topleft = (unsigned short *)data;
+   drawvars.int_topleft   = (unsigned int *)data;
+}
+
+/* I_SetFrameBuffer
+ * Picks the memory the coming frame is drawn into. If allowed, and the
+ * frontend offers a framebuffer of the right format and pitch, that's
+ * drawn into directly so the frontend needn't copy the frame out of
+ * screen_buf; its contents are undefined though. Returns false if
+ * screens[0] doesn't hold the previous frame.
+ */
+dbool I_SetFrameBuffer(dbool allowfrontend)
+{
+   struct retro_framebuffer fb = {0};
+   unsigned char *data = screen_buf;
+   dbool kept;
+
+   fb.width        = SCREENWIDTH;
+   fb.height       = SCREENHEIGHT;
+   fb.access_flags = RETRO_MEMORY_ACCESS_WRITE | RETRO_MEMORY_ACCESS_READ;
+
+   /* The renderer reads back what it drew (fuzz, translucency, the
+    * status bar cache), so uncached video memory is no good */
+   if (allowfrontend &&
+       environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &fb) &&
+       fb.data && fb.format == RETRO_PIXEL_FORMAT_RGB565 &&
+       fb.width == (unsigned)SCREENWIDTH && fb.height == (unsigned)SCREENHEIGHT &&
+       fb.pitch == (size_t)SCREENPITCH && (fb.memory_flags & RETRO_MEMORY_TYPE_CACHED))
+      data = fb.data;
+
+   kept = data == screen_buf && screen_buf_current;
+   screen_buf_current = data == screen_buf;
+   I_SetScreenData(data);
+   return kept;
+}
+
 void I_FinishUpdate (void)
 {
    if (!video_cb)
      return;
-   video_cb(screen_buf, SCREENWIDTH, SCREENHEIGHT, SCREENPITCH);
+   video_cb(screens[0].data, SCREENWIDTH, SCREENHEIGHT, SCREENPITCH);
 }
 
 void I_SetPalette (int pal)
@@ -1608,6 +1769,7 @@ void I_SetRes(void)
       screens[i].height = SCREENHEIGHT;
 
    screens[4].height = (ST_SCALED_HEIGHT+1);
+   screens[5].height = (ST_SCALED_HEIGHT+1);
 }
 
 /* i_system - i_main */
@@ -1620,11 +1782,15 @@ dbool   I_StartDisplay(void)
       return false;
 
    InDisplay = true;
+   perf_counter_start(&perf_video, "prboom_video");
    return true;
 }
 
 void I_EndDisplay(void)
 {
+   /* The frontend's framebuffer is only good until retro_run returns */
+   I_SetScreenData(screen_buf);
+   perf_counter_stop(&perf_video);
    InDisplay = false;
 }
 
@@ -1637,6 +1803,39 @@ unsigned long I_GetRandomTimeSeed(void)
    return 0;
 }
 
+/*
+* I_GetTimeUS
+*
+* Falls back to the system's monotonic clock if the frontend has no perf
+* interface, and to processor time where there's none
+*/
+int64_t I_GetTimeUS(void)
+{
+   if (perf_cb.get_time_usec)
+      return perf_cb.get_time_usec();
+#if defined(_WIN32)
+   {
+      static LARGE_INTEGER freq;
+      LARGE_INTEGER count;
+
+      if (!freq.QuadPart)
+         QueryPerformanceFrequency(&freq);
+      QueryPerformanceCounter(&count);
+      return count.QuadPart / freq.QuadPart * 1000000 +
+             count.QuadPart % freq.QuadPart * 1000000 / freq.QuadPart;
+   }
+#elif defined(CLOCK_MONOTONIC)
+   {
+      struct timespec ts;
+
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+   }
+#else
+   return (int64_t)clock() * 1000000 / CLOCKS_PER_SEC;
+#endif
+}
+
 #ifdef PRBOOM_SERVER
 
 /* cphipps - I_SigString
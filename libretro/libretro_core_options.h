@@ -117,6 +117,90 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       },
       "15"
    },
+   {
+      "prboom-benchmark",
+      "Benchmark Demos",
+      NULL,
+      "When a demo lump (.lmp) is loaded, plays it back as fast as possible and writes per-frame renderer timings to 'timedemo_<demo>.csv' in the save directory. The core closes when the demo ends. Takes effect when content is loaded.",
+      NULL,
+      NULL,
+      {
+         { "disabled", NULL },
+         { "enabled",  NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "prboom-memory_stats",
+      "Show Memory Statistics",
+      NULL,
+      "Draws live and peak memory use, live blocks and allocations per tic for each zone memory tag over the game screen. Useful for choosing a cache size on low memory devices.",
+      NULL,
+      NULL,
+      {
+         { "disabled", NULL },
+         { "enabled",  NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "prboom-prefetch",
+      "Prefetch Next Level",
+      NULL,
+      "Loads the next level's map data, wall textures, flats and sprites a little at a time during the intermission, so the level starts without a pause.",
+      NULL,
+      NULL,
+      {
+         { "enabled",  NULL },
+         { "disabled", NULL },
+         { NULL, NULL },
+      },
+      "enabled"
+   },
+   {
+      "prboom-incremental_load",
+      "Incremental Level Loading",
+      NULL,
+      "Spreads the loading of the next level over several frames, keeping the intermission screen and its sound going, instead of freezing while a big level loads.",
+      NULL,
+      NULL,
+      {
+         { "enabled",  NULL },
+         { "disabled", NULL },
+         { NULL, NULL },
+      },
+      "enabled"
+   },
+   {
+      "prboom-build_reject",
+      "Build Missing Reject Tables",
+      NULL,
+      "For maps that ship an empty REJECT table, works out at level load which sectors can never see each other, so monsters skip those line of sight checks. Stored in the save directory. Not used during demos or netgames.",
+      NULL,
+      NULL,
+      {
+         { "disabled", NULL },
+         { "enabled",  NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "prboom-startup_cache",
+      "Startup Cache",
+      NULL,
+      "Stores texture definitions and sprite frames in the save directory, keyed by the loaded WAD files, so the next start with the same WADs can load them instead of rebuilding them. Speeds up starting large megawads. Takes effect on restart.",
+      NULL,
+      NULL,
+      {
+         { "disabled", NULL },
+         { "enabled",  NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
 #if defined(MEMORY_LOW)
    {
       "prboom-purge_limit",
@@ -139,6 +223,40 @@ struct retro_core_option_v2_definition option_defs_us[] = {
       },
       "16"
    },
+#endif
+   {
+      "prboom-sort_visplanes",
+      "Group Floors By Texture",
+      NULL,
+      "Draws floors and ceilings sharing a texture and light level one after another, which keeps the texture in the CPU cache. Does not change the picture.",
+      NULL,
+      NULL,
+      {
+         { "disabled", NULL },
+         { "enabled",  NULL },
+         { NULL, NULL },
+      },
+      "enabled"
+   },
+#if defined(HAVE_RENDER_THREADS) && !defined(MEMORY_LOW)
+   {
+      "prboom-render_threads",
+      "Render Threads",
+      NULL,
+      "Splits the 3D view into vertical strips drawn in parallel. Can greatly improve performance at high internal resolutions on multi-core CPUs.",
+      NULL,
+      NULL,
+      {
+         { "1", NULL },
+         { "2", NULL },
+         { "3", NULL },
+         { "4", NULL },
+         { "6", NULL },
+         { "8", NULL },
+         { NULL, NULL },
+      },
+      "1"
+   },
 #endif
    { NULL, NULL, NULL, NULL, NULL, NULL, {{0}}, NULL },
 };
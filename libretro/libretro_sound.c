@@ -188,7 +188,7 @@ static void* I_SndLoadSample (const char* sfxname, int* len)
             padded_sfx_data[i] = 128; // fill the rest with silence
     }
 
-    Z_Free ((void*) sfxlump_data); //  free original lump
+    W_UnlockLumpNum (sfxlump_num); //  done with the original lump
 
     *len = padded_sfx_len;
     return (void *)(padded_sfx_data);
@@ -0,0 +1,649 @@
+/* Emacs style mode select   -*- C++ -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *  Copyright (C) 1999 by
+ *  id Software, Chi Hoang, Lee Killough, Jim Flynn, Rand Phares, Ty Halderman
+ *  Copyright (C) 1999-2000 by
+ *  Jess Haas, Nicolas Kalkhof, Colin Phipps, Florian Schulze, Andrey Budko
+ *  Copyright 2005, 2006 by
+ *  Florian Schulze, Colin Phipps, Neil Stevens, Andrey Budko
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *      Timed demo playback and per-frame renderer timings.
+ *      Started with -timedemo (or the "Benchmark Demos" core option
+ *      when a demo lump is loaded). When the demo ends the frame rate
+ *      is logged and the 50th/95th/99th percentile time of each part
+ *      of the frame is written to timedemo_<demo>.csv in the save
+ *      directory.
+ *
+ *      -benchkernels checks and times the renderer's inner loops on
+ *      made up input once the game has started up: the SSE2/NEON span
+ *      drawers are run on the same random spans as the C ones, their
+ *      output compared pixel for pixel and both timed. Columns are
+ *      then drawn with 1, 2, 4... of them batched per flush, up to the
+ *      TEMPBUF_WIDTH r_draw.c was built with, to time each width.
+ *      Last, every lump name is looked up through the lump hash
+ *      tables and checked against a linear scan of the lump list.
+ *      When the first level has loaded, every monster on it checks
+ *      whether it can see the players, with and without the sight
+ *      cache, to time the cache on maps full of monsters.
+ *
+ *---------------------------------------------------------------------
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <streams/file_stream.h>
+
+#include "doomstat.h"
+#include "d_main.h"
+#include "i_system.h"
+#include "w_wad.h"
+#include "r_main.h"
+#include "r_draw.h"
+#include "v_video.h"
+#include "p_map.h"
+#include "p_tick.h"
+#include "p_mobj.h"
+#include "d_bench.h"
+#include "lprintf.h"
+
+int rfprintf(RFILE *stream, const char *fmt, ...);
+
+dbool timingdemo;
+
+static const char *const benchtimernames[NUMBENCHTIMERS] = {
+  "R_RenderBSPNode",
+  "R_DrawPlanes",
+  "R_DrawMasked",
+  "ST_Drawer",
+  "HU_Drawer",
+  "frame",
+};
+
+// Time spent so far in each part of the current frame, in microseconds
+static int64_t bench_begin[NUMBENCHTIMERS];
+static unsigned bench_current[NUMBENCHTIMERS];
+
+// Per-frame totals of every timer, grown as the demo plays
+static unsigned *bench_samples[NUMBENCHTIMERS];
+static int bench_frames, bench_maxframes;
+static int64_t bench_starttime;
+
+// Busiest frame's visplane count and longest visplane hash chain
+static int bench_maxvisplanes, bench_maxchain;
+
+static int D_BenchCompare(const void *a, const void *b)
+{
+  unsigned x = *(const unsigned *)a, y = *(const unsigned *)b;
+  return x < y ? -1 : x > y;
+}
+
+// Nearest rank percentile of a sorted list of samples
+static unsigned D_BenchPercentile(const unsigned *sorted, int count, int pct)
+{
+  int rank = (pct * count + 99) / 100;
+  return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+void D_BenchStart(void)
+{
+  bench_frames = 0;
+  bench_maxvisplanes = bench_maxchain = 0;
+  memset(bench_current, 0, sizeof(bench_current));
+  bench_starttime = I_GetTimeUS();
+}
+
+void D_BenchBegin(benchtimer_e timer)
+{
+  bench_begin[timer] = I_GetTimeUS();
+}
+
+void D_BenchEnd(benchtimer_e timer)
+{
+  int i;
+
+  bench_current[timer] += (unsigned)(I_GetTimeUS() - bench_begin[timer]);
+  if (timer != BENCH_FRAME)
+    return;
+
+  // End of the frame, keep what each part of it took
+  if (bench_frames == bench_maxframes)
+  {
+    bench_maxframes = bench_maxframes ? bench_maxframes * 2 : 4096;
+    for (i = 0; i < NUMBENCHTIMERS; i++)
+      bench_samples[i] = realloc(bench_samples[i],
+                                 bench_maxframes * sizeof(*bench_samples[i]));
+  }
+  for (i = 0; i < NUMBENCHTIMERS; i++)
+    bench_samples[i][bench_frames] = bench_current[i];
+  bench_frames++;
+
+  if (rendered_visplanes > bench_maxvisplanes)
+    bench_maxvisplanes = rendered_visplanes;
+  if (rendered_visplane_chain > bench_maxchain)
+    bench_maxchain = rendered_visplane_chain;
+  memset(bench_current, 0, sizeof(bench_current));
+}
+
+void D_BenchFinish(const char *demoname)
+{
+  int64_t elapsed = I_GetTimeUS() - bench_starttime;
+  char basename[9];
+  char *csvname;
+  RFILE *f;
+#ifdef _WIN32
+  char slash = '\\';
+#else
+  char slash = '/';
+#endif
+  int i, j;
+
+  if (bench_frames == 0)
+    return;
+
+  lprintf(LO_INFO, "D_BenchFinish: %d frames in %.3f seconds, %.2f fps\n",
+          bench_frames, elapsed / 1000000.0,
+          elapsed > 0 ? bench_frames * 1000000.0 / elapsed : 0.0);
+  lprintf(LO_INFO, "D_BenchFinish: up to %d visplanes, hash chains up to %d\n",
+          bench_maxvisplanes, bench_maxchain);
+  P_PrintSightStats();
+
+  ExtractFileBase(demoname, basename);
+  basename[8] = 0;
+  csvname = malloc(strlen(basesavegame) + strlen(basename) + 16);
+  sprintf(csvname, "%s%ctimedemo_%s.csv", basesavegame, slash, basename);
+
+  f = filestream_open(csvname,
+        RETRO_VFS_FILE_ACCESS_WRITE,
+        RETRO_VFS_FILE_ACCESS_HINT_NONE);
+  if (!f)
+    lprintf(LO_WARN, "D_BenchFinish: couldn't write %s\n", csvname);
+  else
+    rfprintf(f, "timer,frames,mean_us,p50_us,p95_us,p99_us,max_us\n");
+
+  for (i = 0; i < NUMBENCHTIMERS; i++)
+  {
+    unsigned *sorted = bench_samples[i];
+    uint64_t total = 0;
+
+    qsort(sorted, bench_frames, sizeof(*sorted), D_BenchCompare);
+    for (j = 0; j < bench_frames; j++)
+      total += sorted[j];
+
+    lprintf(LO_INFO, "  %-16s p50 %6u us  p95 %6u us  p99 %6u us\n",
+            benchtimernames[i],
+            D_BenchPercentile(sorted, bench_frames, 50),
+            D_BenchPercentile(sorted, bench_frames, 95),
+            D_BenchPercentile(sorted, bench_frames, 99));
+    if (f)
+      rfprintf(f, "%s,%d,%u,%u,%u,%u,%u\n", benchtimernames[i], bench_frames,
+               (unsigned)(total / bench_frames),
+               D_BenchPercentile(sorted, bench_frames, 50),
+               D_BenchPercentile(sorted, bench_frames, 95),
+               D_BenchPercentile(sorted, bench_frames, 99),
+               sorted[bench_frames - 1]);
+
+    free(bench_samples[i]);
+    bench_samples[i] = NULL;
+  }
+  bench_frames = bench_maxframes = 0;
+
+  if (f)
+  {
+    filestream_close(f);
+    lprintf(LO_INFO, "D_BenchFinish: wrote %s\n", csvname);
+  }
+  free(csvname);
+}
+
+//
+// Renderer kernel checks (-benchkernels)
+//
+
+// Own generator, so the checks leave the game's random numbers alone
+static unsigned bench_seed;
+
+static unsigned D_BenchRandom(void)
+{
+  bench_seed = bench_seed * 1103515245 + 12345;
+  return bench_seed >> 8;
+}
+
+static fixed_t D_BenchRandomFixed(void)
+{
+  return (fixed_t)((D_BenchRandom() << 16) ^ D_BenchRandom());
+}
+
+#define BENCH_SPANS 20000
+
+static void D_BenchRandomSpan(draw_span_vars_t *dsvars, const uint8_t *source)
+{
+  const fixed_t mag = drawvars.mag_threshold;
+  const lighttable_t *colormap =
+    colormaps[0] + (D_BenchRandom() % (NUMCOLORMAPS - 1)) * 256;
+
+  dsvars->y = D_BenchRandom() % SCREENHEIGHT;
+  dsvars->x1 = D_BenchRandom() % SCREENWIDTH;
+  dsvars->x2 = dsvars->x1 + D_BenchRandom() % (SCREENWIDTH - dsvars->x1);
+  dsvars->z = D_BenchRandomFixed();
+  dsvars->xfrac = D_BenchRandomFixed();
+  dsvars->yfrac = D_BenchRandomFixed();
+
+  // Half the spans magnified, so the filtered drawers filter them,
+  // half minified, so they are point sampled
+  if (D_BenchRandom() & 1)
+  {
+    dsvars->xstep = (fixed_t)(D_BenchRandom() % (2 * mag + 1)) - mag;
+    dsvars->ystep = (fixed_t)(D_BenchRandom() % (2 * mag + 1)) - mag;
+  }
+  else
+  {
+    dsvars->xstep = (fixed_t)(D_BenchRandom() % (32 * FRACUNIT)) - 16 * FRACUNIT;
+    dsvars->ystep = (fixed_t)(D_BenchRandom() % (32 * FRACUNIT)) - 16 * FRACUNIT;
+  }
+
+  dsvars->source = source;
+  dsvars->colormap = colormap;
+  dsvars->nextcolormap = colormap + 256;
+}
+
+// Time one drawer over all the spans, in nanoseconds per pixel
+static double D_BenchTimeSpans(R_DrawSpan_f drawspan,
+                               const draw_span_vars_t *spans, int64_t pixels)
+{
+  int64_t start = I_GetTimeUS();
+  draw_span_vars_t dsvars;
+  int i;
+
+  for (i = 0; i < BENCH_SPANS; i++)
+  {
+    dsvars = spans[i];
+    drawspan(&dsvars);
+  }
+  return (I_GetTimeUS() - start) * 1000.0 / pixels;
+}
+
+static void D_BenchSpans(void)
+{
+  static const char *const filternames[RDRAW_FILTER_MAXFILTERS] = {
+    "none", "point", "linear", "rounded"
+  };
+  const size_t screensize = SCREENWIDTH * SCREENHEIGHT * sizeof(uint16_t);
+  uint16_t *const savedtopleft = drawvars.short_topleft;
+  uint16_t *screen_c = malloc(screensize);
+  uint16_t *screen_simd = malloc(screensize);
+  draw_span_vars_t *spans = malloc(BENCH_SPANS * sizeof(*spans));
+  uint8_t source[64*64];
+  int filter, filterz, i, tested = 0;
+
+  if (!V_Palette16)
+    V_SetPalette(0);
+
+  for (filterz = 0; filterz < RDRAW_FILTER_MAXFILTERS; filterz++)
+    for (filter = 0; filter < RDRAW_FILTER_MAXFILTERS; filter++)
+    {
+      R_DrawSpan_f drawspan_c = R_GetDrawSpanFuncC(filter, filterz);
+      R_DrawSpan_f drawspan_simd = R_GetDrawSpanFuncSIMD(filter, filterz);
+      draw_span_vars_t dsvars;
+      int64_t pixels = 0;
+      int mismatches = 0;
+      double time_c, time_simd;
+
+      if (!drawspan_c || !drawspan_simd)
+        continue;
+      tested++;
+
+      bench_seed = 1;
+      for (i = 0; i < 64*64; i++)
+        source[i] = (uint8_t)D_BenchRandom();
+      for (i = 0; i < BENCH_SPANS; i++)
+      {
+        D_BenchRandomSpan(&spans[i], source);
+        pixels += spans[i].x2 - spans[i].x1 + 1;
+      }
+
+      // Each span on its own, compared with the whole row it is on so
+      // that a write past either end of the span is caught too
+      memset(screen_c, 0, screensize);
+      memset(screen_simd, 0, screensize);
+      for (i = 0; i < BENCH_SPANS; i++)
+      {
+        const size_t row = spans[i].y * SCREENWIDTH;
+
+        drawvars.short_topleft = screen_c;
+        dsvars = spans[i];
+        drawspan_c(&dsvars);
+        drawvars.short_topleft = screen_simd;
+        dsvars = spans[i];
+        drawspan_simd(&dsvars);
+
+        if (memcmp(screen_c + row, screen_simd + row,
+                   SCREENWIDTH * sizeof(uint16_t)))
+        {
+          if (!mismatches++)
+            lprintf(LO_WARN, "D_BenchSpans: %s/%s differs from C on span "
+                    "y %d, x %d-%d, step %d,%d\n",
+                    filternames[filter], filternames[filterz], spans[i].y,
+                    spans[i].x1, spans[i].x2, spans[i].xstep, spans[i].ystep);
+          memcpy(screen_simd + row, screen_c + row,
+                 SCREENWIDTH * sizeof(uint16_t));
+        }
+      }
+      if (memcmp(screen_c, screen_simd, screensize))
+        mismatches++;
+
+      drawvars.short_topleft = screen_c;
+      time_c = D_BenchTimeSpans(drawspan_c, spans, pixels);
+      drawvars.short_topleft = screen_simd;
+      time_simd = D_BenchTimeSpans(drawspan_simd, spans, pixels);
+
+      lprintf(mismatches ? LO_WARN : LO_INFO,
+              "D_BenchSpans: %s/%s %s, C %.2f ns/pixel, SIMD %.2f ns/pixel\n",
+              filternames[filter], filternames[filterz],
+              mismatches ? "DIFFERS" : "identical", time_c, time_simd);
+    }
+
+  if (!tested)
+    lprintf(LO_INFO, "D_BenchSpans: no SSE2/NEON span drawers on this CPU\n");
+
+  drawvars.short_topleft = savedtopleft;
+  free(spans);
+  free(screen_simd);
+  free(screen_c);
+}
+
+#define BENCH_COLUMN_FRAMES 50
+
+// Draws a screen of wall-like columns BENCH_COLUMN_FRAMES times over,
+// returns nanoseconds per pixel
+static double D_BenchTimeColumns(R_DrawColumn_f colfunc,
+                                 const draw_column_vars_t *column,
+                                 const int *yl, const int *yh, int64_t pixels)
+{
+  int64_t start = I_GetTimeUS();
+  draw_column_vars_t dcvars;
+  int frame, x;
+
+  for (frame = 0; frame < BENCH_COLUMN_FRAMES; frame++)
+  {
+    for (x = 0; x < SCREENWIDTH; x++)
+    {
+      dcvars = *column;
+      dcvars.x = x;
+      dcvars.yl = yl[x];
+      dcvars.yh = yh[x];
+      colfunc(&dcvars);
+    }
+    R_ResetColumnBuffer();
+  }
+  return (I_GetTimeUS() - start) * 1000.0 / (pixels * BENCH_COLUMN_FRAMES);
+}
+
+// Column drawing with 1, 2, 4... columns batched per flush, up to the
+// TEMPBUF_WIDTH r_draw.c was built with. Fuzz depends on what it's
+// drawn over and where the fuzz table is at, so only the opaque and
+// translated results are compared between batch widths.
+static void D_BenchColumns(void)
+{
+  static const struct {
+    enum column_pipeline_e pipeline;
+    const char *name;
+  } pipelines[] = {
+    { RDC_PIPELINE_STANDARD,   "opaque" },
+    { RDC_PIPELINE_TRANSLATED, "translated" },
+    { RDC_PIPELINE_FUZZ,       "fuzz" },
+  };
+  const size_t screensize = SCREENWIDTH * SCREENHEIGHT * sizeof(uint16_t);
+  uint16_t *const savedtopleft = drawvars.short_topleft;
+  uint16_t *screen = malloc(screensize);
+  uint16_t *reference = malloc(screensize);
+  int *yl = malloc(SCREENWIDTH * sizeof(*yl));
+  int *yh = malloc(SCREENWIDTH * sizeof(*yh));
+  draw_column_vars_t column;
+  uint8_t source[128];
+  int64_t pixels = 0;
+  int i, x;
+
+  bench_seed = 1;
+  for (i = 0; i < 128; i++)
+    source[i] = (uint8_t)D_BenchRandom();
+
+  // Tops and bottoms a few pixels apart from their neighbours, as on a
+  // wall seen at an angle, keeping a row clear above and below for fuzz
+  for (x = 0; x < SCREENWIDTH; x++)
+  {
+    yl[x] = 1 + SCREENHEIGHT/4 - SCREENHEIGHT/8 * x / SCREENWIDTH
+          + D_BenchRandom() % 4;
+    yh[x] = SCREENHEIGHT - 2 - SCREENHEIGHT/4 + SCREENHEIGHT/8 * x / SCREENWIDTH
+          - D_BenchRandom() % 4;
+    pixels += yh[x] - yl[x] + 1;
+  }
+
+  R_SetDefaultDrawColumnVars(&column);
+  column.source = column.prevsource = column.nextsource = source;
+  column.texheight = 128;
+  column.iscale = FRACUNIT / 2;
+  column.texturemid = 37 * FRACUNIT;
+  column.colormap = column.nextcolormap = colormaps[0] + 8 * 256;
+  column.translation = translationtables;
+  column.edgetype = RDRAW_MASKEDCOLUMNEDGE_SQUARE;
+
+  drawvars.short_topleft = screen;
+  for (i = 0; i < (int)(sizeof(pipelines)/sizeof(*pipelines)); i++)
+  {
+    R_DrawColumn_f colfunc = R_GetDrawColumnFunc(pipelines[i].pipeline,
+      RDRAW_FILTER_POINT, RDRAW_FILTER_POINT);
+    int width, batch;
+
+    for (width = 1; (batch = R_SetColumnBatch(width)) == width; width *= 2)
+    {
+      dbool differs = FALSE;
+      double time;
+
+      memset(screen, 0, screensize);
+      time = D_BenchTimeColumns(colfunc, &column, yl, yh, pixels);
+
+      if (pipelines[i].pipeline != RDC_PIPELINE_FUZZ)
+      {
+        if (width == 1)
+          memcpy(reference, screen, screensize);
+        else
+          differs = memcmp(reference, screen, screensize) != 0;
+      }
+
+      lprintf(differs ? LO_WARN : LO_INFO,
+              "D_BenchColumns: %s, %2d columns a flush, %.2f ns/pixel%s\n",
+              pipelines[i].name, width, time,
+              differs ? ", DIFFERS from 1 column a flush" : "");
+    }
+  }
+  R_SetColumnBatch(INT_MAX);
+
+  drawvars.short_topleft = savedtopleft;
+  free(yh);
+  free(yl);
+  free(reference);
+  free(screen);
+}
+
+#define BENCH_LUMP_PASSES 20
+
+// Every lump looked up by name in its own namespace through the hash
+// tables, and a sample of them by scanning the lump list backwards, as
+// lookups were done before there were tables, to check the answers.
+// The scan is quadratic in the number of lumps, so only up to 2000 of
+// them are scanned for.
+static void D_BenchLumps(void)
+{
+  const int step = numlumps > 2000 ? numlumps / 2000 : 1;
+  int64_t start, hashtime, scantime;
+  int i, j, pass, sampled = 0, mismatches = 0;
+  unsigned found = 0;
+
+  if (!numlumps)
+    return;
+
+  start = I_GetTimeUS();
+  for (pass = 0; pass < BENCH_LUMP_PASSES; pass++)
+    for (i = 0; i < numlumps; i++)
+      found += (W_CheckNumForName)(lumpinfo[i].name, lumpinfo[i].li_namespace) >= 0;
+  hashtime = I_GetTimeUS() - start;
+
+  start = I_GetTimeUS();
+  for (i = 0; i < numlumps; i += step)
+  {
+    for (j = numlumps - 1; j >= 0; j--)
+      if (lumpinfo[j].li_namespace == lumpinfo[i].li_namespace &&
+          !strncasecmp(lumpinfo[j].name, lumpinfo[i].name, 8))
+        break;
+    if ((W_CheckNumForName)(lumpinfo[i].name, lumpinfo[i].li_namespace) != j)
+    {
+      if (!mismatches++)
+        lprintf(LO_WARN, "D_BenchLumps: %.8s found at %d, the scan found %d\n",
+                lumpinfo[i].name,
+                (W_CheckNumForName)(lumpinfo[i].name, lumpinfo[i].li_namespace), j);
+    }
+    sampled++;
+  }
+  scantime = I_GetTimeUS() - start;
+
+  lprintf(mismatches ? LO_WARN : LO_INFO,
+          "D_BenchLumps: %d lumps, hashed %.1f ns/lookup, scanned %.1f ns/lookup, "
+          "%d of %d sampled lookups differ\n", numlumps,
+          hashtime * 1000.0 / ((double)numlumps * BENCH_LUMP_PASSES),
+          scantime * 1000.0 / sampled, mismatches, sampled);
+  if (found != (unsigned)numlumps * BENCH_LUMP_PASSES)
+    lprintf(LO_WARN, "D_BenchLumps: %u of %d lookups found nothing\n",
+            (unsigned)numlumps * BENCH_LUMP_PASSES - found,
+            numlumps * BENCH_LUMP_PASSES);
+}
+
+void D_BenchKernels(void)
+{
+  D_BenchSpans();
+  D_BenchColumns();
+  D_BenchLumps();
+}
+
+//
+// Sight checks on the first level loaded (-benchkernels)
+//
+
+#define BENCH_SIGHT_TICS 10
+
+// Every living monster checks its sight of every player twice a tic,
+// as a chasing monster does (P_CheckMissileRange, then the pursuit
+// check in A_Chase), for BENCH_SIGHT_TICS tics: first with the sight
+// cache cleared before every check, so each one walks the BSP, then
+// with it cleared once a tic as in play. Both must see the same.
+static int64_t D_BenchSightPass(mobj_t **monsters, int nummonsters,
+                                mobj_t **targets, int numtargets,
+                                dbool *seen, dbool cached, int *mismatches)
+{
+  int64_t start = I_GetTimeUS();
+  int tic, i, j, k;
+
+  for (tic = 0; tic < BENCH_SIGHT_TICS; tic++)
+  {
+    P_ClearSightCache();
+    for (i = 0; i < nummonsters; i++)
+      for (j = 0; j < numtargets; j++)
+        for (k = 0; k < 2; k++)
+        {
+          dbool result;
+
+          if (!cached)
+            P_ClearSightCache();
+          result = P_CheckSight(monsters[i], targets[j]);
+          if (!cached && !tic && !k)
+            seen[i*numtargets + j] = result;
+          else if (result != seen[i*numtargets + j])
+            (*mismatches)++;
+        }
+  }
+  return I_GetTimeUS() - start;
+}
+
+void D_BenchSight(void)
+{
+  static dbool done = FALSE;
+  mobj_t *targets[MAXPLAYERS], **monsters = NULL;
+  int nummonsters = 0, maxmonsters = 0, numtargets = 0;
+  int i, visible = 0, mismatches = 0;
+  int64_t uncached, cached;
+  thinker_t *th;
+  dbool *seen;
+
+  if (done)
+    return;
+  done = TRUE;
+
+  for (i = 0; i < MAXPLAYERS; i++)
+    if (playeringame[i] && players[i].mo)
+      targets[numtargets++] = players[i].mo;
+
+  for (th = thinkercap.next; th != &thinkercap; th = th->next)
+    if (th->function == P_MobjThinker)
+    {
+      mobj_t *mo = (mobj_t *) th;
+
+      if (!(mo->flags & MF_COUNTKILL) || mo->health <= 0)
+        continue;
+      if (nummonsters == maxmonsters)
+      {
+        maxmonsters = maxmonsters ? maxmonsters * 2 : 256;
+        monsters = realloc(monsters, maxmonsters * sizeof(*monsters));
+      }
+      monsters[nummonsters++] = mo;
+    }
+
+  if (!nummonsters || !numtargets)
+  {
+    lprintf(LO_INFO, "D_BenchSight: no monsters or players on this level\n");
+    free(monsters);
+    return;
+  }
+
+  seen = malloc(nummonsters * numtargets * sizeof(*seen));
+  uncached = D_BenchSightPass(monsters, nummonsters, targets, numtargets,
+                              seen, FALSE, &mismatches);
+  P_PrintSightStats();
+  cached = D_BenchSightPass(monsters, nummonsters, targets, numtargets,
+                            seen, TRUE, &mismatches);
+  P_PrintSightStats();
+  P_ClearSightCache();
+
+  for (i = 0; i < nummonsters * numtargets; i++)
+    visible += seen[i];
+
+  lprintf(mismatches ? LO_WARN : LO_INFO,
+          "D_BenchSight: %d monsters, %d players, %d in sight: "
+          "%.3f ms/tic uncached, %.3f ms/tic cached, %d checks differ\n",
+          nummonsters, numtargets, visible,
+          uncached / 1000.0 / BENCH_SIGHT_TICS,
+          cached / 1000.0 / BENCH_SIGHT_TICS, mismatches);
+
+  free(seen);
+  free(monsters);
+}
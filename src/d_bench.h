@@ -0,0 +1,72 @@
+/* Emacs style mode select   -*- C++ -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *  Copyright (C) 1999 by
+ *  id Software, Chi Hoang, Lee Killough, Jim Flynn, Rand Phares, Ty Halderman
+ *  Copyright (C) 1999-2000 by
+ *  Jess Haas, Nicolas Kalkhof, Colin Phipps, Florian Schulze, Andrey Budko
+ *  Copyright 2005, 2006 by
+ *  Florian Schulze, Colin Phipps, Neil Stevens, Andrey Budko
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *      Timed demo playback and per-frame renderer timings
+ *
+ *---------------------------------------------------------------------
+ */
+
+#ifndef __D_BENCH__
+#define __D_BENCH__
+
+#include "doomtype.h"
+
+/* Parts of a frame timed during a timedemo */
+typedef enum
+{
+  BENCH_BSP,        /* R_RenderBSPNode, including the walls it draws */
+  BENCH_PLANES,     /* R_DrawPlanes */
+  BENCH_MASKED,     /* R_DrawMasked */
+  BENCH_STATUSBAR,  /* ST_Drawer */
+  BENCH_HUD,        /* HU_Drawer */
+  BENCH_FRAME,      /* the whole frame, game tic included */
+  NUMBENCHTIMERS
+} benchtimer_e;
+
+/* TRUE while a -timedemo demo is being played: one tic is run per
+ * frame, however fast the frames come, and every frame is timed */
+extern dbool timingdemo;
+
+void D_BenchStart(void);
+void D_BenchFinish(const char *demoname);
+
+/* -benchkernels: check the SIMD renderer loops against the C ones
+ * and time both */
+void D_BenchKernels(void);
+/* -benchkernels: time P_CheckSight with and without its cache on the
+ * first level loaded */
+void D_BenchSight(void);
+
+void D_BenchBegin(benchtimer_e timer);
+void D_BenchEnd(benchtimer_e timer);
+
+#define BENCH_BEGIN(timer) do { if (timingdemo) D_BenchBegin(timer); } while (0)
+#define BENCH_END(timer)   do { if (timingdemo) D_BenchEnd(timer); } while (0)
+
+#endif
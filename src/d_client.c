@@ -60,6 +60,7 @@
 #include "m_argv.h"
 #include "r_fps.h"
 #include "lprintf.h"
+#include "d_bench.h"
 
 ticcmd_t         netcmds[MAXPLAYERS][BACKUPTICS];
 static ticcmd_t* localcmds;
@@ -529,12 +530,36 @@ void D_BuildNewTiccmds(void)
   }
 }
 
+static void D_RunTic(void)
+{
+  if (!paused) {
+    if (advancedemo)
+      D_DoAdvanceDemo ();
+    G_Ticker ();
+  }
+  // a level load that has just started holds this tic, see G_Ticker
+  if (G_LevelLoading())
+    return;
+  if (menuactive)
+    M_Ticker ();
+  gametic++;
+}
+
 void TryRunTics(void)
 {
   fixed_t overflow = 0;
 
-  // Increment tic fraction
-  tic_vars.frac += tic_vars.frac_step;
+  // The game waits while a level is loaded incrementally, then runs the
+  // tic it was held on
+  if (G_LevelLoading()) {
+    G_ContinueLoadLevel();
+    if (!G_LevelLoading())
+      D_RunTic();
+    return;
+  }
+
+  // Increment tic fraction; timedemos run a whole tic every frame
+  tic_vars.frac += timingdemo ? FRACUNIT : tic_vars.frac_step;
   if(tic_vars.frac > FRACUNIT) {
     overflow = tic_vars.frac - FRACUNIT;
     tic_vars.frac = FRACUNIT;
@@ -544,14 +569,7 @@ void TryRunTics(void)
 
   if(tic_vars.frac == FRACUNIT) {
     tic_vars.frac = overflow;
-    if (!paused) {
-      if (advancedemo)
-        D_DoAdvanceDemo ();
-      G_Ticker ();
-    }
-    if (menuactive)
-      M_Ticker ();
-    gametic++;
+    D_RunTic();
   }
 }
 
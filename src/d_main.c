@@ -81,11 +81,13 @@
 #include "r_draw.h"
 #include "r_main.h"
 #include "r_fps.h"
+#include "r_cache.h"
 #include "d_main.h"
 #include "d_deh.h"  // Ty 04/08/98 - Externalizations
 #include "lprintf.h"  // jff 08/03/98 - declaration of lprintf
 #include "am_map.h"
 #include "u_mapinfo.h"
+#include "d_bench.h"
 
 void GetFirstMap(int *ep, int *map); // Ty 08/29/98 - add "-warp x" functionality
 static void D_PageDrawer(void);
@@ -198,7 +200,7 @@ extern int     showMessages;
 
 void D_Display (void)
 {
-  dbool wipe, viewactive, isborder = FALSE;
+  dbool wipe, viewactive, isborder = FALSE, screenkept;
   static dbool isborderstate        = FALSE;
   static dbool borderwillneedredraw = FALSE;
   static gamestate_t oldgamestate = -1;
@@ -213,8 +215,21 @@ void D_Display (void)
   if (!I_StartDisplay())
     return;
 
+  // Frames that are drawn in full can go straight to the frontend's
+  // framebuffer, unless the next tic may start a wipe from them: a game
+  // action, a demo change or a level load is pending, the menu is up
+  // and may start one, or this is the finale, which forces wipes from
+  // its ticker. If the previous frame went there, it's gone: everything
+  // is redrawn and, in the rare case a wipe follows anyway (a cheat),
+  // there's no wipe from it.
+  screenkept = I_SetFrameBuffer(gamestate == wipegamestate &&
+                                gamestate != GS_FINALE && !menuactive &&
+                                gameaction == ga_nothing && !advancedemo &&
+                                !G_LevelLoading() &&
+                                (gamestate != GS_LEVEL || gametic != basetic));
+
   // save the current screen if about to wipe
-  if ((wipe = gamestate != wipegamestate))
+  if ((wipe = gamestate != wipegamestate && screenkept))
     wipe_StartScreen();
 
   if (gamestate != GS_LEVEL) { // Not a level
@@ -253,7 +268,7 @@ void D_Display (void)
     viewactive = (!(automapmode & am_active) || (automapmode & am_overlay)) && !inhelpscreens;
     isborder = viewactive ? (viewheight != SCREENHEIGHT) : (!inhelpscreens && (automapmode & am_active));
 
-    if (oldgamestate != GS_LEVEL) {
+    if (oldgamestate != GS_LEVEL || !screenkept) {
       redrawborderstuff = isborder;
     } else {
       // CPhipps -
@@ -272,12 +287,16 @@ void D_Display (void)
       R_RenderPlayerView (&players[displayplayer]);
     if (automapmode & am_active)
       AM_Drawer();
+    BENCH_BEGIN(BENCH_STATUSBAR);
     ST_Drawer(
         ((viewheight != SCREENHEIGHT)
          || ((automapmode & am_active) && !(automapmode & am_overlay))),
         redrawborderstuff,
         (menuactive == mnact_full));
+    BENCH_END(BENCH_STATUSBAR);
+    BENCH_BEGIN(BENCH_HUD);
     HU_Drawer();
+    BENCH_END(BENCH_HUD);
   }
 
   isborderstate      = isborder;
@@ -500,6 +519,7 @@ void D_DoAdvanceDemo(void)
 void D_StartTitle (void)
 {
   gameaction = ga_nothing;
+  G_AbortLoadLevel();
   demosequence = -1;
   D_AdvanceDemo();
 }
@@ -1245,7 +1265,10 @@ bool D_DoomMainSetup(void)
       D_AddFile(myargv[p],source_pwad);
   }
 
-  p = M_CheckParm("-playdemo");
+  // -timedemo plays the demo like -playdemo, but as fast as
+  // possible and timing every frame (see d_bench.c)
+  timingdemo = !M_CheckParm("-playdemo") && M_CheckParm("-timedemo");
+  p = M_CheckParm(timingdemo ? "-timedemo" : "-playdemo");
   if (p && p < myargc-1)
   {
     char file[PATH_MAX+1];      // cph - localised
@@ -1396,6 +1419,7 @@ bool D_DoomMainSetup(void)
   //jff 9/3/98 use logical output routine
   lprintf(LO_INFO,"\nP_Init: Init Playloop state.\n");
   P_Init();
+  R_CloseStartupCache();
 
   //jff 9/3/98 use logical output routine
   lprintf(LO_INFO,"I_Init: Setting up machine state.\n");
@@ -1418,8 +1442,11 @@ bool D_DoomMainSetup(void)
 
   idmusnum = -1; //jff 3/17/98 insure idmus number is blank
 
+  if (M_CheckParm("-benchkernels"))
+    D_BenchKernels();
+
 
-  if ((p = M_CheckParm("-playdemo")) && ++p < myargc)
+  if ((p = M_CheckParm(timingdemo ? "-timedemo" : "-playdemo")) && ++p < myargc)
   {
 	singledemo = TRUE;
 	G_DeferedPlayDemo(myargv[p]);
@@ -1458,6 +1485,7 @@ extern void D_QuitNetGame (void);
 void D_DoomLoop(void)
 {
    //Doom loop
+   BENCH_BEGIN(BENCH_FRAME);
    WasRenderedInTryRunTics = FALSE;
 
    if (ffmap == gamemap) ffmap = 0;
@@ -1472,8 +1500,8 @@ void D_DoomLoop(void)
    {
       // Update display, next frame, with current state.
       D_Display();
-      return;
    }
+   BENCH_END(BENCH_FRAME);
 }
 
 //foward decl
@@ -1490,6 +1518,7 @@ void D_DoomDeinit(void)
 #endif
   M_SaveDefaults ();
   W_Exit();
+  V_FreePatchCache();
   //W_ReleaseAllWads();
   U_FreeMapInfo();
   I_ShutdownSound();
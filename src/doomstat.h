@@ -209,6 +209,11 @@ extern  dbool usergame;
 extern  dbool demoplayback;
 extern  int demover;
 
+// Demos and netgames must play out exactly as in the engines they come
+// from, so shortcuts that can change the game's course are off for them.
+// (This port doesn't record demos, so playback is the only demo case.)
+#define SYNC_SENSITIVE (demoplayback || netgame)
+
 extern  gamestate_t  gamestate;
 
 //-----------------------------
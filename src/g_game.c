@@ -82,6 +82,7 @@
 #include "i_system.h"
 #include "r_demo.h"
 #include "r_fps.h"
+#include "d_bench.h"
 
 #define SAVEGAMESIZE  0x20000
 #define SAVESTRINGSIZE  24
@@ -536,28 +537,19 @@ void G_RestartLevel(void)
 ==============
 */
 
-static void G_DoLoadLevel (void)
-{
-  int i;
-
-#if 0
-  lprintf(LO_INFO, "------------------------------\n"
-          "G_DoLoadLevel:  ===== Episode %d - Map %.2d =====\n",
-          gameepisode, gamemap);
-#endif
+//
+// G_SkyTexture
+// The sky texture of a map, from its UMAPINFO entry if it has one
+//
 
-  /* Set the sky map for the episode.
-   * First thing, we have a dummy sky texture name,
-   *  a flat. The data is in the WAD only because
-   *  we look for an actual index, instead of simply
-   *  setting one.
-   */
-  skyflatnum = R_FlatNumForName ( SKYFLATNAME );
+int G_SkyTexture(const mapentry_t *mapinfo, int episode, int map)
+{
+  int sky;
 
   /* skytexture set through UMAPINFO */
-  if (gamemapinfo && gamemapinfo->skytexture[0])
+  if (mapinfo && mapinfo->skytexture[0])
   {
-    skytexture = R_TextureNumForName(gamemapinfo->skytexture);
+    sky = R_TextureNumForName(mapinfo->skytexture);
   }
   /* DOOM determines the sky texture to be used
    * depending on the current episode, and the game version.
@@ -566,23 +558,60 @@ static void G_DoLoadLevel (void)
      // || gamemode == pack_tnt   //jff 3/27/98 sorry guys pack_tnt,pack_plut
      // || gamemode == pack_plut) //aren't gamemodes, this was matching retail
   {
-    skytexture = R_TextureNumForName ("SKY3");
-    if (gamemap < 12)
-      skytexture = R_TextureNumForName ("SKY1");
+    sky = R_TextureNumForName ("SKY3");
+    if (map < 12)
+      sky = R_TextureNumForName ("SKY1");
     else
-      if (gamemap < 21)
-        skytexture = R_TextureNumForName ("SKY2");
+      if (map < 21)
+        sky = R_TextureNumForName ("SKY2");
   }
   else /* and lets not forget about DOOM, Ultimate DOOM, SIGIL & extra Eps */
   {
     // Each episode has its own sky, numbered after it
     char skyname[9];
-    sprintf(skyname, "SKY%d", gameepisode);
-    skytexture = R_CheckTextureNumForName(skyname);
-    if (skytexture == -1)
+    sprintf(skyname, "SKY%d", episode);
+    sky = R_CheckTextureNumForName(skyname);
+    if (sky == -1)
       // default sky, in case of custom episodes with missing SKY
-      skytexture = R_TextureNumForName ("SKY1");
+      sky = R_TextureNumForName ("SKY1");
   }
+  return sky;
+}
+
+//
+// G_DoLoadLevel
+// The level can also be loaded incrementally, a few setup stages per
+// frame (see G_ContinueLoadLevel): the game then stays in its previous
+// state, still drawn, and holds the tic that started the load until the
+// level is in.
+//
+
+int incremental_load;
+
+// Time spent on the level setup per frame, while loading incrementally
+#define LOAD_BUDGET_US 8000
+
+static dbool levelloading;
+
+static void G_StartLoadLevel (void)
+{
+  int i;
+
+#if 0
+  lprintf(LO_INFO, "------------------------------\n"
+          "G_DoLoadLevel:  ===== Episode %d - Map %.2d =====\n",
+          gameepisode, gamemap);
+#endif
+
+  /* Set the sky map for the episode.
+   * First thing, we have a dummy sky texture name,
+   *  a flat. The data is in the WAD only because
+   *  we look for an actual index, instead of simply
+   *  setting one.
+   */
+  skyflatnum = R_FlatNumForName ( SKYFLATNAME );
+
+  skytexture = G_SkyTexture(gamemapinfo, gameepisode, gamemap);
 
   /* cph 2006/07/31 - took out unused levelstarttic variable */
 
@@ -592,8 +621,6 @@ static void G_DoLoadLevel (void)
   if (wipegamestate == GS_LEVEL && (gameaction == ga_newgame || gameaction == ga_completed))
      wipegamestate = -1;             // force a wipe
 
-  gamestate = GS_LEVEL;
-
   for (i=0 ; i<MAXPLAYERS ; i++)
   {
     if (playeringame[i] && players[i].playerstate == PST_DEAD)
@@ -608,15 +635,22 @@ static void G_DoLoadLevel (void)
 
   {
     DECLARE_BLOCK_MEMORY_ALLOC_ZONE(secnodezone);
+    Z_BDumpStats(&secnodezone);
     NULL_BLOCK_MEMORY_ALLOC_ZONE(secnodezone);
     //extern msecnode_t *headsecnode; // phares 3/25/98
     //headsecnode = NULL;
   }
 
-  P_SetupLevel (gameepisode, gamemap, 0, gameskill);
+  P_StartSetupLevel (gameepisode, gamemap, 0, gameskill);
+}
+
+static void G_FinishLoadLevel (void)
+{
+  levelloading = FALSE;
+  gamestate = GS_LEVEL;
+
   if (!demoplayback) /* Don't switch views if playing a demo */
     displayplayer = consoleplayer;    /* view the guy you are playing */
-  gameaction = ga_nothing;
 
   Z_CheckHeap ();
 
@@ -630,6 +664,36 @@ static void G_DoLoadLevel (void)
   // killough 5/13/98: in case netdemo has consoleplayer other than green
   ST_Start();
   HU_Start();
+
+  if (M_CheckParm("-benchkernels"))
+    D_BenchSight();
+}
+
+static void G_DoLoadLevel (void)
+{
+  G_StartLoadLevel ();
+  P_ContinueSetupLevel (-1);
+  G_FinishLoadLevel ();
+  gameaction = ga_nothing;
+}
+
+dbool G_LevelLoading (void)
+{
+  return levelloading;
+}
+
+void G_ContinueLoadLevel (void)
+{
+  if (levelloading && P_ContinueSetupLevel (LOAD_BUDGET_US))
+    G_FinishLoadLevel ();
+}
+
+// Drops an incremental load when the game moves on to something else;
+// whatever comes next sets up its own level, and until then the game
+// stays in the state the load started from
+void G_AbortLoadLevel (void)
+{
+  levelloading = FALSE;
 }
 
 
@@ -758,6 +822,8 @@ void G_Ticker (void)
 #endif
     G_ChangedPlayerColour(consoleplayer, mapcolor_me);
   }
+  Z_NextTic();
+
   P_MapStart();
   // do player reborns if needed
   for (i=0 ; i<MAXPLAYERS ; i++)
@@ -802,6 +868,11 @@ void G_Ticker (void)
         }
     }
 
+  // the level is still loading: TryRunTics runs this tic again once
+  // it's in
+  if (levelloading)
+    return;
+
   if (paused & 2 || (!demoplayback && menuactive && !netgame))
     basetic++;  // For revenant tracers and RNG -- we must maintain sync
   else {
@@ -1494,11 +1565,18 @@ void G_WorldDone (void)
 void G_DoWorldDone (void)
 {
   idmusnum = -1;             //jff 3/17/98 allow new level's music to be loaded
-  gamestate = GS_LEVEL;
   gameepisode = wminfo.nextep + 1;
   gamemap = wminfo.next + 1;
   gamemapinfo = G_LookupMapinfo(gameepisode, gamemap);
-  G_DoLoadLevel();
+  if (incremental_load && !netgame)
+  {
+    // the intermission stays up while the level loads
+    G_StartLoadLevel();
+    levelloading = TRUE;
+    G_ContinueLoadLevel();
+  }
+  else
+    G_DoLoadLevel();
   gameaction = ga_nothing;
   AM_clearMarks();           //jff 4/12/98 clear any marks on the automap
 }
@@ -1583,6 +1661,7 @@ void G_LoadGame(int slot, dbool   command)
   } else {
     // Do the old thing, immediate load
     gameaction = ga_loadgame;
+    G_AbortLoadLevel();
     forced_loadgame = FALSE;
     savegameslot = slot;
     demoplayback = FALSE;
@@ -2026,6 +2105,7 @@ void G_DeferedInitNew(skill_t skill, int episode, int map)
   d_episode = episode;
   d_map = map;
   gameaction = ga_newgame;
+  G_AbortLoadLevel();
 }
 
 /* cph -
@@ -2595,6 +2675,7 @@ void G_DeferedPlayDemo (const char* name)
 {
   defdemoname = name;
   gameaction = ga_playdemo;
+  G_AbortLoadLevel();
 }
 
 static int demolumpnum = -1;
@@ -2883,6 +2964,9 @@ void G_DoPlayDemo(void)
 
   demoplayback = TRUE;
   R_SmoothPlaying_Reset(NULL); // e6y
+
+  if (timingdemo)
+    D_BenchStart();
 }
 
 /* G_CheckDemoStatus
@@ -2892,6 +2976,14 @@ void G_DoPlayDemo(void)
  */
 dbool   G_CheckDemoStatus (void)
 {
+  if (timingdemo && demoplayback)
+  {
+    // Report the timings and close down once the demo is over
+    D_BenchFinish(defdemoname);
+    timingdemo = FALSE;
+    quit_pressed = TRUE;
+  }
+
   if (demoplayback)
   {
     if (demolumpnum != -1) {
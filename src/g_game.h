@@ -35,6 +35,7 @@
 #include "doomdef.h"
 #include "d_event.h"
 #include "d_ticcmd.h"
+#include "u_mapinfo.h"
 
 //
 // GAME
@@ -51,6 +52,7 @@ dbool   G_CheckDemoStatus(void);
 void G_DeathMatchSpawnPlayer(int playernum);
 void G_InitNew(skill_t skill, int episode, int map);
 void G_DeferedInitNew(skill_t skill, int episode, int map);
+int G_SkyTexture(const mapentry_t *mapinfo, int episode, int map);
 void G_DeferedPlayDemo(const char *demo); // CPhipps - const
 void G_LoadGame(int slot, dbool   is_command); // killough 5/15/98
 void G_ForcedLoadGame(void);           // killough 5/15/98: forced loadgames
@@ -73,6 +75,9 @@ void G_DoPlayDemo(void);
 void G_DoCompleted(void);
 void G_ReadDemoTiccmd(ticcmd_t *cmd);
 void G_DoWorldDone(void);
+dbool G_LevelLoading(void);      // a level is being loaded incrementally
+void G_ContinueLoadLevel(void);  // called every frame while it is
+void G_AbortLoadLevel(void);     // drops it
 void G_Compatibility(void);
 const uint8_t *G_ReadOptions(const uint8_t *demo_p);   /* killough 3/1/98 - cph: const uint8_t* */
 uint8_t *G_WriteOptions(uint8_t *demo_p);        // killough 3/1/98
@@ -178,6 +183,7 @@ extern int  defaultskill;      //jff 3/24/98 default skill
 extern dbool   haswolflevels;  //jff 4/18/98 wolf levels present
 
 extern int  bodyquesize;       // killough 2/8/98: adustable corpse limit
+extern int  incremental_load;  // load levels across frames (core option)
 
 // killough 5/2/98: moved from d_deh.c:
 // Par times (new item with BOOM) - from g_game.c
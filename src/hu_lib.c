@@ -144,24 +144,62 @@ static dbool   HUlib_delCharFromTextLine(hu_textline_t* t)
 }
 
 //
-// HUlib_drawTextLine()
-//
-// Draws a hu_textline_t widget
-//
-// Passed the hu_textline_t and flag whether to draw a cursor
-// Returns nothing
-//
-void HUlib_drawTextLine
-( hu_textline_t* l,
-  dbool   drawcursor )
+// Text line cache
+//
+// A line that is drawn with the same text, font, colour and position,
+// at the same scale and with the same patch filtering as in the previous
+// frame is captured once: drawn into the spare screen BG
+// over two different backgrounds, and every pixel that comes out the
+// same both times is kept, already scaled, as a run of opaque pixels.
+// From then on the line is put on FG by copying those runs, until its
+// text changes or V_CacheStamp does.
+//
+
+typedef struct {
+  int dest;           // offset of the run's first pixel in FG
+  int src;            // offset in hu_linecache_t.pixels
+  int len;
+} hu_run_t;
+
+typedef struct hu_linecache_s {
+  // what was drawn last
+  char     *text;
+  int      textsize;
+  int      len, x, y, cm;
+  const patchnum_t *f;
+  int      sc;
+  dbool    cursor;
+  int      width, height;       // SCREENWIDTH and SCREENHEIGHT
+  enum draw_filter_type_e filter;
+  enum sloped_edge_type_e edges;
+  unsigned stamp;
+
+  // captured pixels, if numruns >= 0
+  uint16_t *pixels;
+  int      pixelsize;
+  hu_run_t *runs;
+  int      numruns, maxruns;
+} hu_linecache_t;
+
+//
+// HUlib_renderTextLine()
+//
+// Draws the line to screen scrn, or if scrn is -1 only works out the
+// area (in 320x200 coordinates) it would cover
+//
+static void HUlib_renderTextLine(hu_textline_t* l, dbool drawcursor, int scrn,
+                                 int *x1, int *y1, int *x2, int *y2)
 {
-
   int     i;
   int     w;
   int     x;
   unsigned char c;
   int oc = l->cm; //jff 2/17/98 remember default color
   int y = l->y;           // killough 1/18/98 -- support multiple lines
+  const patchnum_t *p;
+
+  *x1 = *y1 = INT_MAX;
+  *x2 = *y2 = INT_MIN;
 
   // draw the new stuff
   x = l->x;
@@ -181,12 +219,18 @@ void HUlib_drawTextLine
     }
     else  if (c != ' ' && c >= l->sc && c <= 127)
     {
-      w = l->f[c - l->sc].width;
+      p = &l->f[c - l->sc];
+      w = p->width;
       if (x+w > BASE_WIDTH)
         break;
       // killough 1/18/98 -- support multiple lines:
       // CPhipps - patch drawing updated
-      V_DrawNumPatch(x, y, FG, l->f[c - l->sc].lumpnum, l->cm, VPT_TRANS | VPT_STRETCH);
+      if (scrn >= 0)
+        V_DrawNumPatch(x, y, scrn, p->lumpnum, l->cm, VPT_TRANS | VPT_STRETCH);
+      *x1 = MIN(*x1, x - p->leftoffset);
+      *y1 = MIN(*y1, y - p->topoffset);
+      *x2 = MAX(*x2, x - p->leftoffset + w);
+      *y2 = MAX(*y2, y - p->topoffset + p->height);
       x += w;
     }
     else
@@ -199,12 +243,157 @@ void HUlib_drawTextLine
   l->cm = oc; //jff 2/17/98 restore original color
 
   // draw the cursor if requested
-  if (drawcursor && x + l->f['_' - l->sc].width <= BASE_WIDTH)
+  p = &l->f['_' - l->sc];
+  if (drawcursor && x + p->width <= BASE_WIDTH)
   {
     // killough 1/18/98 -- support multiple lines
     // CPhipps - patch drawing updated
-    V_DrawNumPatch(x, y, FG, l->f['_' - l->sc].lumpnum, CR_DEFAULT, VPT_NONE | VPT_STRETCH);
+    if (scrn >= 0)
+      V_DrawNumPatch(x, y, scrn, p->lumpnum, CR_DEFAULT, VPT_NONE | VPT_STRETCH);
+    *x1 = MIN(*x1, x - p->leftoffset);
+    *y1 = MIN(*y1, y - p->topoffset);
+    *x2 = MAX(*x2, x - p->leftoffset + p->width);
+    *y2 = MAX(*y2, y - p->topoffset + p->height);
+  }
+}
+
+//
+// HUlib_captureTextLine()
+//
+// Fills in the cached runs of opaque pixels of a line
+//
+static void HUlib_captureTextLine(hu_textline_t* l, dbool drawcursor)
+{
+  hu_linecache_t *c = l->cache;
+  int x1, y1, x2, y2, x, y, w, h;
+  uint16_t *scratch;
+
+  c->numruns = 0;
+
+  HUlib_renderTextLine(l, drawcursor, -1, &x1, &y1, &x2, &y2);
+  x1 = MAX(x1, 0);
+  y1 = MAX(y1, 0);
+  x2 = MIN(x2, 320);
+  y2 = MIN(y2, 200);
+  if (x1 >= x2 || y1 >= y2)
+    return; // nothing on screen
+  x1 = x1 * SCREENWIDTH / 320;
+  y1 = y1 * SCREENHEIGHT / 200;
+  x2 = x2 * SCREENWIDTH / 320;
+  y2 = y2 * SCREENHEIGHT / 200;
+  w = x2 - x1;
+  h = y2 - y1;
+
+  if (c->pixelsize < w * h)
+  {
+    c->pixelsize = w * h;
+    c->pixels = realloc(c->pixels, c->pixelsize * sizeof(*c->pixels));
+  }
+
+  // Once over black, kept in pixels...
+  scratch = (uint16_t *)screens[BG].data + y1 * SURFACE_SHORT_PITCH + x1;
+  for (y = 0; y < h; y++)
+    memset(scratch + y * SURFACE_SHORT_PITCH, 0, w * sizeof(*scratch));
+  HUlib_renderTextLine(l, drawcursor, BG, &x, &y, &x, &y);
+  for (y = 0; y < h; y++)
+    memcpy(c->pixels + y * w, scratch + y * SURFACE_SHORT_PITCH, w * sizeof(*scratch));
+
+  // ...and once over white, for the pixels that don't change
+  for (y = 0; y < h; y++)
+    memset(scratch + y * SURFACE_SHORT_PITCH, 0xff, w * sizeof(*scratch));
+  HUlib_renderTextLine(l, drawcursor, BG, &x, &y, &x, &y);
+
+  for (y = 0; y < h; y++)
+  {
+    const uint16_t *a = c->pixels + y * w;
+    const uint16_t *b = scratch + y * SURFACE_SHORT_PITCH;
+
+    for (x = 0; x < w; )
+    {
+      int start;
+
+      if (a[x] != b[x])
+      {
+        x++;
+        continue;
+      }
+      for (start = x; x < w && a[x] == b[x]; x++)
+        ;
+      if (c->numruns == c->maxruns)
+      {
+        c->maxruns = c->maxruns ? c->maxruns * 2 : 64;
+        c->runs = realloc(c->runs, c->maxruns * sizeof(*c->runs));
+      }
+      c->runs[c->numruns].dest = (y1 + y) * SURFACE_SHORT_PITCH + x1 + start;
+      c->runs[c->numruns].src = y * w + start;
+      c->runs[c->numruns].len = x - start;
+      c->numruns++;
+    }
+  }
+}
+
+//
+// HUlib_drawTextLine()
+//
+// Draws a hu_textline_t widget
+//
+// Passed the hu_textline_t and flag whether to draw a cursor
+// Returns nothing
+//
+void HUlib_drawTextLine
+( hu_textline_t* l,
+  dbool   drawcursor )
+{
+  hu_linecache_t *c = l->cache;
+  int x1, y1, x2, y2;
+
+  if (!c)
+  {
+    c = l->cache = calloc(1, sizeof(*c));
+    c->len = -1;
+  }
+
+  if (c->len == l->len && c->x == l->x && c->y == l->y && c->cm == l->cm &&
+      c->f == l->f && c->sc == l->sc && c->cursor == drawcursor &&
+      c->width == SCREENWIDTH && c->height == SCREENHEIGHT &&
+      c->filter == drawvars.filterpatch && c->edges == drawvars.patch_edges &&
+      c->stamp == V_CacheStamp &&
+      (!l->len || !memcmp(c->text, l->l, l->len)))
+  {
+    // Same as last frame; capture it if that's not been done yet
+    uint16_t *dest = (uint16_t *)screens[FG].data;
+    int i;
+
+    if (c->numruns < 0)
+      HUlib_captureTextLine(l, drawcursor);
+    for (i = 0; i < c->numruns; i++)
+      memcpy(dest + c->runs[i].dest, c->pixels + c->runs[i].src,
+             c->runs[i].len * sizeof(*dest));
+    return;
+  }
+
+  // Changed, draw it and remember what was drawn
+  HUlib_renderTextLine(l, drawcursor, FG, &x1, &y1, &x2, &y2);
+
+  if (c->textsize < l->len)
+  {
+    c->textsize = l->len;
+    c->text = realloc(c->text, c->textsize);
   }
+  memcpy(c->text, l->l, l->len);
+  c->len = l->len;
+  c->x = l->x;
+  c->y = l->y;
+  c->cm = l->cm;
+  c->f = l->f;
+  c->sc = l->sc;
+  c->cursor = drawcursor;
+  c->width = SCREENWIDTH;
+  c->height = SCREENHEIGHT;
+  c->filter = drawvars.filterpatch;
+  c->edges = drawvars.patch_edges;
+  c->stamp = V_CacheStamp;
+  c->numruns = -1;
 }
 
 //
@@ -81,6 +81,9 @@ typedef struct
   // whether this line needs to be udpated
   int   needsupdate;
 
+  // the line's pixels as last drawn, see HUlib_drawTextLine
+  struct hu_linecache_s *cache;
+
 } hu_textline_t;
 
 
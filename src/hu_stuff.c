@@ -52,6 +52,7 @@ hud_mode_t hud_mode;
 dbool   hud_showstats;   /* show secrets/items/kills stats */
 dbool   hud_showkeys;    /* show keys HUD line */
 dbool   hud_showweapons; /* show weapons HUD line */
+dbool   hud_showmemory;  /* show zone memory statistics */
 
 //
 // Locally used constants, shortcuts.
@@ -126,6 +127,10 @@ dbool   hud_showweapons; /* show weapons HUD line */
 #define HU_INPUTWIDTH 64
 #define HU_INPUTHEIGHT  1
 
+// memory statistics overlay, under the message line
+#define HU_MEMX 0
+#define HU_MEMY (HU_INPUTY + HU_GAPY)
+
 #define key_alt KEYD_RALT
 #define key_shift KEYD_RSHIFT
 
@@ -182,6 +187,7 @@ static hu_textline_t  w_weapon; //jff 2/16/98 new weapon widget for hud
 static hu_textline_t  w_keys;   //jff 2/16/98 new keys widget for hud
 static hu_textline_t  w_gkeys;  //jff 3/7/98 graphic keys widget for hud
 static hu_textline_t  w_monsec; //jff 2/16/98 new kill/secret widget for hud
+static hu_textline_t  w_memory; // zone accounting, one line per tag
 static hu_mtext_t     w_rtext;  //jff 2/26/98 text message refresh widget
 
 static dbool    always_off = FALSE;
@@ -576,6 +582,17 @@ void HU_Start(void)
     hudcolor_xyco
   );
 
+  // create the zone memory statistics widget
+  HUlib_initTextLine
+  (
+    &w_memory,
+    HU_MEMX,
+    HU_MEMY,
+    hu_font,
+    HU_FONTSTART,
+    hudcolor_xyco
+  );
+
   // initialize the automaps coordinate widget
   //jff 3/3/98 split coordstr widget into 3 parts
   if (map_point_coordinates)
@@ -711,6 +728,41 @@ void HU_MoveHud(void)
 //
 // Passed nothing, returns nothing
 //
+//
+// HU_DrawMemory()
+//
+// Draws the zone accounting of each tag: live and peak kilobytes, live
+// blocks and allocations in the last tic
+//
+static void HU_DrawMemory(void)
+{
+  char line[80];
+  const char *s;
+  size_t live = 0;
+  int tag;
+
+  HUlib_clearTextLine(&w_memory);
+  for (tag = PU_FREE; tag < PU_MAX; tag++)
+  {
+    if (tag == PU_FREE)
+      strcpy(line, "ZONE\tLIVE\tPEAK\tBLOCKS NEW\n");
+    else
+    {
+      sprintf(line, "%s\t%luK\t%luK\t%u %u\n", Z_TagName(tag),
+              (unsigned long) zonestats[tag].live >> 10,
+              (unsigned long) zonestats[tag].peak >> 10,
+              zonestats[tag].blocks, zonestats[tag].lasttic);
+      live += zonestats[tag].live;
+    }
+    for (s = line; *s; s++)
+      HUlib_addCharToTextLine(&w_memory, *s);
+  }
+  sprintf(line, "TOTAL\t%luK", (unsigned long) live >> 10);
+  for (s = line; *s; s++)
+    HUlib_addCharToTextLine(&w_memory, *s);
+  HUlib_drawTextLine(&w_memory, FALSE);
+}
+
 void HU_Drawer(void)
 {
   char *s;
@@ -1269,6 +1321,10 @@ void HU_Drawer(void)
 
   // display the interactive buffer for chat entry
   HUlib_drawIText(&w_chat);
+
+  // display the zone memory statistics if optioned
+  if (hud_showmemory)
+    HU_DrawMemory();
 }
 
 //
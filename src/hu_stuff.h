@@ -91,5 +91,6 @@ extern int hud_msg_lines;   /* number of message lines in window up to 16      *
 extern dbool   hud_showstats;   /* show secrets/items/kills stats */
 extern dbool   hud_showkeys;    /* show keys HUD line */
 extern dbool   hud_showweapons; /* show weapons HUD line */
+extern dbool   hud_showmemory;  /* show zone memory statistics */
 
 #endif
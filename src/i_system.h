@@ -45,6 +45,8 @@ void I_GetTime_SaveMS(void);
 
 unsigned long I_GetRandomTimeSeed(void); /* cphipps */
 
+int64_t I_GetTimeUS(void); /* microseconds, for timing demos */
+
 void I_uSleep(unsigned long usecs);
 
 /* cphipps - I_SigString
@@ -47,6 +47,11 @@ void I_ShutdownGraphics(void);
 /* Takes full 8 bit values. */
 void I_SetPalette(int pal); /* CPhipps - pass down palette number */
 
+/* Points screens[0] at the memory the coming frame is drawn into, which
+ * can be the frontend's if allowfrontend is set. Returns false if that
+ * doesn't hold the previous frame. */
+dbool I_SetFrameBuffer(dbool allowfrontend);
+
 void I_FinishUpdate (void);
 
 /* I_StartTic
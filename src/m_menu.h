@@ -84,6 +84,7 @@ extern int warning_about_changes, print_warning_about_changes;
 
 extern dbool   menu_background;
 extern dbool   r_wiggle_fix;
+extern dbool   quit_pressed;
 
 /****************************
  *
@@ -371,8 +371,7 @@ int EV_DoDoor
 
     // new door thinker
     rtn = 1;
-    door = Z_Malloc (sizeof(*door), PU_LEVSPEC, 0);
-    memset(door, 0, sizeof(*door));
+    door = P_NewThinker(tp_door);
     P_AddThinker (&door->thinker);
     sec->ceilingdata = door; //jff 2/22/98
 
@@ -587,8 +586,7 @@ int EV_VerticalDoor
   }
 
   // new door thinker
-  door = Z_Malloc (sizeof(*door), PU_LEVSPEC, 0);
-  memset(door, 0, sizeof(*door));
+  door = P_NewThinker(tp_door);
   P_AddThinker (&door->thinker);
   sec->ceilingdata = door; //jff 2/22/98
   door->thinker.function = T_VerticalDoor;
@@ -659,9 +657,7 @@ void P_SpawnDoorCloseIn30 (sector_t* sec)
 {
   vldoor_t* door;
 
-  door = Z_Malloc ( sizeof(*door), PU_LEVSPEC, 0);
-
-  memset(door, 0, sizeof(*door));
+  door = P_NewThinker(tp_door);
   P_AddThinker (&door->thinker);
 
   sec->ceilingdata = door; //jff 2/22/98
@@ -691,9 +687,7 @@ void P_SpawnDoorRaiseIn5Mins
 {
   vldoor_t* door;
 
-  door = Z_Malloc ( sizeof(*door), PU_LEVSPEC, 0);
-
-  memset(door, 0, sizeof(*door));
+  door = P_NewThinker(tp_door);
   P_AddThinker (&door->thinker);
 
   sec->ceilingdata = door; //jff 2/22/98
@@ -80,44 +80,82 @@ extern void retro_set_rumble_damage(int damage, float duration);
 
 //
 // Called by P_NoiseAlert.
-// Recursively traverse adjacent sectors,
+// Floods adjacent sectors,
 // sound blocking lines cut off traversal.
 //
 // killough 5/5/98: reformatted, cleaned up
+// Now a flood over the sector edges of P_GroupLines with a stack of its
+// own. Every sector ends up with the lowest soundtraversed of any path
+// to it, whatever the order, so the result is that of the old
+// recursion.
 
-static void P_RecursiveSound(sector_t *sec, int soundblocks,
+typedef struct {
+  sector_t *sec;
+  int soundblocks;
+} soundstep_t;
+
+static soundstep_t *soundstack;
+static int soundstacksize;
+
+static void P_FloodSound(sector_t *sec, int soundblocks,
            mobj_t *soundtarget)
 {
-  int i;
-
-  // wake up all monsters in this sector
-  if (sec->validcount == validcount && sec->soundtraversed <= soundblocks+1)
-    return;             // already flooded
+  int sp = 0;
 
-  sec->validcount = validcount;
-  sec->soundtraversed = soundblocks+1;
-  P_SetTarget(&sec->soundtarget, soundtarget);
+  soundstack = soundstacksize ? soundstack :
+    malloc((soundstacksize = 64) * sizeof(*soundstack));
+  soundstack[sp].sec = sec;
+  soundstack[sp++].soundblocks = soundblocks;
 
-  for (i=0; i<sec->linecount; i++)
+  while (sp)
     {
-      sector_t *other;
-      line_t *check = sec->lines[i];
+      const sectoredge_t *edge;
+      int i;
 
-      if (!(check->flags & ML_TWOSIDED))
-        continue;
+      sec = soundstack[--sp].sec;
+      soundblocks = soundstack[sp].soundblocks;
 
-      P_LineOpening(check);
+      // wake up all monsters in this sector
+      if (sec->validcount == validcount && sec->soundtraversed <= soundblocks+1)
+        continue;             // already flooded
 
-      if (openrange <= 0)
-        continue;       // closed door
+      sec->validcount = validcount;
+      sec->soundtraversed = soundblocks+1;
+      P_SetTarget(&sec->soundtarget, soundtarget);
 
-      other=sides[check->sidenum[sides[check->sidenum[0]].sector==sec]].sector;
+      for (i=0, edge=sec->edges; i<sec->edgecount; i++, edge++)
+        {
+          const line_t *check = edge->line;
+          const sector_t *front = check->frontsector, *back = check->backsector;
+          int blocks = soundblocks;
 
-      if (!(check->flags & ML_SOUNDBLOCK))
-        P_RecursiveSound(other, soundblocks, soundtarget);
-      else
-        if (!soundblocks)
-          P_RecursiveSound(other, 1, soundtarget);
+          if (!(check->flags & ML_TWOSIDED))
+            continue;
+
+          // P_LineOpening's openrange, without its side effects
+          if ((front->ceilingheight < back->ceilingheight ?
+               front->ceilingheight : back->ceilingheight) -
+              (front->floorheight > back->floorheight ?
+               front->floorheight : back->floorheight) <= 0)
+            continue;       // closed door
+
+          if (check->flags & ML_SOUNDBLOCK)
+            {
+              if (soundblocks)
+                continue;
+              blocks = 1;
+            }
+
+          if (edge->other->validcount == validcount &&
+              edge->other->soundtraversed <= blocks+1)
+            continue;
+
+          if (sp == soundstacksize)
+            soundstack = realloc(soundstack,
+                                 (soundstacksize *= 2) * sizeof(*soundstack));
+          soundstack[sp].sec = edge->other;
+          soundstack[sp++].soundblocks = blocks;
+        }
     }
 }
 
@@ -129,7 +167,7 @@ static void P_RecursiveSound(sector_t *sec, int soundblocks,
 void P_NoiseAlert(mobj_t *target, mobj_t *emitter)
 {
   validcount++;
-  P_RecursiveSound(emitter->subsector->sector, 0, target);
+  P_FloodSound(emitter->subsector->sector, 0, target);
 }
 
 //
@@ -343,6 +381,7 @@ static dbool   P_Move(mobj_t *actor, dbool   dropoff) /* killough 9/12/98 */
     {
       actor->x = origx;
       actor->y = origy;
+      P_UpdateBlockThing(actor);
       movefactor *= FRACUNIT / ORIG_FRICTION_FACTOR / 4;
       actor->momx += FixedMul(deltax, movefactor);
       actor->momy += FixedMul(deltay, movefactor);
@@ -1268,6 +1307,7 @@ void A_SPosAttack(mobj_t* actor)
   A_FaceTarget(actor);
   bangle = actor->angle;
   slope = P_AimLineAttack(actor, bangle, MISSILERANGE, 0); /* killough 8/2/98 */
+  P_StartPathBatch(actor->x, actor->y, MISSILERANGE);
   for (i=0; i<3; i++)
     {  // killough 5/5/98: remove dependence on order of evaluation:
       int t = P_Random(pr_sposattack);
@@ -1275,6 +1315,7 @@ void A_SPosAttack(mobj_t* actor)
       int damage = ((P_Random(pr_sposattack)%5)+1)*3;
       P_LineAttack(actor, angle, MISSILERANGE, slope, damage);
     }
+  P_EndPathBatch();
 }
 
 void A_CPosAttack(mobj_t *actor)
@@ -1431,6 +1472,7 @@ void A_SkelMissile(mobj_t *actor)
 
   mo->x += mo->momx;
   mo->y += mo->momy;
+  P_UpdateBlockThing(mo);
   P_SetTarget(&mo->tracer, actor->target);
 }
 
@@ -1662,6 +1704,7 @@ void A_VileChase(mobj_t* actor)
                     {
                       corpsehit->height = info->height; // fix Ghost bug
                       corpsehit->radius = info->radius; // fix Ghost bug
+                      P_UpdateBlockThing(corpsehit);
                     }                                               // phares
 
       /* killough 7/18/98:
@@ -1798,6 +1841,7 @@ void A_VileAttack(mobj_t *actor)
   // move the fire between the vile and the player
   fire->x = actor->target->x - FixedMul (STEPSIZE, finecosine[an]);
   fire->y = actor->target->y - FixedMul (STEPSIZE, finesine[an]);
+  P_UpdateBlockThing(fire);
   P_RadiusAttack(fire, actor, 70);
 }
 
@@ -437,8 +437,7 @@ int EV_DoFloor
 
       // new floor thinker
       rtn = 1;
-      floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
-      memset(floor, 0, sizeof(*floor));
+      floor = P_NewThinker(tp_floor);
       P_AddThinker (&floor->thinker);
       sec->floordata = floor; //jff 2/22/98
       floor->thinker.function = T_MoveFloor;
@@ -742,8 +741,7 @@ int EV_BuildStairs
 
     // create new floor thinker for first step
     rtn = 1;
-    floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
-    memset(floor, 0, sizeof(*floor));
+    floor = P_NewThinker(tp_floor);
     P_AddThinker (&floor->thinker);
     sec->floordata = floor;
     floor->thinker.function = T_MoveFloor;
@@ -823,8 +821,7 @@ int EV_BuildStairs
         secnum = newsecnum;
 
         // create and initialize a thinker for the next step
-        floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
-        memset(floor, 0, sizeof(*floor));
+        floor = P_NewThinker(tp_floor);
         P_AddThinker (&floor->thinker);
 
         sec->floordata = floor; //jff 2/22/98
@@ -924,8 +921,7 @@ int EV_DoDonut(line_t*  line)
       s3 = s2->lines[i]->backsector;      // s3 is model sector for changes
 
       //  Spawn rising slime
-      floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
-      memset(floor, 0, sizeof(*floor));
+      floor = P_NewThinker(tp_floor);
       P_AddThinker (&floor->thinker);
       s2->floordata = floor; //jff 2/22/98
       floor->thinker.function = T_MoveFloor;
@@ -939,8 +935,7 @@ int EV_DoDonut(line_t*  line)
       floor->floordestheight = s3->floorheight;
 
       //  Spawn lowering donut-hole pillar
-      floor = Z_Malloc (sizeof(*floor), PU_LEVSPEC, 0);
-      memset(floor, 0, sizeof(*floor));
+      floor = P_NewThinker(tp_floor);
       P_AddThinker (&floor->thinker);
       s1->floordata = floor; //jff 2/22/98
       floor->thinker.function = T_MoveFloor;
@@ -987,8 +982,7 @@ int EV_DoElevator
 
     // create and initialize new elevator thinker
     rtn = 1;
-    elevator = Z_Malloc (sizeof(*elevator), PU_LEVSPEC, 0);
-    memset(elevator, 0, sizeof(*elevator));
+    elevator = P_NewThinker(tp_elevator);
     P_AddThinker (&elevator->thinker);
     sec->floordata = elevator; //jff 2/22/98
     sec->ceilingdata = elevator; //jff 2/22/98
@@ -182,9 +182,7 @@ void P_SpawnFireFlicker (sector_t*  sector)
   // Nothing special about it during gameplay.
   sector->special &= ~31; //jff 3/14/98 clear non-generalized sector type
 
-  flick = Z_Malloc ( sizeof(*flick), PU_LEVSPEC, 0);
-
-  memset(flick, 0, sizeof(*flick));
+  flick = P_NewThinker(tp_fireflicker);
   P_AddThinker (&flick->thinker);
 
   flick->thinker.function = T_FireFlicker;
@@ -209,9 +207,7 @@ void P_SpawnLightFlash (sector_t* sector)
   // nothing special about it during gameplay
   sector->special &= ~31; //jff 3/14/98 clear non-generalized sector type
 
-  flash = Z_Malloc ( sizeof(*flash), PU_LEVSPEC, 0);
-
-  memset(flash, 0, sizeof(*flash));
+  flash = P_NewThinker(tp_lightflash);
   P_AddThinker (&flash->thinker);
 
   flash->thinker.function = T_LightFlash;
@@ -241,9 +237,7 @@ void P_SpawnStrobeFlash
 {
   strobe_t* flash;
 
-  flash = Z_Malloc ( sizeof(*flash), PU_LEVSPEC, 0);
-
-  memset(flash, 0, sizeof(*flash));
+  flash = P_NewThinker(tp_strobe);
   P_AddThinker (&flash->thinker);
 
   flash->sector = sector;
@@ -277,9 +271,7 @@ void P_SpawnGlowingLight(sector_t*  sector)
 {
   glow_t* g;
 
-  g = Z_Malloc( sizeof(*g), PU_LEVSPEC, 0);
-
-  memset(g, 0, sizeof(*g));
+  g = P_NewThinker(tp_glow);
   P_AddThinker(&g->thinker);
 
   g->sector = sector;
@@ -475,6 +475,14 @@ dbool PIT_CheckLine (line_t* ld)
 // PIT_CheckThing
 //
 
+// The blockdist test of PIT_CheckThing, on a mapblock's copy of thing
+static dbool PIT_CheckThingReach(const blockthing_t *bt)
+{
+  fixed_t blockdist = bt->radius + tmthing->radius;
+
+  return D_abs(bt->x - tmx) < blockdist && D_abs(bt->y - tmy) < blockdist;
+}
+
 static dbool PIT_CheckThing(mobj_t *thing) // killough 3/26/98: make static
 {
   fixed_t blockdist;
@@ -753,7 +761,7 @@ dbool P_CheckPosition (mobj_t* thing,fixed_t x,fixed_t y)
 
   for (bx=xl ; bx<=xh ; bx++)
     for (by=yl ; by<=yh ; by++)
-      if (!P_BlockThingsIterator(bx,by,PIT_CheckThing))
+      if (!P_BlockThingsIteratorNear(bx,by,PIT_CheckThingReach,PIT_CheckThing))
         return FALSE;
 
   // check lines
@@ -1770,6 +1778,16 @@ static int bombdamage;
 // that caused the explosion at "bombspot".
 //
 
+// The range test of PIT_RadiusAttack, on a mapblock's copy of thing
+static dbool PIT_RadiusAttackReach(const blockthing_t *bt)
+{
+  fixed_t dx = D_abs(bt->x - bombspot->x);
+  fixed_t dy = D_abs(bt->y - bombspot->y);
+  fixed_t dist = ((dx>dy ? dx : dy) - bt->radius) >> FRACBITS;
+
+  return (dist < 0 ? 0 : dist) < bombdamage;
+}
+
 dbool PIT_RadiusAttack (mobj_t* thing)
 {
   fixed_t dx;
@@ -1843,7 +1861,7 @@ void P_RadiusAttack(mobj_t* spot,mobj_t* source,int damage)
 
   for (y=yl ; y<=yh ; y++)
     for (x=xl ; x<=xh ; x++)
-      P_BlockThingsIterator (x, y, PIT_RadiusAttack );
+      P_BlockThingsIteratorNear (x, y, PIT_RadiusAttackReach, PIT_RadiusAttack );
 }
 
 
@@ -1884,6 +1902,7 @@ dbool PIT_ChangeSector (mobj_t* thing)
     thing->flags &= ~MF_SOLID;
     thing->height = 0;
     thing->radius = 0;
+    P_UpdateBlockThing(thing);
     return TRUE; // keep checking
     }
 
@@ -1942,6 +1961,7 @@ dbool P_ChangeSector(sector_t* sector,dbool crunch)
   int   x;
   int   y;
 
+  P_ClearSightCache();
   nofit = FALSE;
   crushchange = crunch;
 
@@ -1972,6 +1992,7 @@ dbool P_CheckSector(sector_t* sector,dbool crunch)
   if (comp[comp_floors]) /* use the old routine for old demos though */
     return P_ChangeSector(sector,crunch);
 
+  P_ClearSightCache();
   nofit = FALSE;
   crushchange = crunch;
 
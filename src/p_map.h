@@ -55,6 +55,8 @@ dbool P_TryMove(mobj_t *thing, fixed_t x, fixed_t y, dbool dropoff);
 dbool P_TeleportMove(mobj_t *thing, fixed_t x, fixed_t y,dbool boss);
 void    P_SlideMove(mobj_t *mo);
 dbool P_CheckSight(mobj_t *t1, mobj_t *t2);
+void P_ClearSightCache(void);   /* each tic, and when sectors move */
+void P_PrintSightStats(void);
 void    P_UseLines(player_t *player);
 
 // killough 8/2/98: add 'mask' argument to prevent friends autoaiming at others
@@ -40,6 +40,7 @@
 #include "p_maputl.h"
 #include "p_map.h"
 #include "p_setup.h"
+#include <stddef.h>
 
 //
 // P_AproxDistance
@@ -213,6 +214,134 @@ void P_LineOpening(const line_t *linedef)
 // THING POSITION SETTING
 //
 
+// Bumped whenever a thing joins or leaves a mapblock (see P_PathBatchBlock)
+static unsigned blocklinkchanges;
+
+//
+// THING GRID
+// Every mapblock also keeps its things in an array, oldest first, with
+// the position and radius they were linked with, so that a query can
+// pass over the things out of its reach without touching them. The
+// array is the blocklinks chain backwards, so iterating it from the end
+// keeps the chain's order. Each thing knows its place in the array
+// (mobj_t::blockindex); a thing leaving the mapblock leaves a hole that
+// is packed away once holes make up half the array. Code that moves or
+// grows a linked thing without relinking it calls P_UpdateBlockThing.
+//
+
+typedef struct {
+  int first, count, size;         // slice of blockthings
+  int holes;                      // entries in count that are empty
+} thingblock_t;
+
+static thingblock_t *thingblocks;     // [bmapheight][bmapwidth], PU_LEVEL
+static blockthing_t *blockthings;     // the slices of all mapblocks
+static size_t numblockthings, maxblockthings;
+
+//
+// P_InitThingGrid
+// Called once blocklinks is allocated, before any thing is linked
+//
+
+void P_InitThingGrid(void)
+{
+  thingblocks = Z_Calloc((size_t) bmapwidth*bmapheight, sizeof(*thingblocks), PU_LEVEL, 0);
+  numblockthings = 0;
+}
+
+static void P_SetBlockThing(blockthing_t *bt, mobj_t *thing)
+{
+  bt->thing = thing;
+  bt->x = thing->x;
+  bt->y = thing->y;
+  bt->radius = thing->radius;
+}
+
+//
+// P_MoveBlockThings
+// Moves count entries from blockthings[from] to blockthings[to],
+// leaving out holes, and returns how many were kept
+//
+
+static int P_MoveBlockThings(int to, int from, int count)
+{
+  int i, kept = 0;
+
+  for (i = 0; i < count; i++)
+  {
+    blockthing_t *bt = &blockthings[from + i];
+
+    if (bt->thing)
+    {
+      bt->thing->blockindex = to + kept;
+      blockthings[to + kept++] = *bt;
+    }
+  }
+  return kept;
+}
+
+static void P_LinkBlockThing(mobj_t *thing, thingblock_t *block)
+{
+  blockthing_t *bt;
+
+  if (block->count == block->size)
+  {
+    // move the slice to the end, with twice the room
+    int size = block->size ? block->size*2 : 4;
+
+    if (numblockthings + size > maxblockthings)
+    {
+      while (numblockthings + size > maxblockthings)
+        maxblockthings = maxblockthings ? maxblockthings*2 : 4096;
+      blockthings = realloc(blockthings, maxblockthings * sizeof(*blockthings));
+    }
+    block->count = P_MoveBlockThings(numblockthings, block->first, block->count);
+    block->holes = 0;
+    block->first = numblockthings;
+    block->size = size;
+    numblockthings += size;
+  }
+  thing->blockindex = block->first + block->count++;
+  bt = &blockthings[thing->blockindex];
+  P_SetBlockThing(bt, thing);
+  bt->block = block - thingblocks;
+}
+
+static void P_UnlinkBlockThing(mobj_t *thing)
+{
+  blockthing_t *bt = &blockthings[thing->blockindex];
+  thingblock_t *block = &thingblocks[bt->block];
+
+  bt->thing = NULL;
+  if (thing->blockindex == block->first + block->count-1)
+  {
+    // the newest thing; drop it and any holes before it
+    while (block->count && !blockthings[block->first + block->count-1].thing)
+    {
+      block->count--;
+      if (block->count && !blockthings[block->first + block->count-1].thing)
+        block->holes--;
+    }
+  }
+  else if (++block->holes*2 > block->count)
+  {
+    block->count = P_MoveBlockThings(block->first, block->first, block->count);
+    block->holes = 0;
+  }
+}
+
+//
+// P_UpdateBlockThing
+// Stores the position and radius of a thing that changed them while
+// linked, e.g. a missile nudged forward after spawning
+//
+
+void P_UpdateBlockThing(mobj_t *thing)
+{
+  if (thing->bprev)
+    P_SetBlockThing(&blockthings[thing->blockindex], thing);
+}
+
 //
 // P_UnsetThingPosition
 // Unlinks a thing from block map and sectors.
@@ -268,8 +397,14 @@ void P_UnsetThingPosition (mobj_t *thing)
        */
 
       mobj_t *bnext, **bprev = thing->bprev;
-      if (bprev && (*bprev = bnext = thing->bnext))  // unlink from block map
-        bnext->bprev = bprev;
+      if (bprev)
+        {
+          P_UnlinkBlockThing(thing);
+          if ((*bprev = bnext = thing->bnext))  // unlink from block map
+            bnext->bprev = bprev;
+          thing->bprev = NULL;
+        }
+      blocklinkchanges++;
     }
 }
 
@@ -333,9 +468,11 @@ void P_SetThingPosition(mobj_t *thing)
           bnext->bprev = &thing->bnext;
         thing->bprev = link;
         *link = thing;
+        P_LinkBlockThing(thing, &thingblocks[blocky*bmapwidth+blockx]);
       }
       else        // thing is off the map
         thing->bnext = NULL, thing->bprev = NULL;
+      blocklinkchanges++;
     }
 }
 
@@ -394,11 +531,48 @@ dbool P_BlockLinesIterator(int x, int y, dbool func(line_t*))
 
 dbool P_BlockThingsIterator(int x, int y, dbool func(mobj_t*))
 {
-  mobj_t *mobj;
-  if (!(x<0 || y<0 || x>=bmapwidth || y>=bmapheight))
-    for (mobj = blocklinks[y*bmapwidth+x]; mobj; mobj = mobj->bnext)
+  return P_BlockThingsIteratorNear(x, y, NULL, func);
+}
+
+//
+// P_BlockThingsIteratorNear
+// Like P_BlockThingsIterator, reading the mapblock's array, but only
+// calls func for things that reach() accepts. reach() sees the thing
+// as it was stored, with a radius never smaller than its own, so it
+// must only turn down things func would have nothing to do with.
+// Should func link or unlink anything, the rest of the mapblock is
+// taken from the blocklinks chain, as before.
+//
+
+dbool P_BlockThingsIteratorNear(int x, int y, dbool reach(const blockthing_t *),
+                                dbool func(mobj_t*))
+{
+  const thingblock_t *block;
+  int i;
+
+  if (x<0 || y<0 || x>=bmapwidth || y>=bmapheight)
+    return TRUE;
+  block = &thingblocks[y*bmapwidth+x];
+  for (i = block->count; --i >= 0; )
+    {
+      const blockthing_t *bt = &blockthings[block->first + i];
+      mobj_t *mobj;
+      unsigned changes;
+
+      if (!bt->thing || (reach && !reach(bt)))
+        continue;
+      mobj = bt->thing;
+      changes = blocklinkchanges;
       if (!func(mobj))
         return FALSE;
+      if (blocklinkchanges != changes)
+        {
+          for (mobj = mobj->bnext; mobj; mobj = mobj->bnext)
+            if (!func(mobj))
+              return FALSE;
+          return TRUE;
+        }
+    }
   return TRUE;
 }
 
@@ -529,6 +703,159 @@ dbool PIT_AddThingIntercepts(mobj_t *thing)
   return TRUE;          // keep going
 }
 
+//
+// Hitscan batches
+// The pellets of a shotgun blast are all traced from the same spot,
+// through much the same mapblocks. Between P_StartPathBatch and
+// P_EndPathBatch, P_PathTraverse takes the lines and things of each
+// mapblock within reach from compact lists, gathered the first time a
+// trace passes through it. They are in blockmap order, so intercepts
+// come out just as they would have. A thing moving into or out of a
+// mapblock drops the lists, to be gathered again.
+//
+
+typedef struct {
+  int firstline, numlines;        // firstline is -1 until gathered
+  int firstthing, numthings;
+} batchblock_t;
+
+static struct {
+  dbool        active;
+  int          x0, y0, width, height;  // mapblocks covered
+  unsigned     linkchanges;            // blocklinkchanges when gathered
+  batchblock_t *blocks;
+  size_t       maxblocks;
+  line_t       **lines;
+  size_t       numlines, maxlines;
+  mobj_t       **things;
+  size_t       numthings, maxthings;
+} pathbatch;
+
+static void P_ResetPathBatch(void)
+{
+  int i;
+
+  for (i = pathbatch.width * pathbatch.height; --i >= 0; )
+    pathbatch.blocks[i].firstline = -1;
+  pathbatch.numlines = pathbatch.numthings = 0;
+  pathbatch.linkchanges = blocklinkchanges;
+}
+
+//
+// P_StartPathBatch
+// Traces from (x,y) out to distance can share mapblock lists until
+// P_EndPathBatch
+//
+
+void P_StartPathBatch(fixed_t x, fixed_t y, fixed_t distance)
+{
+  int reach = (distance >> MAPBLOCKSHIFT) + 2;
+  int bx = (x - bmaporgx) >> MAPBLOCKSHIFT;
+  int by = (y - bmaporgy) >> MAPBLOCKSHIFT;
+  int x1 = MIN(bx + reach, bmapwidth - 1);
+  int y1 = MIN(by + reach, bmapheight - 1);
+  size_t count;
+
+  pathbatch.x0 = MAX(bx - reach, 0);
+  pathbatch.y0 = MAX(by - reach, 0);
+  pathbatch.width = MAX(x1 - pathbatch.x0 + 1, 0);
+  pathbatch.height = MAX(y1 - pathbatch.y0 + 1, 0);
+
+  count = pathbatch.width * pathbatch.height;
+  if (count > pathbatch.maxblocks)
+  {
+    pathbatch.maxblocks = count;
+    pathbatch.blocks = realloc(pathbatch.blocks, count * sizeof(*pathbatch.blocks));
+  }
+  P_ResetPathBatch();
+  pathbatch.active = count > 0;
+}
+
+void P_EndPathBatch(void)
+{
+  pathbatch.active = FALSE;
+}
+
+//
+// P_PathBatchBlock
+// Returns the lists of mapblock (x,y), gathering them if need be, or
+// NULL if it's outside the batch
+//
+
+static const batchblock_t *P_PathBatchBlock(int x, int y)
+{
+  batchblock_t *block;
+  const long *list;
+  const mobj_t *mobj;
+
+  if (!pathbatch.active)
+    return NULL;
+  if ((unsigned)(x - pathbatch.x0) >= (unsigned)pathbatch.width ||
+      (unsigned)(y - pathbatch.y0) >= (unsigned)pathbatch.height)
+    return NULL;
+  if (pathbatch.linkchanges != blocklinkchanges)
+    P_ResetPathBatch();
+
+  block = &pathbatch.blocks[(y - pathbatch.y0) * pathbatch.width + (x - pathbatch.x0)];
+  if (block->firstline >= 0)
+    return block;
+
+  // same list as P_BlockLinesIterator
+  list = blockmaplump + blockmap[y*bmapwidth+x];
+  if (!demo_compatibility)
+    list++;
+  block->firstline = pathbatch.numlines;
+  for ( ; *list != -1; list++)
+  {
+    if (pathbatch.numlines == pathbatch.maxlines)
+    {
+      pathbatch.maxlines = pathbatch.maxlines ? pathbatch.maxlines*2 : 256;
+      pathbatch.lines = realloc(pathbatch.lines, pathbatch.maxlines * sizeof(*pathbatch.lines));
+    }
+    pathbatch.lines[pathbatch.numlines++] = &lines[*list];
+  }
+  block->numlines = pathbatch.numlines - block->firstline;
+
+  block->firstthing = pathbatch.numthings;
+  for (mobj = blocklinks[y*bmapwidth+x]; mobj; mobj = mobj->bnext)
+  {
+    if (pathbatch.numthings == pathbatch.maxthings)
+    {
+      pathbatch.maxthings = pathbatch.maxthings ? pathbatch.maxthings*2 : 256;
+      pathbatch.things = realloc(pathbatch.things, pathbatch.maxthings * sizeof(*pathbatch.things));
+    }
+    pathbatch.things[pathbatch.numthings++] = (mobj_t *) mobj;
+  }
+  block->numthings = pathbatch.numthings - block->firstthing;
+  return block;
+}
+
+//
+// P_AddBatchIntercepts
+// P_BlockLinesIterator and P_BlockThingsIterator with the intercept
+// adders, over a batch's lists
+//
+
+static void P_AddBatchIntercepts(const batchblock_t *block, int flags)
+{
+  int i;
+
+  if (flags & PT_ADDLINES)
+    for (i = 0; i < block->numlines; i++)
+    {
+      line_t *ld = pathbatch.lines[block->firstline + i];
+
+      if (ld->validcount == validcount)
+        continue;
+      ld->validcount = validcount;
+      PIT_AddLineIntercepts(ld);
+    }
+
+  if (flags & PT_ADDTHINGS)
+    for (i = 0; i < block->numthings; i++)
+      PIT_AddThingIntercepts(pathbatch.things[block->firstthing + i]);
+}
+
 //
 // P_TraverseIntercepts
 // Returns TRUE if the traverser function returns TRUE
@@ -654,13 +981,20 @@ dbool P_PathTraverse(fixed_t x1, fixed_t y1, fixed_t x2, fixed_t y2,
 
   for (count = 0; count < 64; count++)
     {
-      if (flags & PT_ADDLINES)
-        if (!P_BlockLinesIterator(mapx, mapy,PIT_AddLineIntercepts))
-          return FALSE; // early out
+      const batchblock_t *block = P_PathBatchBlock(mapx, mapy);
+
+      if (block)
+        P_AddBatchIntercepts(block, flags);
+      else
+        {
+          if (flags & PT_ADDLINES)
+            if (!P_BlockLinesIterator(mapx, mapy,PIT_AddLineIntercepts))
+              return FALSE; // early out
 
-      if (flags & PT_ADDTHINGS)
-        if (!P_BlockThingsIterator(mapx, mapy,PIT_AddThingIntercepts))
-          return FALSE; // early out
+          if (flags & PT_ADDTHINGS)
+            if (!P_BlockThingsIterator(mapx, mapy,PIT_AddThingIntercepts))
+              return FALSE; // early out
+        }
 
       if (mapx == xt2 && mapy == yt2)
         break;
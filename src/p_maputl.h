@@ -77,9 +77,29 @@ void    P_UnsetThingPosition(mobj_t *thing);
 void    P_SetThingPosition(mobj_t *thing);
 dbool P_BlockLinesIterator (int x, int y, dbool func(line_t *));
 dbool P_BlockThingsIterator(int x, int y, dbool func(mobj_t *));
+
+/* A thing as its mapblock keeps it, for P_BlockThingsIteratorNear.
+ * thing is NULL for a thing that has left the mapblock since it was
+ * last packed. */
+typedef struct {
+  mobj_t  *thing;
+  fixed_t x, y, radius;
+  int     block;
+} blockthing_t;
+
+dbool P_BlockThingsIteratorNear(int x, int y, dbool reach(const blockthing_t *),
+                                dbool func(mobj_t *));
+void    P_InitThingGrid(void);
+/* Must be called whenever x, y or radius of a thing in the blockmap
+ * changes without P_UnsetThingPosition/P_SetThingPosition around it */
+void    P_UpdateBlockThing(mobj_t *thing);
 dbool P_PathTraverse(fixed_t x1, fixed_t y1, fixed_t x2, fixed_t y2,
                        int flags, dbool trav(intercept_t *));
 
+/* Share mapblock lists between traces from one spot, e.g. shotgun pellets */
+void    P_StartPathBatch(fixed_t x, fixed_t y, fixed_t distance);
+void    P_EndPathBatch(void);
+
 extern fixed_t opentop;
 extern fixed_t openbottom;
 extern fixed_t openrange;
@@ -819,8 +819,7 @@ mobj_t* P_SpawnMobj(fixed_t x,fixed_t y,fixed_t z,mobjtype_t type)
   state_t*    st;
   mobjinfo_t* info;
 
-  mobj = Z_Malloc (sizeof(*mobj), PU_LEVEL, NULL);
-  memset (mobj, 0, sizeof (*mobj));
+  mobj = P_NewThinker(tp_mobj);
   info = &mobjinfo[type];
   mobj->type = type;
   mobj->info = info;
@@ -1406,6 +1405,7 @@ void P_CheckMissileSpawn (mobj_t* th)
 
   th->x += (th->momx>>1);
   th->y += (th->momy>>1);
+  P_UpdateBlockThing(th);
   th->z += (th->momz>>1);
 
   // killough 8/12/98: for non-missile objects (e.g. grenades)
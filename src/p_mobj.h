@@ -276,6 +276,9 @@ typedef struct mobj_s
     thinker_t           thinker;
 
     // Info for drawing: position.
+    // While the thing is in the blockmap its mapblock keeps a copy of
+    // x, y and radius; code that changes them without going through
+    // P_UnsetThingPosition/P_SetThingPosition must call P_UpdateBlockThing.
     fixed_t             x;
     fixed_t             y;
     fixed_t             z;
@@ -380,7 +383,9 @@ typedef struct mobj_s
     // Extra id based on thing type that's used in MUSINFO
     short               iden_num;
 
-    fixed_t             pad; // cph - needed so I can get the size unambiguously on amd64
+    // Where the thing is in blockthings while in the blockmap. Takes the
+    // place of cph's padding, which kept the size unambiguous on amd64
+    int                 blockindex;
 
     // SEE WARNING ABOVE ABOUT POINTER FIELDS!!!
 } mobj_t;
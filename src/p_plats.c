@@ -218,8 +218,7 @@ int EV_DoPlat
 
      /* Create a thinker */
      rtn = 1;
-     plat = Z_Malloc( sizeof(*plat), PU_LEVSPEC, 0);
-     memset(plat, 0, sizeof(*plat));
+     plat = P_NewThinker(tp_plat);
      P_AddThinker(&plat->thinker);
 
      plat->type              = type;
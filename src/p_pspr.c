@@ -35,6 +35,7 @@
 #include "doomstat.h"
 #include "r_main.h"
 #include "p_map.h"
+#include "p_maputl.h"
 #include "p_inter.h"
 #include "p_pspr.h"
 #include "p_enemy.h"
@@ -905,8 +906,10 @@ void A_FireShotgun(player_t *player, pspdef_t *psp)
 
   P_BulletSlope(player->mo);
 
+  P_StartPathBatch(player->mo->x, player->mo->y, MISSILERANGE);
   for (i=0; i<7; i++)
     P_GunShot(player->mo, false);
+  P_EndPathBatch();
 
   retro_set_rumble_damage(40, 120.0f);
 }
@@ -927,6 +930,7 @@ void A_FireShotgun2(player_t *player, pspdef_t *psp)
 
   P_BulletSlope(player->mo);
 
+  P_StartPathBatch(player->mo->x, player->mo->y, MISSILERANGE);
   for (i=0; i<20; i++)
     {
       int damage = 5*(P_Random(pr_shotgun)%3+1);
@@ -938,6 +942,7 @@ void A_FireShotgun2(player_t *player, pspdef_t *psp)
       P_LineAttack(player->mo, angle, MISSILERANGE, bulletslope +
                    ((t - P_Random(pr_shotgun))<<5), damage);
     }
+  P_EndPathBatch();
 
   retro_set_rumble_damage(40, 120.0f);
 }
@@ -0,0 +1,533 @@
+/* Emacs style mode select   -*- C++ -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *  Copyright (C) 1999 by
+ *  id Software, Chi Hoang, Lee Killough, Jim Flynn, Rand Phares, Ty Halderman
+ *  Copyright (C) 1999-2000 by
+ *  Jess Haas, Nicolas Kalkhof, Colin Phipps, Florian Schulze
+ *  Copyright 2005, 2006 by
+ *  Florian Schulze, Colin Phipps, Neil Stevens, Andrey Budko
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *      REJECT tables built at load time, for maps that ship an empty one.
+ *      A sector can only see another if some straight line between
+ *      them crosses nothing but two-sided lines (portals). Lines of
+ *      sight are followed out of every portal of a sector, from sector
+ *      to sector, with each portal clipped to the part of it that a
+ *      line through all the portals before it can reach. Sector heights
+ *      are left out, so every pair that can see each other is kept and
+ *      the table only saves P_CheckSight the BSP walk for pairs that
+ *      would fail it anyway. Sectors that aren't closed, or whose
+ *      self-referencing lines lie outside them (deep water tricks), are
+ *      left to see everything.
+ *      Tables are kept in reject_<md5>.cache in the save directory, the
+ *      md5 being taken over the map's geometry lumps.
+ *
+ *---------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "doomstat.h"
+#include "d_main.h"
+#include "m_misc.h"
+#include "md5.h"
+#include "w_wad.h"
+#include "r_main.h"
+#include "r_thread.h"
+#include "p_setup.h"
+#include "p_reject.h"
+#include "i_system.h"
+#include "lprintf.h"
+
+int p_buildreject;
+
+#define REJECTMAGIC "PRBMRJ01"
+
+typedef struct
+{
+  char     magic[8];              // REJECTMAGIC
+  uint32_t numsectors;
+  uint32_t length;                // of the table that follows
+} rejectheader_t;
+
+// A two-sided line crossed one way, oriented so that the sector it
+// leads into is on the left (positive cross products)
+typedef struct
+{
+  int x1, y1, x2, y2;             // map units
+  int to;
+  int line;
+} portal_t;
+
+static struct
+{
+  portal_t *portals;              // grouped by the sector they lead out of
+  int      *firstportal;          // [numsectors+1]
+  uint8_t  *leaky;                // sectors that must see everything
+  uint8_t  *vis;                  // [numsectors][rowbytes]
+  size_t   rowbytes;
+  int      *stacks;               // [render_threads][numsectors]
+  unsigned *marks;                // ditto, flood generation per sector
+  uint8_t  *inchain;              // [render_threads][numlines]
+} build;
+
+static INLINE int64_t P_PortalCross(const portal_t *p, int x, int y)
+{
+  return (int64_t)(p->x2 - p->x1) * (y - p->y1) -
+         (int64_t)(p->y2 - p->y1) * (x - p->x1);
+}
+
+//
+// P_PortalSeesPortal
+// Whether a line of sight crossing s can cross q afterwards: q must
+// reach beyond s, and s must reach behind q
+//
+
+static INLINE dbool P_PortalSeesPortal(const portal_t *s, const portal_t *q)
+{
+  return (P_PortalCross(s, q->x1, q->y1) >= 0 ||
+          P_PortalCross(s, q->x2, q->y2) >= 0) &&
+         (P_PortalCross(q, s->x1, s->y1) <= 0 ||
+          P_PortalCross(q, s->x2, s->y2) <= 0);
+}
+
+//
+// P_FloodReject
+// Marks every sector reachable from source through portals that pass
+// P_PortalSeesPortal; the fallback when the flow below gives up
+//
+
+static void P_FloodReject(const portal_t *source, uint8_t *row,
+                          int *stack, unsigned *mark, unsigned generation)
+{
+  int sp = 0;
+
+  mark[source->to] = generation;
+  row[source->to>>3] |= 1 << (source->to&7);
+  stack[sp++] = source->to;
+
+  while (sp)
+  {
+    int y = stack[--sp], q;
+
+    for (q = build.firstportal[y]; q < build.firstportal[y+1]; q++)
+    {
+      const portal_t *portal = &build.portals[q];
+
+      if (mark[portal->to] == generation ||
+          !P_PortalSeesPortal(source, portal))
+        continue;
+      mark[portal->to] = generation;
+      row[portal->to>>3] |= 1 << (portal->to&7);
+      stack[sp++] = portal->to;
+    }
+  }
+}
+
+// The part of a portal that a line of sight can still pass through
+typedef struct
+{
+  double x1, y1, x2, y2;
+} window_t;
+
+typedef struct
+{
+  const portal_t *source;
+  uint8_t  *row;
+  uint8_t  *inchain;              // lines crossed on the current path
+  int      steps;
+} flow_t;
+
+// A flow from one source portal is given up for the flood fill after
+// this many portals or this deep, on big open maps
+#define REJECT_MAXSTEPS 16384
+#define REJECT_MAXDEPTH 256
+
+// Clipping slack, in map units, so rounding never closes a window
+#define REJECT_SLACK 0.01
+
+//
+// P_ClipWindow
+// Clips w to the left of the line through (ax,ay) and (bx,by), keeping
+// anything within REJECT_SLACK of it. Returns false if nothing is left.
+//
+
+static dbool P_ClipWindow(window_t *w, double ax, double ay, double bx, double by)
+{
+  double dx = bx - ax, dy = by - ay;
+  double slack = REJECT_SLACK*REJECT_SLACK * (dx*dx + dy*dy);
+  double c1 = dx * (w->y1 - ay) - dy * (w->x1 - ax);
+  double c2 = dx * (w->y2 - ay) - dy * (w->x2 - ax);
+  dbool in1 = c1 >= 0 || c1*c1 <= slack;
+  dbool in2 = c2 >= 0 || c2*c2 <= slack;
+  double t;
+
+  if (in1 && in2)
+    return TRUE;
+  if (!in1 && !in2)
+    return FALSE;
+  t = c1 / (c1 - c2);
+  if (in1)
+    w->x2 = w->x1 + t * (w->x2 - w->x1), w->y2 = w->y1 + t * (w->y2 - w->y1);
+  else
+    w->x1 = w->x1 + t * (w->x2 - w->x1), w->y1 = w->y1 + t * (w->y2 - w->y1);
+  return TRUE;
+}
+
+//
+// P_RejectFlow
+// Follows the lines of sight that cross the source portal and then
+// pass, out of sector through its portals. Each portal is clipped to
+// beyond the source and pass, and to between the two lines joining
+// their opposite ends, which bound every line through both. A line of
+// sight crosses each map line once at most. Returns false if it gave up.
+//
+
+static dbool P_RejectFlow(flow_t *f, int sector, const window_t *pass, int depth)
+{
+  const portal_t *s = f->source;
+  int q;
+
+  for (q = build.firstportal[sector]; q < build.firstportal[sector+1]; q++)
+  {
+    const portal_t *portal = &build.portals[q];
+    window_t w;
+    dbool ok;
+
+    if (f->inchain[portal->line])
+      continue;
+    if (++f->steps > REJECT_MAXSTEPS || depth > REJECT_MAXDEPTH)
+      return FALSE;
+
+    w.x1 = portal->x1, w.y1 = portal->y1, w.x2 = portal->x2, w.y2 = portal->y2;
+    if (!P_ClipWindow(&w, s->x1, s->y1, s->x2, s->y2))
+      continue;
+    if (pass &&
+        (!P_ClipWindow(&w, pass->x1, pass->y1, pass->x2, pass->y2) ||
+         !P_ClipWindow(&w, s->x1, s->y1, pass->x2, pass->y2) ||
+         !P_ClipWindow(&w, pass->x1, pass->y1, s->x2, s->y2)))
+      continue;
+
+    f->row[portal->to>>3] |= 1 << (portal->to&7);
+    f->inchain[portal->line] = TRUE;
+    ok = P_RejectFlow(f, portal->to, &w, depth+1);
+    f->inchain[portal->line] = FALSE;
+    if (!ok)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+static void P_RejectJob(int strip)
+{
+  int *stack = build.stacks + (size_t)strip*numsectors;
+  unsigned *mark = build.marks + (size_t)strip*numsectors;
+  unsigned generation = 0;
+  flow_t flow;
+  int a;
+
+  flow.inchain = build.inchain + (size_t)strip*numlines;
+
+  for (a = strip; a < numsectors; a += render_threads)
+  {
+    int s;
+
+    flow.row = build.vis + a*build.rowbytes;
+    if (build.leaky[a])
+    {
+      memset(flow.row, 0xff, build.rowbytes);
+      continue;
+    }
+    flow.row[a>>3] |= 1 << (a&7);
+
+    for (s = build.firstportal[a]; s < build.firstportal[a+1]; s++)
+    {
+      flow.source = &build.portals[s];
+      flow.steps = 0;
+      flow.row[flow.source->to>>3] |= 1 << (flow.source->to&7);
+      flow.inchain[flow.source->line] = TRUE;
+      if (!P_RejectFlow(&flow, flow.source->to, NULL, 0))
+        P_FloodReject(flow.source, flow.row, stack, mark, ++generation);
+      flow.inchain[flow.source->line] = FALSE;
+    }
+  }
+}
+
+//
+// P_FindLeakySectors
+// Marks sectors whose lines don't close them, or whose self-referencing
+// lines lie outside them, where the map's line sides don't tell what
+// sector a line of sight is in
+//
+
+static void P_FindLeakySectors(void)
+{
+  int *balance = Z_Calloc(numvertexes, sizeof(*balance), PU_STATIC, 0);
+  int i, j, k;
+
+  for (i = 0; i < numsectors; i++)
+  {
+    const sector_t *sec = &sectors[i];
+
+    for (j = 0; j < sec->linecount; j++)
+    {
+      const line_t *li = sec->lines[j];
+
+      if (li->frontsector == li->backsector)
+        continue;
+      if (li->frontsector == sec)
+        balance[li->v1 - vertexes]++, balance[li->v2 - vertexes]--;
+      else
+        balance[li->v2 - vertexes]++, balance[li->v1 - vertexes]--;
+    }
+    for (j = 0; j < sec->linecount; j++)
+    {
+      const line_t *li = sec->lines[j];
+
+      if (balance[li->v1 - vertexes] || balance[li->v2 - vertexes])
+        build.leaky[i] = TRUE;
+      balance[li->v1 - vertexes] = balance[li->v2 - vertexes] = 0;
+    }
+    if (build.leaky[i])
+      continue;
+
+    // even-odd test of each self-referencing line's midpoint against
+    // the sector's other lines, in doubled coordinates
+    for (j = 0; j < sec->linecount && !build.leaky[i]; j++)
+    {
+      const line_t *self = sec->lines[j];
+      int64_t px, py;
+      int crossings = 0;
+
+      if (self->frontsector != self->backsector)
+        continue;
+      px = ((int64_t)self->v1->x + self->v2->x) >> FRACBITS;
+      py = ((int64_t)self->v1->y + self->v2->y) >> FRACBITS;
+
+      for (k = 0; k < sec->linecount; k++)
+      {
+        const line_t *li = sec->lines[k];
+        int64_t ax = (int64_t)(li->v1->x >> FRACBITS) * 2;
+        int64_t ay = (int64_t)(li->v1->y >> FRACBITS) * 2;
+        int64_t bx = (int64_t)(li->v2->x >> FRACBITS) * 2;
+        int64_t by = (int64_t)(li->v2->y >> FRACBITS) * 2;
+        int64_t cross;
+
+        if (li->frontsector == li->backsector || (ay > py) == (by > py))
+          continue;
+        // does the edge pass to the right of the point?
+        cross = (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+        if (by > ay ? cross > 0 : cross < 0)
+          crossings++;
+      }
+      if (!(crossings & 1))
+        build.leaky[i] = TRUE;
+    }
+  }
+  Z_Free(balance);
+}
+
+static void P_BuildPortals(void)
+{
+  int i, n;
+
+  build.firstportal = Z_Calloc(numsectors + 1, sizeof(int), PU_STATIC, 0);
+
+  for (i = 0; i < numlines; i++)
+  {
+    const line_t *li = &lines[i];
+
+    if ((li->flags & ML_TWOSIDED) && li->backsector &&
+        li->frontsector != li->backsector)
+    {
+      build.firstportal[li->frontsector - sectors + 1]++;
+      build.firstportal[li->backsector - sectors + 1]++;
+    }
+  }
+  for (i = 0; i < numsectors; i++)
+    build.firstportal[i+1] += build.firstportal[i];
+  n = build.firstportal[numsectors];
+  build.portals = Z_Malloc(MAX(n, 1) * sizeof(portal_t), PU_STATIC, 0);
+
+  // fill from the back, so each sector's portals keep line order
+  for (i = numlines; --i >= 0; )
+  {
+    const line_t *li = &lines[i];
+    int x1 = li->v1->x >> FRACBITS, y1 = li->v1->y >> FRACBITS;
+    int x2 = li->v2->x >> FRACBITS, y2 = li->v2->y >> FRACBITS;
+    portal_t *p;
+
+    if (!(li->flags & ML_TWOSIDED) || !li->backsector ||
+        li->frontsector == li->backsector)
+      continue;
+
+    // front to back: the back sector is on the line's left
+    p = &build.portals[--build.firstportal[li->frontsector - sectors + 1]];
+    p->x1 = x1, p->y1 = y1, p->x2 = x2, p->y2 = y2;
+    p->to = li->backsector - sectors;
+    p->line = i;
+
+    p = &build.portals[--build.firstportal[li->backsector - sectors + 1]];
+    p->x1 = x2, p->y1 = y2, p->x2 = x1, p->y2 = y1;
+    p->to = li->frontsector - sectors;
+    p->line = i;
+  }
+  // the decrements above left firstportal[i+1] at the start of sector i
+  memmove(build.firstportal, build.firstportal + 1, numsectors * sizeof(int));
+  build.firstportal[numsectors] = n;
+}
+
+static uint8_t *P_ComputeReject(size_t required)
+{
+  uint8_t *reject = Z_Calloc(required, 1, PU_LEVEL, 0);
+  int a, b, pnum;
+
+  build.rowbytes = (numsectors + 7) / 8;
+  build.vis = Z_Calloc(numsectors, build.rowbytes, PU_STATIC, 0);
+  build.leaky = Z_Calloc(numsectors, 1, PU_STATIC, 0);
+  build.stacks = Z_Malloc((size_t)render_threads * numsectors * sizeof(int), PU_STATIC, 0);
+  build.marks = Z_Calloc((size_t)render_threads * numsectors, sizeof(unsigned), PU_STATIC, 0);
+
+  P_FindLeakySectors();
+  P_BuildPortals();
+  build.inchain = Z_Calloc((size_t)render_threads * numlines, 1, PU_STATIC, 0);
+  R_RunRenderThreads(P_RejectJob);
+
+  // visibility is symmetric, so a pair is rejected if either way is
+  for (a = 0, pnum = 0; a < numsectors; a++)
+  {
+    const uint8_t *row = build.vis + a*build.rowbytes;
+
+    for (b = 0; b < numsectors; b++, pnum++)
+      if (!(row[b>>3] & (1 << (b&7))) ||
+          !(build.vis[b*build.rowbytes + (a>>3)] & (1 << (a&7))))
+        reject[pnum>>3] |= 1 << (pnum&7);
+  }
+
+  Z_Free(build.vis);
+  Z_Free(build.leaky);
+  Z_Free(build.stacks);
+  Z_Free(build.marks);
+  Z_Free(build.inchain);
+  Z_Free(build.portals);
+  Z_Free(build.firstportal);
+  memset(&build, 0, sizeof(build));
+  return reject;
+}
+
+//
+// P_BuildReject
+// Hashes the map's geometry into the cache file name, and reads the
+// table from it if it's there; builds and writes it otherwise.
+//
+
+const uint8_t *P_BuildReject(int lumpnum)
+{
+  static const int maplumps[] = { ML_VERTEXES, ML_LINEDEFS, ML_SIDEDEFS, ML_SECTORS };
+  size_t required = ((size_t)numsectors * numsectors + 7) / 8;
+  struct MD5Context md5;
+  uint8_t key[16], *data, *reject;
+  char hex[33], *filename;
+  int64_t start = I_GetTimeUS();
+  int length, count, i;
+#ifdef _WIN32
+  char slash = '\\';
+#else
+  char slash = '/';
+#endif
+
+  if (!numsectors)
+    return NULL;
+
+  MD5Init(&md5);
+  MD5Update(&md5, (const md5byte *) REJECTMAGIC, 8);
+  for (i = 0; i < (int)(sizeof(maplumps)/sizeof(*maplumps)); i++)
+  {
+    int lump = lumpnum + maplumps[i];
+
+    MD5Update(&md5, W_CacheLumpNum(lump), W_LumpLength(lump));
+    W_UnlockLumpNum(lump);
+  }
+  MD5Final(key, &md5);
+  for (i = 0; i < 16; i++)
+    sprintf(hex + i*2, "%02x", key[i]);
+
+  filename = NULL;
+  if (*basesavegame)
+  {
+    const rejectheader_t *header;
+
+    filename = malloc(strlen(basesavegame) + 48);
+    sprintf(filename, "%s%creject_%s.cache", basesavegame, slash, hex);
+
+    length = M_ReadFile(filename, &data);
+    if (length >= 0)
+    {
+      header = (const rejectheader_t *) data;
+      if ((size_t) length == sizeof(*header) + required &&
+          !memcmp(header->magic, REJECTMAGIC, 8) &&
+          header->numsectors == (uint32_t) numsectors &&
+          header->length == required)
+      {
+        reject = Z_Malloc(required, PU_LEVEL, 0);
+        memcpy(reject, data + sizeof(*header), required);
+        Z_Free(data);
+        free(filename);
+        lprintf(LO_DEBUG, "P_BuildReject: read reject_%s.cache\n", hex);
+        return reject;
+      }
+      lprintf(LO_WARN, "P_BuildReject: ignoring invalid %s\n", filename);
+      Z_Free(data);
+    }
+  }
+
+  reject = P_ComputeReject(required);
+
+  for (i = 0, count = 0; (size_t) i < required; i++)
+  {
+    unsigned bits = reject[i];
+
+    for (; bits; bits &= bits - 1)
+      count++;
+  }
+  lprintf(LO_INFO, "P_BuildReject: %d sectors, %d%% of pairs rejected, %d ms\n",
+          numsectors, (int)((int64_t)count * 100 / ((int64_t)numsectors * numsectors)),
+          (int)((I_GetTimeUS() - start) / 1000));
+
+  if (filename)
+  {
+    rejectheader_t *header;
+
+    data = malloc(sizeof(*header) + required);
+    header = (rejectheader_t *) data;
+    memcpy(header->magic, REJECTMAGIC, 8);
+    header->numsectors = numsectors;
+    header->length = required;
+    memcpy(data + sizeof(*header), reject, required);
+    if (!M_WriteFile(filename, data, sizeof(*header) + required))
+      lprintf(LO_WARN, "P_BuildReject: couldn't write %s\n", filename);
+    free(data);
+    free(filename);
+  }
+  return reject;
+}
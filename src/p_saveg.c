@@ -451,7 +451,7 @@ void P_UnArchiveThinkers (void)
         P_RemoveThinkerDelayed(th); // fix mobj leak
       }
       else
-        Z_Free (th);
+        P_FreeThinker(th);
       th = next;
     }
   P_InitThinkers ();
@@ -477,7 +477,7 @@ void P_UnArchiveThinkers (void)
   // read in saved thinkers
   for (size = 1; *save_p++ == tc_mobj; size++)    // killough 2/14/98
     {
-      mobj_t *mobj = Z_Malloc(sizeof(mobj_t), PU_LEVEL, NULL);
+      mobj_t *mobj = P_NewThinker(tp_mobj);
 
       // killough 2/14/98 -- insert pointers to thinkers into table, in order:
       mobj_p[size] = mobj;
@@ -515,6 +515,9 @@ void P_UnArchiveThinkers (void)
       mobj->PrevY = mobj->y;
       mobj->PrevZ = mobj->z;
 
+      // the blockmap links were saved too; inert things keep no others
+      mobj->bnext = NULL;
+      mobj->bprev = NULL;
       P_SetThingPosition (mobj);
       mobj->info = &mobjinfo[mobj->type];
 
@@ -827,7 +830,7 @@ void P_UnArchiveSpecials (void)
       case tc_ceiling:
         PADSAVEP();
         {
-          ceiling_t *ceiling = Z_Malloc (sizeof(*ceiling), PU_LEVEL, NULL);
+          ceiling_t *ceiling = P_NewThinker(tp_ceiling);
           memcpy (ceiling, save_p, sizeof(*ceiling));
           save_p += sizeof(*ceiling);
           ceiling->sector = &sectors[(uintptr_t)ceiling->sector];
@@ -844,7 +847,7 @@ void P_UnArchiveSpecials (void)
       case tc_door:
         PADSAVEP();
         {
-          vldoor_t *door = Z_Malloc (sizeof(*door), PU_LEVEL, NULL);
+          vldoor_t *door = P_NewThinker(tp_door);
           memcpy (door, save_p, sizeof(*door));
           save_p += sizeof(*door);
           door->sector = &sectors[(uintptr_t)door->sector];
@@ -861,7 +864,7 @@ void P_UnArchiveSpecials (void)
       case tc_floor:
         PADSAVEP();
         {
-          floormove_t *floor = Z_Malloc (sizeof(*floor), PU_LEVEL, NULL);
+          floormove_t *floor = P_NewThinker(tp_floor);
           memcpy (floor, save_p, sizeof(*floor));
           save_p += sizeof(*floor);
           floor->sector = &sectors[(uintptr_t)floor->sector];
@@ -874,7 +877,7 @@ void P_UnArchiveSpecials (void)
       case tc_plat:
         PADSAVEP();
         {
-          plat_t *plat = Z_Malloc (sizeof(*plat), PU_LEVEL, NULL);
+          plat_t *plat = P_NewThinker(tp_plat);
           memcpy (plat, save_p, sizeof(*plat));
           save_p += sizeof(*plat);
           plat->sector = &sectors[(uintptr_t)plat->sector];
@@ -891,7 +894,7 @@ void P_UnArchiveSpecials (void)
       case tc_flash:
         PADSAVEP();
         {
-          lightflash_t *flash = Z_Malloc (sizeof(*flash), PU_LEVEL, NULL);
+          lightflash_t *flash = P_NewThinker(tp_lightflash);
           memcpy (flash, save_p, sizeof(*flash));
           save_p += sizeof(*flash);
           flash->sector = &sectors[(uintptr_t)flash->sector];
@@ -903,7 +906,7 @@ void P_UnArchiveSpecials (void)
       case tc_strobe:
         PADSAVEP();
         {
-          strobe_t *strobe = Z_Malloc (sizeof(*strobe), PU_LEVEL, NULL);
+          strobe_t *strobe = P_NewThinker(tp_strobe);
           memcpy (strobe, save_p, sizeof(*strobe));
           save_p += sizeof(*strobe);
           strobe->sector = &sectors[(uintptr_t)strobe->sector];
@@ -915,7 +918,7 @@ void P_UnArchiveSpecials (void)
       case tc_glow:
         PADSAVEP();
         {
-          glow_t *glow = Z_Malloc (sizeof(*glow), PU_LEVEL, NULL);
+          glow_t *glow = P_NewThinker(tp_glow);
           memcpy (glow, save_p, sizeof(*glow));
           save_p += sizeof(*glow);
           glow->sector = &sectors[(uintptr_t)glow->sector];
@@ -927,7 +930,7 @@ void P_UnArchiveSpecials (void)
       case tc_flicker:           // killough 10/4/98
         PADSAVEP();
         {
-          fireflicker_t *flicker = Z_Malloc (sizeof(*flicker), PU_LEVEL, NULL);
+          fireflicker_t *flicker = P_NewThinker(tp_fireflicker);
           memcpy (flicker, save_p, sizeof(*flicker));
           save_p += sizeof(*flicker);
           flicker->sector = &sectors[(uintptr_t)flicker->sector];
@@ -940,7 +943,7 @@ void P_UnArchiveSpecials (void)
       case tc_elevator:
         PADSAVEP();
         {
-          elevator_t *elevator = Z_Malloc (sizeof(*elevator), PU_LEVEL, NULL);
+          elevator_t *elevator = P_NewThinker(tp_elevator);
           memcpy (elevator, save_p, sizeof(*elevator));
           save_p += sizeof(*elevator);
           elevator->sector = &sectors[(uintptr_t)elevator->sector];
@@ -953,7 +956,7 @@ void P_UnArchiveSpecials (void)
 
       case tc_scroll:       // killough 3/7/98: scroll effect thinkers
         {
-          scroll_t *scroll = Z_Malloc (sizeof(scroll_t), PU_LEVEL, NULL);
+          scroll_t *scroll = P_NewThinker(tp_scroll);
           memcpy (scroll, save_p, sizeof(scroll_t));
           save_p += sizeof(scroll_t);
           scroll->thinker.function = T_Scroll;
@@ -963,7 +966,7 @@ void P_UnArchiveSpecials (void)
 
       case tc_pusher:   // phares 3/22/98: new Push/Pull effect thinkers
         {
-          pusher_t *pusher = Z_Malloc (sizeof(pusher_t), PU_LEVEL, NULL);
+          pusher_t *pusher = P_NewThinker(tp_pusher);
           memcpy (pusher, save_p, sizeof(pusher_t));
           save_p += sizeof(pusher_t);
           pusher->thinker.function = T_Pusher;
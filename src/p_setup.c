@@ -45,6 +45,7 @@
 #include "p_setup.h"
 #include "p_spec.h"
 #include "p_tick.h"
+#include "p_reject.h"
 #include "p_enemy.h"
 #include "s_sound.h"
 #include "lprintf.h" //jff 10/6/98 for debug outputs
@@ -52,6 +53,7 @@
 #include "r_demo.h"
 #include "r_fps.h"
 #include "u_musinfo.h"
+#include "i_system.h"
 
 //
 // MAP related Lookup tables.
@@ -336,6 +338,7 @@ mobj_t    **blocklinks;           // for thing chains
 
 static int rejectlump = -1;// cph - store reject lump num if cached
 const uint8_t *rejectmatrix; // cph - const*
+const uint8_t *builtreject;  // for maps that ship an empty REJECT
 
 // Maintain single and multi player starting spots.
 
@@ -1458,6 +1461,7 @@ static void P_LoadBlockMap (int lump)
 
   // clear out mobj chains - CPhipps - use calloc
   blocklinks = Z_Calloc ((size_t) bmapwidth*bmapheight, sizeof(*blocklinks), PU_LEVEL, 0);
+  P_InitThingGrid();
   blockmap = blockmaplump+4;
 }
 
@@ -1486,6 +1490,19 @@ static void P_LoadReject(int lumpnum, int totallines)
   required = (numsectors * numsectors + 7) / 8;
   length = W_LumpLength(rejectlump);
 
+  // many nodebuilders write an empty REJECT, which rejects nothing;
+  // P_CheckSight can use a built one next to it
+  builtreject = NULL;
+  if (p_buildreject)
+  {
+    unsigned int i, n = MIN(length, required);
+
+    for (i = 0; i < n && !rejectmatrix[i]; i++)
+      ;
+    if (i == n)
+      builtreject = P_BuildReject(lumpnum);
+  }
+
   if (length >= required)
     return; // nothing to do
 
@@ -1614,6 +1631,25 @@ static int P_GroupLines (void)
          P_AddLineToSector(li, li->backsector);
    }
 
+   {  // sector adjacency in line order, for P_NoiseAlert
+      sectoredge_t *edge = Z_Malloc(total*sizeof(sectoredge_t), PU_LEVEL, 0);
+
+      for (i=0, sector = sectors; i<numsectors; i++, sector++)
+      {
+         sector->edges = edge;
+         for (j=0; j<sector->linecount; j++)
+         {
+            li = sector->lines[j];
+            if (li->sidenum[1] == NO_INDEX)
+               continue;   // never open
+            edge->line = li;
+            edge->other = sides[li->sidenum[sides[li->sidenum[0]].sector==sector]].sector;
+            edge++;
+         }
+         sector->edgecount = edge - sector->edges;
+      }
+   }
+
    for (i=0, sector = sectors; i<numsectors; i++, sector++)
    {
       fixed_t *bbox = (void*)sector->blockbox; // cph - For convenience, so
@@ -1744,17 +1780,51 @@ static void P_RemoveSlimeTrails(void)         // killough 10/98
 =
 = P_SetupLevel
 =
+= The setup is split into stages so that a big level can be loaded a
+= few stages per frame (see G_ContinueLoadLevel): P_StartSetupLevel,
+= then P_ContinueSetupLevel until it returns true. P_SetupLevel does
+= it all at once.
+=
 =================
 */
 
-void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
+typedef enum
 {
-   int   i;
-   char  lumpname[9];
+   ls_idle,
+   ls_geometry,      // vertexes, sectors, sidedefs and linedefs
+   ls_blockmap,
+   ls_bsp,           // subsectors, nodes and segs
+   ls_reject,
+   ls_slimetrails,
+   ls_things,        // things and specials
+   ls_precache,
+} loadstage_t;
+
+static struct
+{
+   loadstage_t stage;
    int   lumpnum;
-
-   char  gl_lumpname[9];
    int   gl_lumpnum;
+   char  lumpname[9];
+} setup;
+
+//
+// P_MapLumpName
+// The marker lump name of a map, as P_SetupLevel looks it up
+//
+
+void P_MapLumpName(char *lumpname, int episode, int map)
+{
+   if (gamemode == commercial)
+      sprintf(lumpname, "map%02d", map);     // killough 1/24/98: simplify
+   else
+      sprintf(lumpname, "E%dM%d", episode, map); // killough 1/24/98: simplify
+}
+
+void P_StartSetupLevel(int episode, int map, int playermask, skill_t skill)
+{
+   int   i;
+   char  gl_lumpname[12];
 
    R_StopAllInterpolations();
 
@@ -1770,7 +1840,18 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
    // Make sure all sounds are stopped before Z_FreeTags.
    S_Start();
 
+   R_StopPrefetch();
+   Z_DumpHistory(NULL);
    Z_FreeTags(PU_LEVEL, PU_PURGELEVEL-1);
+   P_ClearThinkerPools();
+
+   // the player mobjs went with the level, and sounds are still
+   // updated while the new one loads
+   for (i=0; i<MAXPLAYERS; i++)
+      players[i].mo = NULL;
+   Z_PrintCacheStats();
+   P_PrintSightStats();
+   P_ClearSightCache();
    if (rejectlump != -1) { // cph - unlock the reject table
       W_UnlockLumpNum(rejectlump);
       rejectlump = -1;
@@ -1782,126 +1863,186 @@ void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
    //    W_Reload ();     killough 1/31/98: W_Reload obsolete
 
    // find map name
-   if (gamemode == commercial)
-   {
-      sprintf(lumpname, "map%02d", map);           // killough 1/24/98: simplify
-      sprintf(gl_lumpname, "gl_map%02d", map);    // figgi
-   }
-   else
-   {
-      sprintf(lumpname, "E%dM%d", episode, map);   // killough 1/24/98: simplify
-      sprintf(gl_lumpname, "GL_E%iM%i", episode, map); // figgi
-   }
+   P_MapLumpName(setup.lumpname, episode, map);
+   sprintf(gl_lumpname, "gl_%s", setup.lumpname);    // figgi
 
-   lumpnum = W_GetNumForName(lumpname);
-   gl_lumpnum = W_CheckNumForName(gl_lumpname); // figgi
+   setup.lumpnum = W_GetNumForName(setup.lumpname);
+   setup.gl_lumpnum = W_CheckNumForName(gl_lumpname); // figgi
 
    leveltime = 0; totallive = 0;
 
-   // note: most of this ordering is important
-
-   // killough 3/1/98: P_LoadBlockMap call moved down to below
-   // killough 4/4/98: split load of sidedefs into two parts,
-   // to allow texture names to be used in special linedefs
-
    // refuse to load Hexen-format maps, avoid segfaults
-   if ((i = lumpnum + ML_BLOCKMAP + 1) < numlumps
+   if ((i = setup.lumpnum + ML_BLOCKMAP + 1) < numlumps
          && !strncasecmp(lumpinfo[i].name, "BEHAVIOR", 8))
-      I_Error("P_SetupLevel: %s: Hexen format not supported", lumpname);
+      I_Error("P_SetupLevel: %s: Hexen format not supported", setup.lumpname);
 
    // figgi 10/19/00 -- check for gl lumps and load them
-   P_GetNodesVersion(lumpnum,gl_lumpnum);
-
-   if (nodes_glbsp > 0)
-      P_LoadVertexes2 (lumpnum+ML_VERTEXES,gl_lumpnum+ML_GL_VERTS);
-   else
-      P_LoadVertexes  (lumpnum+ML_VERTEXES);
-   P_LoadSectors   (lumpnum+ML_SECTORS);
-   P_LoadSideDefs  (lumpnum+ML_SIDEDEFS);
-   P_LoadLineDefs  (lumpnum+ML_LINEDEFS);
-   P_LoadSideDefs2 (lumpnum+ML_SIDEDEFS);
-   P_LoadLineDefs2 (lumpnum+ML_LINEDEFS);
-   P_LoadBlockMap  (lumpnum+ML_BLOCKMAP);
-
-   if (nodes_glbsp > 0)
-   {
-      P_LoadSubsectors(gl_lumpnum + ML_GL_SSECT);
-      P_LoadNodes(gl_lumpnum + ML_GL_NODES);
-      P_LoadGLSegs(gl_lumpnum + ML_GL_SEGS);
-   }
-   else if (nodes_zdbsp == 1)
-   {
-      P_LoadXNOD(lumpnum + ML_NODES);
-   }
-   else
-   {
-      P_LoadSubsectors(lumpnum + ML_SSECTORS);
-      P_LoadNodes(lumpnum + ML_NODES);
-      P_LoadSegs(lumpnum + ML_SEGS);
-   }
-
-   // reject loading and underflow padding separated out into new function
-   // P_GroupLines modified to return a number the underflow padding needs
-   P_LoadReject(lumpnum, P_GroupLines());
+   P_GetNodesVersion(setup.lumpnum,setup.gl_lumpnum);
 
-   // e6y
-   // Correction of desync on dv04-423.lmp/dv.wad
-   // http://www.doomworld.com/vb/showthread.php?s=&postid=627257#post627257
-   if (compatibility_level>=lxdoom_1_compatibility || M_CheckParm("-force_remove_slime_trails") > 0)
-      P_RemoveSlimeTrails();    // killough 10/98: remove slime trails from wad
-
-   // Note: you don't need to clear player queue slots --
-   // a much simpler fix is in g_game.c -- killough 10/98
+   setup.stage = ls_geometry;
+}
 
-   bodyqueslot = 0;
+//
+// P_RunSetupStage
+// Runs the current stage of the level setup and moves on to the next
+//
 
-   /* cph - reset all multiplayer starts */
-   memset(playerstarts,0,sizeof(playerstarts));
-   deathmatch_p = deathmatchstarts;
-   for (i = 0; i < MAXPLAYERS; i++)
-      players[i].mo = NULL;
+static void P_RunSetupStage(void)
+{
+   int   i;
+   int   lumpnum = setup.lumpnum;
+   int   gl_lumpnum = setup.gl_lumpnum;
 
-   P_MapStart();
+   // note: most of this ordering is important
 
-   P_LoadThings(lumpnum+ML_THINGS);
+   // killough 3/1/98: P_LoadBlockMap call moved down to below
+   // killough 4/4/98: split load of sidedefs into two parts,
+   // to allow texture names to be used in special linedefs
 
-   // if deathmatch, randomly spawn the active players
-   if (deathmatch)
+   switch (setup.stage)
    {
-      for (i=0; i<MAXPLAYERS; i++)
-         if (playeringame[i])
+      case ls_geometry:
+         if (nodes_glbsp > 0)
+            P_LoadVertexes2 (lumpnum+ML_VERTEXES,gl_lumpnum+ML_GL_VERTS);
+         else
+            P_LoadVertexes  (lumpnum+ML_VERTEXES);
+         P_LoadSectors   (lumpnum+ML_SECTORS);
+         P_LoadSideDefs  (lumpnum+ML_SIDEDEFS);
+         P_LoadLineDefs  (lumpnum+ML_LINEDEFS);
+         P_LoadSideDefs2 (lumpnum+ML_SIDEDEFS);
+         P_LoadLineDefs2 (lumpnum+ML_LINEDEFS);
+         setup.stage = ls_blockmap;
+         break;
+
+      case ls_blockmap:
+         P_LoadBlockMap  (lumpnum+ML_BLOCKMAP);
+         setup.stage = ls_bsp;
+         break;
+
+      case ls_bsp:
+         if (nodes_glbsp > 0)
          {
-            players[i].mo = NULL; // not needed? - done before P_LoadThings
-            G_DeathMatchSpawnPlayer(i);
+            P_LoadSubsectors(gl_lumpnum + ML_GL_SSECT);
+            P_LoadNodes(gl_lumpnum + ML_GL_NODES);
+            P_LoadGLSegs(gl_lumpnum + ML_GL_SEGS);
          }
-   }
-   else // if !deathmatch, check all necessary player starts actually exist
-   {
-      for (i=0; i<MAXPLAYERS; i++)
-         if (playeringame[i] && !players[i].mo)
-            I_Error("P_SetupLevel: missing player %d start\n", i+1);
-   }
+         else if (nodes_zdbsp == 1)
+         {
+            P_LoadXNOD(lumpnum + ML_NODES);
+         }
+         else
+         {
+            P_LoadSubsectors(lumpnum + ML_SSECTORS);
+            P_LoadNodes(lumpnum + ML_NODES);
+            P_LoadSegs(lumpnum + ML_SEGS);
+         }
+         setup.stage = ls_reject;
+         break;
+
+      case ls_reject:
+         // reject loading and underflow padding separated out into new function
+         // P_GroupLines modified to return a number the underflow padding needs
+         P_LoadReject(lumpnum, P_GroupLines());
+         setup.stage = ls_slimetrails;
+         break;
+
+      case ls_slimetrails:
+         // e6y
+         // Correction of desync on dv04-423.lmp/dv.wad
+         // http://www.doomworld.com/vb/showthread.php?s=&postid=627257#post627257
+         if (compatibility_level>=lxdoom_1_compatibility || M_CheckParm("-force_remove_slime_trails") > 0)
+            P_RemoveSlimeTrails();    // killough 10/98: remove slime trails from wad
+         setup.stage = ls_things;
+         break;
+
+      case ls_things:
+         // Note: you don't need to clear player queue slots --
+         // a much simpler fix is in g_game.c -- killough 10/98
+
+         bodyqueslot = 0;
+
+         /* cph - reset all multiplayer starts */
+         memset(playerstarts,0,sizeof(playerstarts));
+         deathmatch_p = deathmatchstarts;
+         for (i = 0; i < MAXPLAYERS; i++)
+            players[i].mo = NULL;
+
+         P_MapStart();
+
+         P_LoadThings(lumpnum+ML_THINGS);
+
+         // if deathmatch, randomly spawn the active players
+         if (deathmatch)
+         {
+            for (i=0; i<MAXPLAYERS; i++)
+               if (playeringame[i])
+               {
+                  players[i].mo = NULL; // not needed? - done before P_LoadThings
+                  G_DeathMatchSpawnPlayer(i);
+               }
+         }
+         else // if !deathmatch, check all necessary player starts actually exist
+         {
+            for (i=0; i<MAXPLAYERS; i++)
+               if (playeringame[i] && !players[i].mo)
+                  I_Error("P_SetupLevel: missing player %d start\n", i+1);
+         }
+
+         // killough 3/26/98: Spawn icon landings:
+         if (gamemode==commercial)
+            P_SpawnBrainTargets();
 
-   // killough 3/26/98: Spawn icon landings:
-   if (gamemode==commercial)
-      P_SpawnBrainTargets();
+         // load MUSINFO from the map, if it exists
+         U_ParseMusInfo(setup.lumpname);
 
-    // load MUSINFO from the map, if it exists
-    U_ParseMusInfo(lumpname);
+         // clear special respawning que
+         iquehead = iquetail = 0;
 
-   // clear special respawning que
-   iquehead = iquetail = 0;
+         // set up world state
+         P_SpawnSpecials();
 
-   // set up world state
-   P_SpawnSpecials();
+         P_MapEnd();
+         setup.stage = ls_precache;
+         break;
 
-   P_MapEnd();
+      case ls_precache:
+         // preload graphics
+         if (precache)
+            R_PrecacheLevel();
 
-   // preload graphics
-   if (precache)
-      R_PrecacheLevel();
+         R_SmoothPlaying_Reset(NULL); // e6y
+         setup.stage = ls_idle;
+         break;
+
+      case ls_idle:
+         break;
+   }
+}
 
-   R_SmoothPlaying_Reset(NULL); // e6y
+//
+// P_ContinueSetupLevel
+// Runs setup stages until budget_us microseconds are spent (at least one
+// stage; all of them if budget_us is negative). Returns true once the
+// level is set up.
+//
+
+dbool P_ContinueSetupLevel(int budget_us)
+{
+   int64_t start = I_GetTimeUS();
+
+   while (setup.stage != ls_idle)
+   {
+      P_RunSetupStage();
+      if (budget_us >= 0 && I_GetTimeUS() - start >= budget_us)
+         break;
+   }
+   return setup.stage == ls_idle;
+}
+
+void P_SetupLevel(int episode, int map, int playermask, skill_t skill)
+{
+   P_StartSetupLevel(episode, map, playermask, skill);
+   P_ContinueSetupLevel(-1);
 }
 
 /*
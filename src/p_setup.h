@@ -37,10 +37,17 @@
 #include "p_mobj.h"
 
 void P_SetupLevel(int episode, int map, int playermask, skill_t skill);
+/* The same, a few stages at a time: P_ContinueSetupLevel returns true
+ * once the level is set up */
+void P_StartSetupLevel(int episode, int map, int playermask, skill_t skill);
+dbool P_ContinueSetupLevel(int budget_us);
+/* The marker lump name of a map, into a buffer of 9 chars */
+void P_MapLumpName(char *lumpname, int episode, int map);
 void P_Init(void);               /* Called by startup code. */
 void P_Deinit(void);
 
 extern const uint8_t *rejectmatrix;   /* for fast sight rejection -  cph - const* */
+extern const uint8_t *builtreject;    /* built for an empty REJECT, see p_reject.c */
 
 /* killough 3/1/98: change blockmap from "short" to "long" offsets: */
 extern long     *blockmaplump;   /* offsets in blockmap are from here */
@@ -55,6 +55,68 @@ typedef struct {
 
 static los_t los; // cph - made static
 
+//
+// Sight cache
+// Monsters often repeat a BSP walk within a tic, looking at the same
+// player from the same spot. The walk only depends on the two
+// positions, the eye height and the target's height range, plus sector
+// heights, so its result is kept for the rest of the tic under those
+// values. P_ClearSightCache starts afresh each tic and whenever a
+// sector moves.
+//
+
+#define SIGHTCACHESIZE 1024       // power of two
+
+typedef struct {
+  fixed_t t1x, t1y, sightzstart;
+  fixed_t t2x, t2y, t2z, t2height;
+  unsigned stamp;                 // entry is valid if it's sightstamp
+  dbool result;
+} sightcache_t;
+
+static sightcache_t sightcache[SIGHTCACHESIZE];
+static unsigned sightstamp = 1;
+
+static struct {
+  unsigned rejects, hits, misses;
+} sightstats;
+
+static INLINE unsigned P_SightHash(const mobj_t *t1, const mobj_t *t2,
+                                   fixed_t sightzstart)
+{
+  unsigned h = (unsigned)t1->x * 0x9e3779b1u ^ (unsigned)t1->y * 0x85ebca77u ^
+               (unsigned)t2->x * 0xc2b2ae3du ^ (unsigned)t2->y * 0x27d4eb2fu ^
+               (unsigned)sightzstart ^ (unsigned)t2->z * 0x165667b1u;
+
+  return (h ^ h >> 16) & (SIGHTCACHESIZE-1);
+}
+
+void P_ClearSightCache(void)
+{
+  if (!++sightstamp)
+  {
+    memset(sightcache, 0, sizeof(sightcache));
+    sightstamp = 1;
+  }
+}
+
+//
+// P_PrintSightStats
+// Reports how P_CheckSight fared since the last call, and starts
+// counting afresh
+//
+
+void P_PrintSightStats(void)
+{
+  unsigned walks = sightstats.hits + sightstats.misses;
+
+  if (walks)
+    lprintf(LO_DEBUG, "P_PrintSightStats: %u rejected, %u BSP walks, "
+            "%u (%u%%) from the cache\n", sightstats.rejects, walks,
+            sightstats.hits, (unsigned)((uint64_t)sightstats.hits * 100 / walks));
+  memset(&sightstats, 0, sizeof(sightstats));
+}
+
 //
 // P_DivlineSide
 // Returns side 0 (front), 1 (back), or 2 (on).
@@ -259,6 +321,8 @@ dbool   P_CheckSight(mobj_t *t1, mobj_t *t2)
   const sector_t *s1 = t1->subsector->sector;
   const sector_t *s2 = t2->subsector->sector;
   int pnum = (s1-sectors)*numsectors + (s2-sectors);
+  fixed_t sightzstart;
+  sightcache_t *entry;
 
   // First check for trivial rejection.
   // Determine subsector entries in REJECT table.
@@ -266,7 +330,19 @@ dbool   P_CheckSight(mobj_t *t1, mobj_t *t2)
   // Check in REJECT table.
 
   if (rejectmatrix[pnum>>3] & (1 << (pnum&7)))   // can't possibly be connected
+  {
+    sightstats.rejects++;
     return FALSE;
+  }
+
+  // A table built at load time (p_reject.c) is left out of demos and
+  // netgames, which must go by the map's own one
+  if (builtreject && !SYNC_SENSITIVE &&
+      builtreject[pnum>>3] & (1 << (pnum&7)))
+  {
+    sightstats.rejects++;
+    return FALSE;
+  }
 
   // killough 4/19/98: make fake floors and ceilings block monster view
 
@@ -293,11 +369,23 @@ dbool   P_CheckSight(mobj_t *t1, mobj_t *t2)
   // An unobstructed LOS is possible.
   // Now look from eyes of t1 to any part of t2.
 
+  sightzstart = t1->z + t1->height - (t1->height>>2);
+  entry = &sightcache[P_SightHash(t1, t2, sightzstart)];
+  if (entry->stamp == sightstamp &&
+      entry->t1x == t1->x && entry->t1y == t1->y &&
+      entry->sightzstart == sightzstart &&
+      entry->t2x == t2->x && entry->t2y == t2->y &&
+      entry->t2z == t2->z && entry->t2height == t2->height)
+  {
+    sightstats.hits++;
+    return entry->result;
+  }
+  sightstats.misses++;
+
   validcount++;
 
   los.topslope = (los.bottomslope = t2->z - (los.sightzstart =
-                                             t1->z + t1->height -
-                                             (t1->height>>2))) + t2->height;
+                                             sightzstart)) + t2->height;
   los.strace.dx = (los.t2x = t2->x) - (los.strace.x = t1->x);
   los.strace.dy = (los.t2y = t2->y) - (los.strace.y = t1->y);
 
@@ -329,5 +417,9 @@ dbool   P_CheckSight(mobj_t *t1, mobj_t *t2)
   }
 
   // the head node is the last node output
-  return P_CrossBSPNode(numnodes-1);
+  entry->t1x = t1->x, entry->t1y = t1->y, entry->sightzstart = sightzstart;
+  entry->t2x = t2->x, entry->t2y = t2->y;
+  entry->t2z = t2->z, entry->t2height = t2->height;
+  entry->stamp = sightstamp;
+  return entry->result = P_CrossBSPNode(numnodes-1);
 }
@@ -2746,7 +2746,7 @@ void T_Scroll(scroll_t *s)
 static void Add_Scroller(int type, fixed_t dx, fixed_t dy,
                          int control, int affectee, int accel)
 {
-  scroll_t *s = Z_Malloc(sizeof *s, PU_LEVSPEC, 0);
+  scroll_t *s = P_NewThinker(tp_scroll);
   s->thinker.function = T_Scroll;
   s->type = type;
   s->dx = dx;
@@ -2891,7 +2891,7 @@ static void P_SpawnScrollers(void)
 
 static void Add_Friction(int friction, int movefactor, int affectee)
 {
-    friction_t *f = Z_Malloc(sizeof *f, PU_LEVSPEC, 0);
+    friction_t *f = P_NewThinker(tp_friction);
 
     f->thinker.function/*.acp1*/ = /*(actionf_p1) */T_Friction;
     f->friction = friction;
@@ -3123,7 +3123,7 @@ static void P_SpawnFriction(void)
 
 static void Add_Pusher(int type, int x_mag, int y_mag, mobj_t* source, int affectee)
 {
-    pusher_t *p = Z_Malloc(sizeof *p, PU_LEVSPEC, 0);
+    pusher_t *p = P_NewThinker(tp_pusher);
 
     p->thinker.function = T_Pusher;
     p->source = source;
@@ -3152,6 +3152,14 @@ static void Add_Pusher(int type, int x_mag, int y_mag, mobj_t* source, int affec
 
 pusher_t* tmpusher; // pusher structure for blockmap searches
 
+// Whether a mapblock's copy of thing is within the point pusher's radius
+static dbool PIT_PushThingReach(const blockthing_t *bt)
+{
+  return (tmpusher->magnitude -
+          ((P_AproxDistance(bt->x - tmpusher->x, bt->y - tmpusher->y)
+            >>FRACBITS)>>1))<<(FRACBITS-PUSH_FACTOR-1) > 0;
+}
+
 static dbool PIT_PushThing(mobj_t* thing)
 {
   /* killough 10/98: made more general */
@@ -3260,7 +3268,7 @@ void T_Pusher(pusher_t *p)
         yh = (tmbbox[BOXTOP] - bmaporgy + MAXRADIUS)>>MAPBLOCKSHIFT;
         for (bx=xl ; bx<=xh ; bx++)
             for (by=yl ; by<=yh ; by++)
-                P_BlockThingsIterator(bx,by,PIT_PushThing);
+                P_BlockThingsIteratorNear(bx,by,PIT_PushThingReach,PIT_PushThing);
         return;
         }
 
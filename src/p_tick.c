@@ -38,6 +38,8 @@
 #include "p_map.h"
 #include "r_fps.h"
 #include "u_musinfo.h"
+#include "z_bmalloc.h"
+#include "lprintf.h"
 
 int leveltime;
 
@@ -45,7 +47,7 @@ static dbool   newthinkerpresent;
 
 //
 // THINKERS
-// All thinkers should be allocated by Z_Malloc
+// All thinkers should be allocated by P_NewThinker
 // so they can be operated on uniformly.
 // The actual structures will vary in size,
 // but the first element must be thinker_t.
@@ -73,6 +75,50 @@ void P_InitThinkers(void)
    thinkercap.prev = thinkercap.next  = &thinkercap;
 }
 
+// Thinker pools, indexed by th_pool
+static struct block_memory_alloc_s thinkerpools[NUMTHINKERPOOLS] = {
+  { NULL, sizeof(mobj_t),        128, PU_LEVEL,   "Mobjs", NULL, 0, 0, 0 },
+  { NULL, sizeof(ceiling_t),      32, PU_LEVSPEC, "Ceilings", NULL, 0, 0, 0 },
+  { NULL, sizeof(vldoor_t),       32, PU_LEVSPEC, "Doors", NULL, 0, 0, 0 },
+  { NULL, sizeof(floormove_t),    32, PU_LEVSPEC, "Floors", NULL, 0, 0, 0 },
+  { NULL, sizeof(elevator_t),     32, PU_LEVSPEC, "Elevators", NULL, 0, 0, 0 },
+  { NULL, sizeof(plat_t),         32, PU_LEVSPEC, "Plats", NULL, 0, 0, 0 },
+  { NULL, sizeof(fireflicker_t),  32, PU_LEVSPEC, "FireFlickers", NULL, 0, 0, 0 },
+  { NULL, sizeof(lightflash_t),   32, PU_LEVSPEC, "LightFlashes", NULL, 0, 0, 0 },
+  { NULL, sizeof(strobe_t),       32, PU_LEVSPEC, "Strobes", NULL, 0, 0, 0 },
+  { NULL, sizeof(glow_t),         32, PU_LEVSPEC, "Glows", NULL, 0, 0, 0 },
+  { NULL, sizeof(scroll_t),       32, PU_LEVSPEC, "Scrollers", NULL, 0, 0, 0 },
+  { NULL, sizeof(friction_t),     32, PU_LEVSPEC, "Frictions", NULL, 0, 0, 0 },
+  { NULL, sizeof(pusher_t),       32, PU_LEVSPEC, "Pushers", NULL, 0, 0, 0 },
+};
+
+void *P_NewThinker(th_pool pool)
+{
+  return Z_BCalloc(&thinkerpools[pool]);
+}
+
+void P_FreeThinker(thinker_t *thinker)
+{
+  struct block_memory_alloc_s *pzone = Z_BZoneOf(thinker);
+
+  if (pzone < thinkerpools || pzone >= thinkerpools + NUMTHINKERPOOLS)
+    I_Error("P_FreeThinker: Free not in a thinker pool");
+  Z_BFree(pzone, thinker);
+}
+
+// The pools' memory went with the level's; print how full they got
+// and start afresh
+void P_ClearThinkerPools(void)
+{
+  int i;
+
+  for (i = 0; i < NUMTHINKERPOOLS; i++)
+  {
+    Z_BDumpStats(&thinkerpools[i]);
+    NULL_BLOCK_MEMORY_ALLOC_ZONE(thinkerpools[i]);
+  }
+}
+
 //
 // killough 8/29/98:
 //
@@ -170,7 +216,7 @@ void P_RemoveThinkerDelayed(thinker_t *thinker)
    /* Remove from current thinker class list */
    th = thinker->cnext;
    (th->cprev = thinker->cprev)->cnext = th;
-   Z_Free(thinker);
+   P_FreeThinker(thinker);
 }
 
 //
@@ -294,6 +340,7 @@ void P_Ticker (void)
 
   R_UpdateInterpolations ();
 
+  P_ClearSightCache();
   P_MapStart();
                // not if this is an intermission screen
   if(gamestate==GS_LEVEL)
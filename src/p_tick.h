@@ -47,6 +47,29 @@ void P_RemoveThinkerDelayed(thinker_t *thinker);    // killough 4/25/98
 
 void P_UpdateThinker(thinker_t *thinker);   // killough 8/29/98
 
+/* Each kind of thinker has a pool of its own, so that thinkers of a kind
+ * sit next to each other in memory while P_RunThinkers walks them */
+typedef enum {
+  tp_mobj,
+  tp_ceiling,
+  tp_door,
+  tp_floor,
+  tp_elevator,
+  tp_plat,
+  tp_fireflicker,
+  tp_lightflash,
+  tp_strobe,
+  tp_glow,
+  tp_scroll,
+  tp_friction,
+  tp_pusher,
+  NUMTHINKERPOOLS
+} th_pool;
+
+void *P_NewThinker(th_pool pool);           /* zeroed, PU_LEVEL/PU_LEVSPEC */
+void P_FreeThinker(thinker_t *thinker);
+void P_ClearThinkerPools(void);             /* after Z_FreeTags on level exit */
+
 void P_SetTarget(mobj_t **mo, mobj_t *target);   // killough 11/98
 
 /* killough 8/29/98: threads of thinkers, for more efficient searches
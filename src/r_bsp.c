@@ -41,11 +41,13 @@
 #include "v_video.h"
 #include "lprintf.h"
 
-seg_t     *curline;
+// curline and the sectors are also used by masked drawing, which can
+// run on any render thread
+R_THREADLOCAL seg_t     *curline;
 side_t    *sidedef;
 line_t    *linedef;
-sector_t  *frontsector;
-sector_t  *backsector;
+R_THREADLOCAL sector_t  *frontsector;
+R_THREADLOCAL sector_t  *backsector;
 drawseg_t *ds_p;
 
 // killough 4/7/98: indicates doors closed wrt automap bugfix:
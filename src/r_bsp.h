@@ -34,11 +34,13 @@
 #ifndef __R_BSP__
 #define __R_BSP__
 
-extern seg_t    *curline;
+#include "r_thread.h"
+
+extern R_THREADLOCAL seg_t    *curline;
 extern side_t   *sidedef;
 extern line_t   *linedef;
-extern sector_t *frontsector;
-extern sector_t *backsector;
+extern R_THREADLOCAL sector_t *frontsector;
+extern R_THREADLOCAL sector_t *backsector;
 
 /* old code -- killough:
  * extern drawseg_t drawsegs[MAXDRAWSEGS];
@@ -0,0 +1,465 @@
+/* Emacs style mode select   -*- C++ -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *  Copyright (C) 1999 by
+ *  id Software, Chi Hoang, Lee Killough, Jim Flynn, Rand Phares, Ty Halderman
+ *  Copyright (C) 1999-2000 by
+ *  Jess Haas, Nicolas Kalkhof, Colin Phipps, Florian Schulze
+ *  Copyright 2005, 2006 by
+ *  Florian Schulze, Colin Phipps, Neil Stevens, Andrey Budko
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *      Startup cache of texture definitions and sprite frames.
+ *      The tables built by R_InitTextures and R_InitSpriteDefs are
+ *      written to startup_<md5>.cache in the save directory, where
+ *      <md5> is taken over the wad files' names and sizes, the lump
+ *      directory and the TEXTURE1, TEXTURE2 and PNAMES lumps. Both
+ *      tables hold lump numbers but no pointers, so the next start with
+ *      the same wads reads the file in one go and copies them out.
+ *
+ *---------------------------------------------------------------------
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "doomstat.h"
+#include "d_main.h"
+#include "m_misc.h"
+#include "md5.h"
+#include "w_wad.h"
+#include "r_main.h"
+#include "r_data.h"
+#include "r_things.h"
+#include "r_cache.h"
+#include "lprintf.h"
+
+int r_startupcache = FALSE;
+
+#define CACHEMAGIC "PRBMSC01"
+#define CACHEBYTEORDER 0x01020304
+
+// Sections start, and texture records are padded, to 8 bytes
+#define CACHE_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+typedef struct
+{
+  char     magic[8];              // CACHEMAGIC
+  uint32_t byteorder;             // CACHEBYTEORDER, as written
+  uint32_t texturesize;           // sizeof(texture_t)
+  uint32_t patchsize;             // sizeof(texpatch_t)
+  uint32_t framesize;             // sizeof(spriteframe_t)
+  uint32_t numlumps;
+  uint8_t  wadkey[16];            // MD5 of the wads, as in the file name
+  uint8_t  spritekey[16];         // MD5 of the sprite names
+  uint32_t numtextures;
+  uint32_t texturebytes;          // offsets[numtextures], then records
+  uint32_t numsprites;
+  uint32_t spritebytes;           // numframes[numsprites], then frames
+} cacheheader_t;
+
+static char *cachename;
+static uint8_t wadkey[16];
+
+// The file as read, until R_CloseStartupCache
+static uint8_t *cachedata;
+
+// Sections to write back, each either in cachedata or malloced
+static const uint8_t *texturesection, *spritesection;
+static size_t texturebytes, spritebytes;
+static dbool texturesbuilt, spritesbuilt;
+static uint8_t spritekey[16];
+
+static void R_SpriteNamesKey(const char * const *namelist, uint8_t key[16])
+{
+  struct MD5Context md5;
+  int i;
+
+  MD5Init(&md5);
+  for (i = 0; namelist[i]; i++)
+    MD5Update(&md5, (const md5byte *) namelist[i], strlen(namelist[i]) + 1);
+  MD5Final(key, &md5);
+}
+
+static size_t R_TextureRecordSize(const texture_t *texture)
+{
+  return CACHE_ALIGN(sizeof(texture_t) +
+                     sizeof(texpatch_t)*(texture->patchcount-1));
+}
+
+// Lumps the texture definitions are built from, hashed whole, so an
+// edited wad that keeps its layout still gets a new key
+static const char *const keylumps[] = { "TEXTURE1", "TEXTURE2", "PNAMES" };
+
+//
+// R_OpenStartupCache
+// Hashes the lump directory and the texture definitions into the
+// cache key, and reads the matching cache file if there's a valid one.
+//
+
+void R_OpenStartupCache(void)
+{
+  struct MD5Context md5;
+  const cacheheader_t *header;
+  char hex[33];
+  int length, i;
+#ifdef _WIN32
+  char slash = '\\';
+#else
+  char slash = '/';
+#endif
+
+  texturesection = spritesection = NULL;
+  texturesbuilt = spritesbuilt = FALSE;
+  free(cachename);
+  cachename = NULL;
+
+  if (!r_startupcache || !*basesavegame)
+    return;
+
+  // The files and where every lump is in them, and the contents of the
+  // texture lumps; reading every lump would cost more than building
+  // the tables does
+  MD5Init(&md5);
+  for (i = 0; (size_t) i < numwadfiles; i++)
+  {
+    int64_t size = wadfiles[i].handle ? filestream_get_size(wadfiles[i].handle) : -1;
+
+    MD5Update(&md5, (const md5byte *) wadfiles[i].name, strlen(wadfiles[i].name) + 1);
+    MD5Update(&md5, (const md5byte *) &size, sizeof(size));
+  }
+  for (i = 0; i < numlumps; i++)
+  {
+    const lumpinfo_t *lump = &lumpinfo[i];
+    int32_t fields[4];
+
+    fields[0] = lump->size;
+    fields[1] = lump->position;
+    fields[2] = lump->li_namespace;
+    fields[3] = lump->wadfile ? lump->wadfile - wadfiles : -1;
+    MD5Update(&md5, (const md5byte *) lump->name, 8);
+    MD5Update(&md5, (const md5byte *) fields, sizeof(fields));
+  }
+  for (i = 0; i < (int) (sizeof(keylumps)/sizeof(*keylumps)); i++)
+  {
+    int lump = W_CheckNumForName(keylumps[i]);
+
+    if (lump >= 0)
+    {
+      MD5Update(&md5, W_CacheLumpNum(lump), W_LumpLength(lump));
+      W_UnlockLumpNum(lump);
+    }
+  }
+  MD5Final(wadkey, &md5);
+
+  for (i = 0; i < 16; i++)
+    sprintf(hex + i*2, "%02x", wadkey[i]);
+  cachename = malloc(strlen(basesavegame) + 48);
+  sprintf(cachename, "%s%cstartup_%s.cache", basesavegame, slash, hex);
+
+  length = M_ReadFile(cachename, &cachedata);
+  if (length < 0)
+  {
+    cachedata = NULL;
+    return;
+  }
+
+  header = (const cacheheader_t *) cachedata;
+  if ((size_t) length < sizeof(*header) ||
+      memcmp(header->magic, CACHEMAGIC, 8) ||
+      header->byteorder != CACHEBYTEORDER ||
+      header->texturesize != sizeof(texture_t) ||
+      header->patchsize != sizeof(texpatch_t) ||
+      header->framesize != sizeof(spriteframe_t) ||
+      header->numlumps != (uint32_t) numlumps ||
+      memcmp(header->wadkey, wadkey, 16) ||
+      CACHE_ALIGN(sizeof(*header)) + CACHE_ALIGN(header->texturebytes) +
+      header->spritebytes != (size_t) length)
+  {
+    lprintf(LO_WARN, "R_OpenStartupCache: ignoring invalid %s\n", cachename);
+    free(cachedata);
+    cachedata = NULL;
+    return;
+  }
+
+  lprintf(LO_INFO, "R_OpenStartupCache: %s\n", cachename);
+}
+
+//
+// R_LoadCachedTextures
+// Copies the texture records out of the cache and points textures[]
+// at them, after checking they and the patch lump numbers in them are
+// in range.
+//
+
+dbool R_LoadCachedTextures(void)
+{
+  const cacheheader_t *header = (const cacheheader_t *) cachedata;
+  const uint8_t *section;
+  const uint32_t *offsets;
+  uint8_t *records;
+  size_t bytes;
+  int count, i, j;
+
+  if (!cachedata || !header->numtextures)
+    return FALSE;
+
+  section = cachedata + CACHE_ALIGN(sizeof(*header));
+  offsets = (const uint32_t *) section;
+  bytes = header->texturebytes;
+  count = header->numtextures;
+
+  if ((size_t) count > bytes / sizeof(*offsets))
+    return FALSE;
+
+  for (i = 0; i < count; i++)
+  {
+    const texture_t *texture = (const texture_t *) (section + offsets[i]);
+
+    if (offsets[i] < count * sizeof(*offsets) || offsets[i] & 7 ||
+        offsets[i] + offsetof(texture_t, patches) > bytes ||
+        texture->patchcount < 0 ||
+        offsets[i] + R_TextureRecordSize(texture) > bytes)
+      return FALSE;
+    for (j = 0; j < texture->patchcount; j++)
+      if ((unsigned) texture->patches[j].patch >= (unsigned) numlumps)
+        return FALSE;
+  }
+
+  numtextures = count;
+  textures = Z_Malloc(numtextures * sizeof(*textures), PU_STATIC, 0);
+  textureheight = Z_Malloc(numtextures * sizeof(*textureheight), PU_STATIC, 0);
+  records = Z_Malloc(bytes, PU_STATIC, 0);
+  memcpy(records, section, bytes);
+
+  for (i = 0; i < numtextures; i++)
+  {
+    textures[i] = (texture_t *) (records + offsets[i]);
+    textureheight[i] = textures[i]->height<<FRACBITS;
+  }
+
+  texturesection = section;
+  texturebytes = bytes;
+  return TRUE;
+}
+
+//
+// R_CacheTextures
+// Packs the textures built by R_InitTextures into a section
+//
+
+void R_CacheTextures(void)
+{
+  uint32_t *offsets;
+  uint8_t *section;
+  size_t bytes;
+  int i;
+
+  if (!cachename)
+    return;
+
+  bytes = CACHE_ALIGN(numtextures * sizeof(*offsets));
+  for (i = 0; i < numtextures; i++)
+    bytes += R_TextureRecordSize(textures[i]);
+
+  section = malloc(bytes);
+  memset(section, 0, bytes);
+  offsets = (uint32_t *) section;
+
+  bytes = CACHE_ALIGN(numtextures * sizeof(*offsets));
+  for (i = 0; i < numtextures; i++)
+  {
+    size_t size = R_TextureRecordSize(textures[i]);
+
+    offsets[i] = bytes;
+    memcpy(section + bytes, textures[i], sizeof(texture_t) +
+           sizeof(texpatch_t)*(textures[i]->patchcount-1));
+    bytes += size;
+  }
+
+  texturesection = section;
+  texturebytes = bytes;
+  texturesbuilt = TRUE;
+}
+
+//
+// R_LoadCachedSprites
+// Copies the sprite frames out of the cache, if it was made for the
+// same sprite names.
+//
+
+dbool R_LoadCachedSprites(const char * const *namelist)
+{
+  const cacheheader_t *header = (const cacheheader_t *) cachedata;
+  const uint8_t *section;
+  const int32_t *numframes;
+  spriteframe_t *frames;
+  size_t bytes, total;
+  int count, i, j, r;
+
+  if (!cachename)
+    return FALSE;
+
+  R_SpriteNamesKey(namelist, spritekey);
+  if (!cachedata || memcmp(header->spritekey, spritekey, 16))
+    return FALSE;
+
+  for (count = 0; namelist[count]; count++)
+    ;
+  if ((uint32_t) count != header->numsprites)
+    return FALSE;
+
+  section = cachedata + CACHE_ALIGN(sizeof(*header)) +
+            CACHE_ALIGN(header->texturebytes);
+  numframes = (const int32_t *) section;
+  bytes = header->spritebytes;
+  if ((size_t) count > bytes / sizeof(*numframes))
+    return FALSE;
+
+  frames = (spriteframe_t *) (section + CACHE_ALIGN(count * sizeof(*numframes)));
+  total = 0;
+  for (i = 0; i < count; i++)
+  {
+    if (numframes[i] < 0)
+      return FALSE;
+    total += numframes[i];
+  }
+  if (CACHE_ALIGN(count * sizeof(*numframes)) +
+      total * sizeof(spriteframe_t) != bytes)
+    return FALSE;
+
+  for (i = 0; (size_t) i < total; i++)
+    for (r = 0; r < 8; r++)
+      if (frames[i].lump[r] < -1 || frames[i].lump[r] >= numspritelumps)
+        return FALSE;
+
+  numsprites = count;
+  sprites = Z_Malloc(numsprites * sizeof(*sprites), PU_STATIC, NULL);
+  if (total)
+  {
+    spriteframe_t *copy = Z_Malloc(total * sizeof(*copy), PU_STATIC, NULL);
+
+    memcpy(copy, frames, total * sizeof(*copy));
+    frames = copy;
+  }
+  for (i = 0, j = 0; i < numsprites; j += numframes[i++])
+  {
+    sprites[i].numframes = numframes[i];
+    sprites[i].spriteframes = numframes[i] ? frames + j : NULL;
+  }
+
+  spritesection = section;
+  spritebytes = bytes;
+  return TRUE;
+}
+
+//
+// R_CacheSprites
+// Packs the sprite frames built by R_InitSpriteDefs into a section
+//
+
+void R_CacheSprites(const char * const *namelist)
+{
+  int32_t *numframes;
+  uint8_t *section;
+  spriteframe_t *frames;
+  size_t bytes;
+  int total, i;
+
+  if (!cachename)
+    return;
+
+  for (i = 0, total = 0; i < numsprites; i++)
+    total += sprites[i].numframes;
+
+  bytes = CACHE_ALIGN(numsprites * sizeof(*numframes)) +
+          total * sizeof(spriteframe_t);
+  section = malloc(bytes);
+  memset(section, 0, bytes);
+  numframes = (int32_t *) section;
+  frames = (spriteframe_t *) (section +
+                              CACHE_ALIGN(numsprites * sizeof(*numframes)));
+
+  for (i = 0; i < numsprites; i++)
+  {
+    numframes[i] = sprites[i].numframes;
+    memcpy(frames, sprites[i].spriteframes,
+           numframes[i] * sizeof(spriteframe_t));
+    frames += numframes[i];
+  }
+
+  R_SpriteNamesKey(namelist, spritekey);
+  spritesection = section;
+  spritebytes = bytes;
+  spritesbuilt = TRUE;
+}
+
+//
+// R_CloseStartupCache
+// Writes the cache file if either table had to be built, and frees
+// what isn't in use any more.
+//
+
+void R_CloseStartupCache(void)
+{
+  if (cachename && (texturesbuilt || spritesbuilt) &&
+      texturesection && spritesection)
+  {
+    size_t tableoffset = CACHE_ALIGN(sizeof(cacheheader_t));
+    size_t spriteoffset = tableoffset + CACHE_ALIGN(texturebytes);
+    size_t length = spriteoffset + spritebytes;
+    uint8_t *buffer = malloc(length);
+    cacheheader_t *header = (cacheheader_t *) buffer;
+
+    memset(buffer, 0, length);
+    memcpy(header->magic, CACHEMAGIC, 8);
+    header->byteorder = CACHEBYTEORDER;
+    header->texturesize = sizeof(texture_t);
+    header->patchsize = sizeof(texpatch_t);
+    header->framesize = sizeof(spriteframe_t);
+    header->numlumps = numlumps;
+    memcpy(header->wadkey, wadkey, 16);
+    memcpy(header->spritekey, spritekey, 16);
+    header->numtextures = numtextures;
+    header->texturebytes = texturebytes;
+    header->numsprites = numsprites;
+    header->spritebytes = spritebytes;
+    memcpy(buffer + tableoffset, texturesection, texturebytes);
+    memcpy(buffer + spriteoffset, spritesection, spritebytes);
+
+    if (M_WriteFile(cachename, buffer, length))
+      lprintf(LO_INFO, "R_CloseStartupCache: wrote %s\n", cachename);
+    else
+      lprintf(LO_WARN, "R_CloseStartupCache: couldn't write %s\n", cachename);
+    free(buffer);
+  }
+
+  if (texturesbuilt)
+    free((void *) texturesection);
+  if (spritesbuilt)
+    free((void *) spritesection);
+  texturesection = spritesection = NULL;
+  texturesbuilt = spritesbuilt = FALSE;
+
+  free(cachedata);
+  cachedata = NULL;
+}
@@ -0,0 +1,58 @@
+/* Emacs style mode select   -*- C++ -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *  Copyright (C) 1999 by
+ *  id Software, Chi Hoang, Lee Killough, Jim Flynn, Rand Phares, Ty Halderman
+ *  Copyright (C) 1999-2000 by
+ *  Jess Haas, Nicolas Kalkhof, Colin Phipps, Florian Schulze
+ *  Copyright 2005, 2006 by
+ *  Florian Schulze, Colin Phipps, Neil Stevens, Andrey Budko
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *      Startup cache of texture definitions and sprite frames
+ *
+ *---------------------------------------------------------------------
+ */
+
+#ifndef __R_CACHE__
+#define __R_CACHE__
+
+#include "doomtype.h"
+
+/* Whether the startup cache is read and written (core option) */
+extern int r_startupcache;
+
+/* Reads the cache file for the loaded wads, if there's one. Called
+ * before R_InitData, once the wads are loaded */
+void R_OpenStartupCache(void);
+
+/* Fill in textures/sprites from the cache, returning false if they
+ * have to be built (and then stored with R_CacheTextures/Sprites) */
+dbool R_LoadCachedTextures(void);
+dbool R_LoadCachedSprites(const char * const *namelist);
+
+void R_CacheTextures(void);
+void R_CacheSprites(const char * const *namelist);
+
+/* Writes the cache file back if anything had to be built */
+void R_CloseStartupCache(void);
+
+#endif
@@ -42,6 +42,8 @@
 #include "r_bsp.h"
 #include "r_things.h"
 #include "p_tick.h"
+#include "r_cache.h"
+#include "p_setup.h"
 #include "lprintf.h"  // jff 08/03/98 - declaration of lprintf
 #include "p_tick.h"
 
@@ -262,25 +264,35 @@ static void R_InitTextures (void)
   if (errors)
     I_Error("R_InitTextures: %d errors", errors);
 
-  // Create translation table for global animation.
-
-  texturetranslation =
-    Z_Malloc((numtextures+1) * sizeof(*texturetranslation), PU_STATIC, 0);
-
-  for (i=0 ; i<numtextures ; i++)
-    texturetranslation[i] = i;
-
   // killough 1/31/98: Initialize texture hash table
   for (i = 0; i<numtextures; i++)
+  {
     textures[i]->index = -1;
+    textures[i]->key = W_LumpNameKey(textures[i]->name);
+  }
   while (--i >= 0)
     {
-      int j = W_LumpNameHash(textures[i]->name) % (unsigned) numtextures;
+      int j = W_LumpKeyHash(textures[i]->key) % (unsigned) numtextures;
       textures[i]->next = textures[j]->index;   // Prepend to chain
       textures[j]->index = i;
     }
 }
 
+//
+// R_InitTextureTranslation
+// Create translation table for global animation.
+//
+static void R_InitTextureTranslation(void)
+{
+  int i;
+
+  texturetranslation =
+    Z_Malloc((numtextures+1) * sizeof(*texturetranslation), PU_STATIC, 0);
+
+  for (i=0 ; i<numtextures ; i++)
+    texturetranslation[i] = i;
+}
+
 //
 // R_InitFlats
 //
@@ -408,7 +420,13 @@ const lighttable_t* R_ColourMap(int lightlevel, fixed_t spryscale)
 void R_InitData(void)
 {
   lprintf(LO_INFO, "Textures\n");
-  R_InitTextures();
+  R_OpenStartupCache();
+  if (!R_LoadCachedTextures())
+  {
+    R_InitTextures();
+    R_CacheTextures();
+  }
+  R_InitTextureTranslation();
   lprintf(LO_INFO, "Flats\n");
   R_InitFlats();
   lprintf(LO_INFO, "Sprites\n");
@@ -449,8 +467,9 @@ int R_CheckTextureNumForName(const char *name)
   int i = NO_TEXTURE;
   if (*name != '-')     // "NoTexture" marker.
     {
-      i = textures[W_LumpNameHash(name) % (unsigned) numtextures]->index;
-      while (i >= 0 && strncasecmp(textures[i]->name,name,8))
+      uint64_t key = W_LumpNameKey(name);
+      i = textures[W_LumpKeyHash(key) % (unsigned) numtextures]->index;
+      while (i >= 0 && textures[i]->key != key)
         i = textures[i]->next;
     }
   return i;
@@ -573,6 +592,249 @@ void R_PrecacheLevel(void)
   Z_Free(hitlist);
 }
 
+//
+// Next level prefetch
+//
+// Once the intermission knows the next map, its lumps, the composites of
+// the textures its sidedefs name, its flats and the spawn frames of its
+// things are read into the cache a few at a time, within
+// PREFETCH_BUDGET_US per tic, so the level starts without a stall.
+// Anything not fetched when the level starts is loaded as needed.
+//
+
+int r_prefetch = TRUE;
+
+#define PREFETCH_BUDGET_US 2000
+
+typedef enum {
+  pf_lump,        // read a lump into the cache
+  pf_sidedefs,    // SIDEDEFS lump: queue the textures it names
+  pf_sectors,     // SECTORS lump: queue the flats it names
+  pf_things,      // THINGS lump: queue the spawn sprites of its things
+  pf_texture,     // build a composite texture
+  pf_patch        // build a patch, for sprite frames
+} prefetch_e;
+
+typedef struct {
+  prefetch_e kind;
+  int num;
+} prefetch_t;
+
+static prefetch_t *prefetch;
+static int prefetchcount, prefetchalloc, prefetchnext;
+static uint8_t *prefetchhits;   // textures, flats and sprites already queued
+
+static void R_QueuePrefetch(prefetch_e kind, int num)
+{
+  // nothing to read for a lump used straight from the wad
+  if (kind == pf_lump && W_LumpInPlace(num))
+    return;
+
+  if (prefetchcount == prefetchalloc)
+  {
+    prefetchalloc = prefetchalloc ? prefetchalloc*2 : 128;
+    prefetch = realloc(prefetch, prefetchalloc * sizeof(*prefetch));
+  }
+  prefetch[prefetchcount].kind = kind;
+  prefetch[prefetchcount++].num = num;
+}
+
+static void R_QueuePrefetchTexture(int texture)
+{
+  if (texture > 0 && !prefetchhits[texture])
+  {
+    prefetchhits[texture] = 1;
+    R_QueuePrefetch(pf_texture, texture);
+  }
+}
+
+static void R_QueuePrefetchFlat(const char *name)
+{
+  int flat = (W_CheckNumForName)(name, ns_flats) - firstflat;
+
+  if (flat >= 0 && flat < numflats && !prefetchhits[numtextures + flat])
+  {
+    prefetchhits[numtextures + flat] = 1;
+    R_QueuePrefetch(pf_lump, firstflat + flat);
+  }
+}
+
+static void R_QueuePrefetchSprite(int sprite)
+{
+  int j, k, last = -1;
+
+  if (sprite < 0 || sprite >= numsprites ||
+      prefetchhits[numtextures + numflats + sprite])
+    return;
+  prefetchhits[numtextures + numflats + sprite] = 1;
+
+  for (j = 0; j < sprites[sprite].numframes; j++)
+    for (k = 0; k < 8; k++)
+    {
+      int lump = sprites[sprite].spriteframes[j].lump[k];
+
+      if (lump >= 0 && lump != last)
+        R_QueuePrefetch(pf_patch, firstspritelump + (last = lump));
+    }
+}
+
+static void R_PrefetchItem(prefetch_t item)
+{
+  const uint8_t *data;
+  int i, count;
+
+  switch (item.kind)
+  {
+    case pf_lump:
+      precache_lump(item.num);
+      break;
+
+    case pf_sidedefs:
+      data = W_CacheLumpNum(item.num);
+      count = W_LumpLength(item.num) / sizeof(mapsidedef_t);
+      for (i = 0; i < count; i++)
+      {
+        const mapsidedef_t *msd = (const mapsidedef_t *) data + i;
+        R_QueuePrefetchTexture(R_CheckTextureNumForName(msd->toptexture));
+        R_QueuePrefetchTexture(R_CheckTextureNumForName(msd->bottomtexture));
+        R_QueuePrefetchTexture(R_CheckTextureNumForName(msd->midtexture));
+      }
+      W_UnlockLumpNum(item.num);
+      break;
+
+    case pf_sectors:
+      data = W_CacheLumpNum(item.num);
+      count = W_LumpLength(item.num) / sizeof(mapsector_t);
+      for (i = 0; i < count; i++)
+      {
+        const mapsector_t *ms = (const mapsector_t *) data + i;
+        R_QueuePrefetchFlat(ms->floorpic);
+        R_QueuePrefetchFlat(ms->ceilingpic);
+      }
+      W_UnlockLumpNum(item.num);
+      break;
+
+    case pf_things:
+      {
+        // doomednums present in the map, one bit each
+        uint8_t types[65536/8];
+
+        memset(types, 0, sizeof(types));
+        data = W_CacheLumpNum(item.num);
+        count = W_LumpLength(item.num) / sizeof(mapthing_t);
+        for (i = 0; i < count; i++)
+        {
+          unsigned short type = SHORT(((const mapthing_t *) data)[i].type);
+          types[type >> 3] |= 1 << (type & 7);
+        }
+        W_UnlockLumpNum(item.num);
+
+        for (i = 0; i < NUMMOBJTYPES; i++)
+        {
+          int type = mobjinfo[i].doomednum;
+          if (type >= 0 && type < 65536 && types[type >> 3] & (1 << (type & 7)))
+            R_QueuePrefetchSprite(states[mobjinfo[i].spawnstate].sprite);
+        }
+      }
+      break;
+
+    case pf_texture:
+      R_CacheTextureCompositePatchNum(item.num);
+      R_UnlockTextureCompositePatchNum(item.num);
+      break;
+
+    case pf_patch:
+      R_CachePatchNum(item.num);
+      R_UnlockPatchNum(item.num);
+      break;
+  }
+}
+
+//
+// R_StartPrefetch
+// Queues the next map's lumps, and the sky it will use. The episode and
+// map are the ones G_DoCompleted picked for the intermission, following
+// UMAPINFO's nextmap/nextsecret where there is one, and are named the way
+// P_SetupLevel will look them up.
+//
+
+void R_StartPrefetch(int episode, int map, int sky)
+{
+  static const char *const maplumps[] = {
+    "THINGS", "LINEDEFS", "SIDEDEFS", "VERTEXES", "SEGS",
+    "SSECTORS", "NODES", "SECTORS", "REJECT", "BLOCKMAP"
+  };
+  char lumpname[9];
+  int lumpnum, i;
+
+  R_StopPrefetch();
+
+  if (!r_prefetch)
+    return;
+
+  P_MapLumpName(lumpname, episode, map);
+  if ((lumpnum = W_CheckNumForName(lumpname)) == -1)
+    return;
+
+  prefetchhits = malloc(numtextures + numflats + numsprites);
+  memset(prefetchhits, 0, numtextures + numflats + numsprites);
+
+  for (i = ML_THINGS; i <= ML_BLOCKMAP; i++)
+  {
+    int lump = lumpnum + i;
+
+    if (lump >= numlumps || strncasecmp(lumpinfo[lump].name, maplumps[i-ML_THINGS], 8))
+      break;
+    R_QueuePrefetch(i == ML_SIDEDEFS ? pf_sidedefs :
+                    i == ML_SECTORS ? pf_sectors :
+                    i == ML_THINGS ? pf_things : pf_lump, lump);
+  }
+
+  if (sky >= 0 && sky < numtextures)
+    R_QueuePrefetchTexture(sky);
+}
+
+//
+// R_PrefetchTic
+// Fetches queued items until the tic's time budget is spent
+//
+
+void R_PrefetchTic(void)
+{
+  int64_t start;
+
+  if (prefetchnext >= prefetchcount)
+    return;
+
+  start = I_GetTimeUS();
+  do
+    R_PrefetchItem(prefetch[prefetchnext++]);
+  while (prefetchnext < prefetchcount &&
+         I_GetTimeUS() - start < PREFETCH_BUDGET_US);
+
+  if (prefetchnext == prefetchcount)
+    lprintf(LO_DEBUG, "R_PrefetchTic: next level fetched, %d items\n",
+            prefetchcount);
+}
+
+//
+// R_StopPrefetch
+// Drops whatever is still queued, when a level starts
+//
+
+void R_StopPrefetch(void)
+{
+  if (prefetchnext < prefetchcount)
+    lprintf(LO_DEBUG, "R_StopPrefetch: %d of %d items not fetched\n",
+            prefetchcount - prefetchnext, prefetchcount);
+
+  free(prefetch);
+  free(prefetchhits);
+  prefetch = NULL;
+  prefetchhits = NULL;
+  prefetchcount = prefetchalloc = prefetchnext = 0;
+}
+
 // Proff - Added for OpenGL
 void R_SetPatchNum(patchnum_t *patchnum, const char *name)
 {
@@ -58,6 +58,7 @@ typedef struct
 {
   char  name[8];         // Keep name for switch changing, etc.
   int   next, index;     // killough 1/31/98: used in hashing algorithm
+  uint64_t key;          // name packed by W_LumpNameKey
   // CPhipps - moved arrays with per-texture entries to elements here
   unsigned  widthmask;
   // CPhipps - end of additions
@@ -77,6 +78,12 @@ const uint8_t *R_GetTextureColumn(const rpatch_t *texpatch, int col);
 void R_InitData (void);
 void R_PrecacheLevel (void);
 
+// Prefetch of the next level during the intermission
+extern int r_prefetch;
+void R_StartPrefetch(int episode, int map, int sky);
+void R_PrefetchTic(void);
+void R_StopPrefetch(void);
+
 
 // Retrieval.
 // Floor/ceiling opaque texture tiles,
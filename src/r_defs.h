@@ -131,6 +131,10 @@ typedef struct
   int linecount;
   struct line_s **lines;
 
+  // two-sided lines out of the sector, for P_NoiseAlert
+  int edgecount;
+  struct sectoredge_s *edges;
+
   // killough 10/98: support skies coming from sidedefs. Allows scrolling
   // skies and other effects. No "level info" kind of lump is needed,
   // because you can use an arbitrary number of skies per level with this
@@ -155,6 +159,13 @@ typedef struct
   short tag;
 } sector_t;
 
+// A two-sided line and the sector on its other side (P_GroupLines)
+typedef struct sectoredge_s
+{
+  struct line_s *line;
+  sector_t *other;
+} sectoredge_t;
+
 //
 // The SideDef.
 //
@@ -413,11 +424,10 @@ typedef struct visplane
   int picnum, lightlevel, minx, maxx;
   fixed_t height;
   fixed_t xoffs, yoffs;         // killough 2/28/98: Support scrolling flats
-  unsigned int pad1;          // leave pads for [minx-1]/[maxx+1]
-  unsigned int top[MAX_SCREENWIDTH];
-  unsigned int pad2, pad3;    // killough 2/8/98, 4/25/98
-  unsigned int bottom[MAX_SCREENWIDTH];
-  unsigned int pad4; // dropoff overflow
+  // viewwidth columns each, from the per-frame plane arena in r_plane.c;
+  // [minx-1] and [maxx+1] are valid pads on both arrays
+  unsigned int *top;
+  unsigned int *bottom;         // dropoff overflow
 } visplane_t;
 
 #endif
@@ -42,6 +42,7 @@
 #include "st_stuff.h"
 #include "g_game.h"
 #include "am_map.h"
+#include "r_thread.h"
 #include "lprintf.h"
 
 //
@@ -79,14 +80,28 @@ typedef enum
    COL_FLEXADD
 } columntype_e;
 
-static int    temp_x = 0;
-static int    tempyl[4], tempyh[4];
-static uint16_t short_tempbuf[MAX_SCREENHEIGHT * 4];
-static int    startx = 0;
-static int    temptype = COL_NONE;
-static int    commontop, commonbot;
+// Adjacent columns are drawn into a temp buffer first and written out
+// together, so the rows they have in common can be copied a whole row
+// of the batch at a time. TEMPBUF_BITS sets the batch width as a power
+// of 2; 8 columns of 16 bit pixels make each such row one 16 byte store.
+#ifndef TEMPBUF_BITS
+#define TEMPBUF_BITS 3
+#endif
+#define TEMPBUF_WIDTH (1 << TEMPBUF_BITS)
+
+// Columns batched before a flush. Only ever lowered to time narrower
+// batches against the full one (see D_BenchKernels).
+static int tempbuf_batch = TEMPBUF_WIDTH;
+
+// Each render thread batches its own columns (see r_thread.c)
+static R_THREADLOCAL int    temp_x = 0;
+static R_THREADLOCAL int    tempyl[TEMPBUF_WIDTH], tempyh[TEMPBUF_WIDTH];
+static R_THREADLOCAL uint16_t short_tempbuf[MAX_SCREENHEIGHT * TEMPBUF_WIDTH];
+static R_THREADLOCAL int    startx = 0;
+static R_THREADLOCAL int    temptype = COL_NONE;
+static R_THREADLOCAL int    commontop, commonbot;
 // SoM 7-28-04: Fix the fuzz problem.
-static const uint8_t   *tempfuzzmap;
+static R_THREADLOCAL const uint8_t   *tempfuzzmap;
 
 //
 // Spectre/Invisibility.
@@ -107,6 +122,9 @@ static const int fuzzoffset_org[FUZZTABLE] = {
 
 static int fuzzoffset[FUZZTABLE];
 
+// Not per thread: the masked pass is drawn serially when it has fuzz in
+// it (see R_MaskedFuzz), so the pattern is the same with any number of
+// render threads
 static int fuzzpos = 0;
 
 // render pipelines
@@ -152,23 +170,23 @@ static void R_FlushHTError(void)
    I_Error("R_FlushHTColumns called without being initialized.\n");
 }
 
-static void R_QuadFlushError(void)
+static void R_FlushCommonError(void)
 {
-   I_Error("R_FlushQuadColumn called without being initialized.\n");
+   I_Error("R_FlushCommonColumns called without being initialized.\n");
 }
 
-static void (*R_FlushWholeColumns)(void) = R_FlushWholeError;
-static void (*R_FlushHTColumns)(void)    = R_FlushHTError;
-static void (*R_FlushQuadColumn)(void) = R_QuadFlushError;
+static R_THREADLOCAL void (*R_FlushWholeColumns)(void) = R_FlushWholeError;
+static R_THREADLOCAL void (*R_FlushHTColumns)(void)    = R_FlushHTError;
+static R_THREADLOCAL void (*R_FlushCommonColumns)(void) = R_FlushCommonError;
 
 static void R_FlushColumns(void)
 {
-   if(temp_x != 4 || commontop >= commonbot)
+   if(temp_x < 2 || commontop >= commonbot)
       R_FlushWholeColumns();
    else
    {
       R_FlushHTColumns();
-      R_FlushQuadColumn();
+      R_FlushCommonColumns();
    }
    temp_x = 0;
 }
@@ -189,14 +207,27 @@ void R_ResetColumnBuffer(void)
    temptype            = COL_NONE;
    R_FlushWholeColumns = R_FlushWholeError;
    R_FlushHTColumns    = R_FlushHTError;
-   R_FlushQuadColumn   = R_QuadFlushError;
+   R_FlushCommonColumns = R_FlushCommonError;
+}
+
+//
+// R_SetColumnBatch
+//
+// Sets how many adjacent columns are batched before they are written
+// out, and returns how many will be: no more than TEMPBUF_WIDTH.
+//
+int R_SetColumnBatch(int columns)
+{
+   R_ResetColumnBuffer();
+   tempbuf_batch = columns < 1 ? 1 : columns > TEMPBUF_WIDTH ? TEMPBUF_WIDTH : columns;
+   return tempbuf_batch;
 }
 
 /*
  * R_FlushWhole16
  *
  * Flushes the entire columns in the buffer, one at a time.
- * This is used when a quad flush isn't possible.
+ * This is used when the columns have no rows in common.
  * Opaque version -- no remapping whatsoever.
 */
 static void R_FlushWhole16(void)
@@ -204,14 +235,14 @@ static void R_FlushWhole16(void)
    while(--temp_x >= 0)
    {
       int yl           = tempyl[temp_x];
-      uint16_t *source = &short_tempbuf[temp_x + (yl << 2)];
+      uint16_t *source = &short_tempbuf[temp_x + (yl << TEMPBUF_BITS)];
       uint16_t *dest   = drawvars.short_topleft + yl * SURFACE_SHORT_PITCH + startx + temp_x;
       int   count      = tempyh[temp_x] - yl + 1;
       
       while(--count >= 0)
       {
          *dest   = *source;
-         source += 4;
+         source += TEMPBUF_WIDTH;
          dest   += SURFACE_SHORT_PITCH;
       }
    }
@@ -221,7 +252,7 @@ static void R_FlushWhole16(void)
 // R_FlushHT16
 //
 // Flushes the head and tail of columns in the buffer in
-// preparation for a quad flush.
+// preparation for a common span flush.
 // Opaque version -- no remapping whatsoever.
 //
 static void R_FlushHT16(void)
@@ -231,7 +262,7 @@ static void R_FlushHT16(void)
    int count, colnum = 0;
    int yl, yh;
 
-   while(colnum < 4)
+   while(colnum < temp_x)
    {
       yl = tempyl[colnum];
       yh = tempyh[colnum];
@@ -239,14 +270,14 @@ static void R_FlushHT16(void)
       // flush column head
       if(yl < commontop)
       {
-         source = &short_tempbuf[colnum + (yl << 2)];
+         source = &short_tempbuf[colnum + (yl << TEMPBUF_BITS)];
          dest   = drawvars.short_topleft + yl * SURFACE_SHORT_PITCH + startx + colnum;
          count  = commontop - yl;
          
          while(--count >= 0)
          {
             *dest = *source;
-            source += 4;
+            source += TEMPBUF_WIDTH;
             dest += SURFACE_SHORT_PITCH;
          }
       }
@@ -254,7 +285,7 @@ static void R_FlushHT16(void)
       // flush column tail
       if(yh > commonbot)
       {
-         source = &short_tempbuf[colnum + ((commonbot + 1) << 2)];
+         source = &short_tempbuf[colnum + ((commonbot + 1) << TEMPBUF_BITS)];
          dest   = drawvars.short_topleft + (commonbot + 1) * SURFACE_SHORT_PITCH + startx + colnum;
          count  = yh - commonbot;
          
@@ -262,7 +293,7 @@ static void R_FlushHT16(void)
          {
             *dest = *source;
 
-            source += 4;
+            source += TEMPBUF_WIDTH;
             dest += SURFACE_SHORT_PITCH;
          }
       }         
@@ -270,20 +301,38 @@ static void R_FlushHT16(void)
    }
 }
 
-static void R_FlushQuad16(void)
+//
+// R_FlushCommon16
+//
+// Flushes the rows all columns in the buffer have in common,
+// a row at a time. A full buffer takes the fixed width path
+// so the copy can be done with whole vector stores.
+//
+static void R_FlushCommon16(void)
 {
-   uint16_t *source = &short_tempbuf[commontop << 2];
+   uint16_t *source = &short_tempbuf[commontop << TEMPBUF_BITS];
    uint16_t *dest   = drawvars.short_topleft + commontop * SURFACE_SHORT_PITCH + startx;
    int        count = commonbot - commontop + 1;
 
-   while(--count >= 0)
+   if(temp_x == TEMPBUF_WIDTH)
    {
-      dest[0] = source[0];
-      dest[1] = source[1];
-      dest[2] = source[2];
-      dest[3] = source[3];
-      source += 4;
-      dest += SURFACE_SHORT_PITCH;
+      while(--count >= 0)
+      {
+         memcpy(dest, source, TEMPBUF_WIDTH * sizeof(*dest));
+         source += TEMPBUF_WIDTH;
+         dest += SURFACE_SHORT_PITCH;
+      }
+   }
+   else
+   {
+      const size_t rowsize = temp_x * sizeof(*dest);
+
+      while(--count >= 0)
+      {
+         memcpy(dest, source, rowsize);
+         source += TEMPBUF_WIDTH;
+         dest += SURFACE_SHORT_PITCH;
+      }
    }
 }
 
@@ -291,19 +340,17 @@ static void R_FlushQuad16(void)
  * R_FlushWholeFuzz16
  *
  * Flushes the entire columns in the buffer, one at a time.
- * This is used when a quad flush isn't possible.
+ * This is used when the columns have no rows in common.
  * Opaque version -- no remapping whatsoever.
 */
 static void R_FlushWholeFuzz16(void)
 {
-   uint16_t *source;
    uint16_t *dest;
    int  count, yl;
 
    while(--temp_x >= 0)
    {
       yl     = tempyl[temp_x];
-      source = &short_tempbuf[temp_x + (yl << 2)];
       dest   = drawvars.short_topleft + yl * SURFACE_SHORT_PITCH + startx + temp_x;
       count  = tempyh[temp_x] - yl + 1;
       
@@ -316,7 +363,6 @@ static void R_FlushWholeFuzz16(void)
          if(++fuzzpos == FUZZTABLE) 
             fuzzpos = 0;
 
-         source += 4;
          dest += SURFACE_SHORT_PITCH;
       }
    }
@@ -326,17 +372,16 @@ static void R_FlushWholeFuzz16(void)
 // R_FlushHTFuzz16
 //
 // Flushes the head and tail of columns in the buffer in
-// preparation for a quad flush.
+// preparation for a common span flush.
 // Opaque version -- no remapping whatsoever.
 //
 static void R_FlushHTFuzz16(void)
 {
-   uint16_t *source;
    uint16_t *dest;
    int count, colnum = 0;
    int yl, yh;
 
-   while(colnum < 4)
+   while(colnum < temp_x)
    {
       yl = tempyl[colnum];
       yh = tempyh[colnum];
@@ -344,7 +389,6 @@ static void R_FlushHTFuzz16(void)
       // flush column head
       if(yl < commontop)
       {
-         source = &short_tempbuf[colnum + (yl << 2)];
          dest   = drawvars.short_topleft + yl * SURFACE_SHORT_PITCH + startx + colnum;
          count  = commontop - yl;
          
@@ -357,7 +401,6 @@ static void R_FlushHTFuzz16(void)
             if(++fuzzpos == FUZZTABLE) 
                fuzzpos = 0;
 
-            source += 4;
             dest += SURFACE_SHORT_PITCH;
          }
       }
@@ -365,7 +408,6 @@ static void R_FlushHTFuzz16(void)
       // flush column tail
       if(yh > commonbot)
       {
-         source = &short_tempbuf[colnum + ((commonbot + 1) << 2)];
          dest   = drawvars.short_topleft + (commonbot + 1) * SURFACE_SHORT_PITCH + startx + colnum;
          count  = yh - commonbot;
          
@@ -378,7 +420,6 @@ static void R_FlushHTFuzz16(void)
             if(++fuzzpos == FUZZTABLE) 
                fuzzpos = 0;
 
-            source += 4;
             dest += SURFACE_SHORT_PITCH;
          }
       }         
@@ -386,28 +427,27 @@ static void R_FlushHTFuzz16(void)
    }
 }
 
-static void R_FlushQuadFuzz16(void)
+static void R_FlushCommonFuzz16(void)
 {
-   uint16_t *source = &short_tempbuf[commontop << 2];
    uint16_t *dest   = drawvars.short_topleft + commontop * SURFACE_SHORT_PITCH + startx;
-   int fuzz1        = fuzzpos;
-   int fuzz2        = (fuzz1 + tempyl[1]) % FUZZTABLE;
-   int fuzz3        = (fuzz2 + tempyl[2]) % FUZZTABLE;
-   int fuzz4        = (fuzz3 + tempyl[3]) % FUZZTABLE;
+   int fuzz[TEMPBUF_WIDTH];
    int count        = commonbot - commontop + 1;
+   int colnum;
+
+   // Each column starts further along the fuzz table
+   fuzz[0] = fuzzpos;
+   for(colnum = 1; colnum < temp_x; colnum++)
+      fuzz[colnum] = (fuzz[colnum - 1] + tempyl[colnum]) % FUZZTABLE;
 
    while(--count >= 0)
    {
-      dest[0] = GETBLENDED16_9406(dest[0 + fuzzoffset[fuzz1]], 0);
-      dest[1] = GETBLENDED16_9406(dest[1 + fuzzoffset[fuzz2]], 0);
-      dest[2] = GETBLENDED16_9406(dest[2 + fuzzoffset[fuzz3]], 0);
-      dest[3] = GETBLENDED16_9406(dest[3 + fuzzoffset[fuzz4]], 0);
-      fuzz1 = (fuzz1 + 1) % FUZZTABLE;
-      fuzz2 = (fuzz2 + 1) % FUZZTABLE;
-      fuzz3 = (fuzz3 + 1) % FUZZTABLE;
-      fuzz4 = (fuzz4 + 1) % FUZZTABLE;
-      source += 4 * sizeof(uint8_t);
-      dest += SURFACE_SHORT_PITCH * sizeof(uint8_t);
+      for(colnum = 0; colnum < temp_x; colnum++)
+      {
+         dest[colnum] = GETBLENDED16_9406(dest[colnum + fuzzoffset[fuzz[colnum]]], 0);
+         if(++fuzz[colnum] == FUZZTABLE)
+            fuzz[colnum] = 0;
+      }
+      dest += SURFACE_SHORT_PITCH;
    }
 }
 
@@ -477,7 +517,7 @@ static void R_DrawColumn16_PointUV(draw_column_vars_t *dcvars)
       if (count <= 0) return;
    }
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -494,9 +534,9 @@ static void R_DrawColumn16_PointUV(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWhole16;
       R_FlushHTColumns = R_FlushHT16;
-      R_FlushQuadColumn = R_FlushQuad16;
+      R_FlushCommonColumns = R_FlushCommon16;
 
-      dest = &short_tempbuf[dcvars->yl << 2];
+      dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
    }
    else
@@ -510,7 +550,7 @@ static void R_DrawColumn16_PointUV(draw_column_vars_t *dcvars)
          commonbot = dcvars->yh;
 
 
-      dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+      dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
    }
    temp_x += 1;
@@ -526,7 +566,7 @@ static void R_DrawColumn16_PointUV(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((source[(frac & ((127<<16)|0xffff))>>16]))*64 + ((64 -1)) ]);
             ;
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -537,7 +577,7 @@ static void R_DrawColumn16_PointUV(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((source[(frac)>>16]))*64 + ((64 -1)) ]);
             ;
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -551,11 +591,11 @@ static void R_DrawColumn16_PointUV(draw_column_vars_t *dcvars)
             {
                *dest = (V_Palette16[ ((source[(frac & fixedt_heightmask)>>16]))*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ ((source[(frac & fixedt_heightmask)>>16]))*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -581,7 +621,7 @@ static void R_DrawColumn16_PointUV(draw_column_vars_t *dcvars)
 
                *dest = (V_Palette16[ ((source[(frac)>>16]))*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
 
@@ -642,7 +682,7 @@ static void R_DrawColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
       if (count <= 0) return;
    }
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -659,9 +699,9 @@ static void R_DrawColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWhole16;
       R_FlushHTColumns = R_FlushHT16;
-      R_FlushQuadColumn = R_FlushQuad16;
+      R_FlushCommonColumns = R_FlushCommon16;
 
-      dest = &short_tempbuf[dcvars->yl << 2];
+      dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
    }
    else
@@ -675,7 +715,7 @@ static void R_DrawColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
          commonbot = dcvars->yh;
 
 
-      dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+      dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
    }
    temp_x += 1;
@@ -694,7 +734,7 @@ static void R_DrawColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ (colormap[(source[(frac & ((127<<16)|0xffff))>>16])])*64 + ((64 -1)) ]);
             ;
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -705,7 +745,7 @@ static void R_DrawColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ (colormap[(source[(frac)>>16])])*64 + ((64 -1)) ]);
             ;
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -719,11 +759,11 @@ static void R_DrawColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
             {
                *dest = (V_Palette16[ (colormap[(source[(frac & fixedt_heightmask)>>16])])*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ (colormap[(source[(frac & fixedt_heightmask)>>16])])*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -749,7 +789,7 @@ static void R_DrawColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
 
                *dest = (V_Palette16[ (colormap[(source[(frac)>>16])])*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
 
@@ -811,7 +851,7 @@ static void R_DrawColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
       if (count <= 0) return;
    }
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
             (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -828,9 +868,9 @@ static void R_DrawColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
 
          R_FlushWholeColumns = R_FlushWhole16;
          R_FlushHTColumns = R_FlushHT16;
-         R_FlushQuadColumn = R_FlushQuad16;
+         R_FlushCommonColumns = R_FlushCommon16;
 
-         dest = &short_tempbuf[dcvars->yl << 2];
+         dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
       }
       else
@@ -844,7 +884,7 @@ static void R_DrawColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
             commonbot = dcvars->yh;
 
 
-         dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
       }
       temp_x += 1;
@@ -873,7 +913,7 @@ static void R_DrawColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[(frac & ((127<<16)|0xffff))>>16])]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -884,7 +924,7 @@ static void R_DrawColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[(frac)>>16])]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -898,11 +938,11 @@ static void R_DrawColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
             {
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[(frac & fixedt_heightmask)>>16])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[(frac & fixedt_heightmask)>>16])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -928,7 +968,7 @@ static void R_DrawColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
 
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[(frac)>>16])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
 
@@ -1003,7 +1043,7 @@ static void R_DrawColumn16_LinearUV(draw_column_vars_t *dcvars)
    }
 
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -1020,9 +1060,9 @@ static void R_DrawColumn16_LinearUV(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWhole16;
       R_FlushHTColumns = R_FlushHT16;
-      R_FlushQuadColumn = R_FlushQuad16;
+      R_FlushCommonColumns = R_FlushCommon16;
 
-      dest = &short_tempbuf[dcvars->yl << 2];
+      dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
    }
    else
@@ -1036,7 +1076,7 @@ static void R_DrawColumn16_LinearUV(draw_column_vars_t *dcvars)
          commonbot = dcvars->yh;
 
 
-      dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+      dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
    }
    temp_x += 1;
@@ -1072,7 +1112,7 @@ static void R_DrawColumn16_LinearUV(draw_column_vars_t *dcvars)
          {
             *dest = (( V_Palette16[ ((nextsource[((frac+(1<<16)) & ((127<<16)|0xffff))>>16]))*64 + ((filter_fracu*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ ((source[((frac+(1<<16)) & ((127<<16)|0xffff))>>16]))*64 + (((0xffff-filter_fracu)*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ ((source[(frac & ((127<<16)|0xffff))>>16]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ] + V_Palette16[ ((nextsource[(frac & ((127<<16)|0xffff))>>16]))*64 + ((filter_fracu*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -1083,7 +1123,7 @@ static void R_DrawColumn16_LinearUV(draw_column_vars_t *dcvars)
          {
             *dest = (( V_Palette16[ ((nextsource[((frac+(1<<16)))>>16]))*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((source[((frac+(1<<16)))>>16]))*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((source[(frac)>>16]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ ((nextsource[(frac)>>16]))*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -1097,11 +1137,11 @@ static void R_DrawColumn16_LinearUV(draw_column_vars_t *dcvars)
             {
                *dest = (( V_Palette16[ ((nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16]))*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((source[((frac+(1<<16)) & fixedt_heightmask)>>16]))*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((source[(frac & fixedt_heightmask)>>16]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ ((nextsource[(frac & fixedt_heightmask)>>16]))*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (( V_Palette16[ ((nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16]))*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((source[((frac+(1<<16)) & fixedt_heightmask)>>16]))*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((source[(frac & fixedt_heightmask)>>16]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ ((nextsource[(frac & fixedt_heightmask)>>16]))*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -1138,7 +1178,7 @@ static void R_DrawColumn16_LinearUV(draw_column_vars_t *dcvars)
 
                *dest = (( V_Palette16[ ((nextsource[(nextfrac)>>16]))*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((source[(nextfrac)>>16]))*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((source[(frac)>>16]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ ((nextsource[(frac)>>16]))*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -1212,7 +1252,7 @@ static void R_DrawColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
       if (count <= 0) return;
    }
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -1229,9 +1269,9 @@ static void R_DrawColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWhole16;
       R_FlushHTColumns = R_FlushHT16;
-      R_FlushQuadColumn = R_FlushQuad16;
+      R_FlushCommonColumns = R_FlushCommon16;
 
-      dest = &short_tempbuf[dcvars->yl << 2];
+      dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
    }
    else
@@ -1245,7 +1285,7 @@ static void R_DrawColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
          commonbot = dcvars->yh;
 
 
-      dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+      dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
    }
    temp_x += 1;
@@ -1270,7 +1310,7 @@ static void R_DrawColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
          {
             *dest = (( V_Palette16[ (colormap[(nextsource[((frac+(1<<16)) & ((127<<16)|0xffff))>>16])])*64 + ((filter_fracu*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(source[((frac+(1<<16)) & ((127<<16)|0xffff))>>16])])*64 + (((0xffff-filter_fracu)*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(source[(frac & ((127<<16)|0xffff))>>16])])*64 + (((0xffff-filter_fracu)*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ] + V_Palette16[ (colormap[(nextsource[(frac & ((127<<16)|0xffff))>>16])])*64 + ((filter_fracu*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -1281,7 +1321,7 @@ static void R_DrawColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
          {
             *dest = (( V_Palette16[ (colormap[(nextsource[((frac+(1<<16)))>>16])])*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(source[((frac+(1<<16)))>>16])])*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(source[(frac)>>16])])*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ (colormap[(nextsource[(frac)>>16])])*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -1295,11 +1335,11 @@ static void R_DrawColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
             {
                *dest = (( V_Palette16[ (colormap[(nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16])])*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(source[((frac+(1<<16)) & fixedt_heightmask)>>16])])*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(source[(frac & fixedt_heightmask)>>16])])*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ (colormap[(nextsource[(frac & fixedt_heightmask)>>16])])*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (( V_Palette16[ (colormap[(nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16])])*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(source[((frac+(1<<16)) & fixedt_heightmask)>>16])])*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(source[(frac & fixedt_heightmask)>>16])])*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ (colormap[(nextsource[(frac & fixedt_heightmask)>>16])])*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -1328,7 +1368,7 @@ static void R_DrawColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
             {
                *dest = (( V_Palette16[ (colormap[(nextsource[(nextfrac)>>16])])*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(source[(nextfrac)>>16])])*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(source[(frac)>>16])])*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ (colormap[(nextsource[(frac)>>16])])*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -1401,7 +1441,7 @@ static void R_DrawColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars)
       if (count <= 0) return;
    }
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -1418,9 +1458,9 @@ static void R_DrawColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWhole16;
       R_FlushHTColumns = R_FlushHT16;
-      R_FlushQuadColumn = R_FlushQuad16;
+      R_FlushCommonColumns = R_FlushCommon16;
 
-      dest = &short_tempbuf[dcvars->yl << 2];
+      dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
    }
    else
@@ -1434,7 +1474,7 @@ static void R_DrawColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars)
          commonbot = dcvars->yh;
 
 
-      dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+      dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
    }
    temp_x += 1;
@@ -1464,7 +1504,7 @@ static void R_DrawColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars)
          {
             *dest = (( V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(nextsource[((frac+(1<<16)) & ((127<<16)|0xffff))>>16])]))*64 + ((filter_fracu*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[((frac+(1<<16)) & ((127<<16)|0xffff))>>16])]))*64 + (((0xffff-filter_fracu)*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[(frac & ((127<<16)|0xffff))>>16])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(nextsource[(frac & ((127<<16)|0xffff))>>16])]))*64 + ((filter_fracu*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -1475,7 +1515,7 @@ static void R_DrawColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars)
          {
             *dest = (( V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(nextsource[((frac+(1<<16)))>>16])]))*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[((frac+(1<<16)))>>16])]))*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[(frac)>>16])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(nextsource[(frac)>>16])]))*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -1489,11 +1529,11 @@ static void R_DrawColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars)
             {
                *dest = (( V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16])]))*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[((frac+(1<<16)) & fixedt_heightmask)>>16])]))*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[(frac & fixedt_heightmask)>>16])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(nextsource[(frac & fixedt_heightmask)>>16])]))*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (( V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16])]))*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[((frac+(1<<16)) & fixedt_heightmask)>>16])]))*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[(frac & fixedt_heightmask)>>16])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(nextsource[(frac & fixedt_heightmask)>>16])]))*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -1530,7 +1570,7 @@ static void R_DrawColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars)
 
                *dest = (( V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(nextsource[(nextfrac)>>16])]))*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[(nextfrac)>>16])]))*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(source[(frac)>>16])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(nextsource[(frac)>>16])]))*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -1606,7 +1646,7 @@ static void R_DrawColumn16_RoundedUV(draw_column_vars_t *dcvars)
 
    {
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -1623,9 +1663,9 @@ static void R_DrawColumn16_RoundedUV(draw_column_vars_t *dcvars)
 
          R_FlushWholeColumns = R_FlushWhole16;
          R_FlushHTColumns = R_FlushHT16;
-         R_FlushQuadColumn = R_FlushQuad16;
+         R_FlushCommonColumns = R_FlushCommon16;
 
-         dest = &short_tempbuf[dcvars->yl << 2];
+         dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
       }
       else
@@ -1639,7 +1679,7 @@ static void R_DrawColumn16_RoundedUV(draw_column_vars_t *dcvars)
             commonbot = dcvars->yh;
 
 
-         dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
       }
       temp_x += 1;
@@ -1671,7 +1711,7 @@ static void R_DrawColumn16_RoundedUV(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((filter_getScale2xQuadColors( source[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((0)>(((frac & ((127<<16)|0xffff))>>16)-1)?(0):(((frac & ((127<<16)|0xffff))>>16)-1))) ], nextsource[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((frac+(1<<16)) & ((127<<16)|0xffff))>>16) ], prevsource[ ((frac & ((127<<16)|0xffff))>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & ((127<<16)|0xffff))>>8) & 0xff)>>(8-6)) ] ]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -1682,7 +1722,7 @@ static void R_DrawColumn16_RoundedUV(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ (((frac+(1<<16)))>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -1696,11 +1736,11 @@ static void R_DrawColumn16_RoundedUV(draw_column_vars_t *dcvars)
             {
                *dest = (V_Palette16[ ((filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ ((filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -1737,7 +1777,7 @@ static void R_DrawColumn16_RoundedUV(draw_column_vars_t *dcvars)
 
                *dest = (V_Palette16[ ((filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ ((nextfrac)>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -1816,7 +1856,7 @@ static void R_DrawColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars)
 
    {
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
             (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -1833,9 +1873,9 @@ static void R_DrawColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars)
 
          R_FlushWholeColumns = R_FlushWhole16;
          R_FlushHTColumns = R_FlushHT16;
-         R_FlushQuadColumn = R_FlushQuad16;
+         R_FlushCommonColumns = R_FlushCommon16;
 
-         dest = &short_tempbuf[dcvars->yl << 2];
+         dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
       }
       else
@@ -1849,7 +1889,7 @@ static void R_DrawColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars)
             commonbot = dcvars->yh;
 
 
-         dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
       }
       temp_x += 1;
@@ -1882,7 +1922,7 @@ static void R_DrawColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ (colormap[(filter_getScale2xQuadColors( source[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((0)>(((frac & ((127<<16)|0xffff))>>16)-1)?(0):(((frac & ((127<<16)|0xffff))>>16)-1))) ], nextsource[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((frac+(1<<16)) & ((127<<16)|0xffff))>>16) ], prevsource[ ((frac & ((127<<16)|0xffff))>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & ((127<<16)|0xffff))>>8) & 0xff)>>(8-6)) ] ])])*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -1893,7 +1933,7 @@ static void R_DrawColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ (colormap[(filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ (((frac+(1<<16)))>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ])])*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -1907,11 +1947,11 @@ static void R_DrawColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars)
             {
                *dest = (V_Palette16[ (colormap[(filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ])])*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ (colormap[(filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ])])*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -1948,7 +1988,7 @@ static void R_DrawColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars)
 
                *dest = (V_Palette16[ (colormap[(filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ ((nextfrac)>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ])])*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -2028,7 +2068,7 @@ static void R_DrawColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvars)
 
    {
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
             (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -2045,9 +2085,9 @@ static void R_DrawColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvars)
 
          R_FlushWholeColumns = R_FlushWhole16;
          R_FlushHTColumns = R_FlushHT16;
-         R_FlushQuadColumn = R_FlushQuad16;
+         R_FlushCommonColumns = R_FlushCommon16;
 
-         dest = &short_tempbuf[dcvars->yl << 2];
+         dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
       }
       else
@@ -2061,7 +2101,7 @@ static void R_DrawColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvars)
             commonbot = dcvars->yh;
 
 
-         dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
       }
       temp_x += 1;
@@ -2104,7 +2144,7 @@ static void R_DrawColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(filter_getScale2xQuadColors( source[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((0)>(((frac & ((127<<16)|0xffff))>>16)-1)?(0):(((frac & ((127<<16)|0xffff))>>16)-1))) ], nextsource[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((frac+(1<<16)) & ((127<<16)|0xffff))>>16) ], prevsource[ ((frac & ((127<<16)|0xffff))>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & ((127<<16)|0xffff))>>8) & 0xff)>>(8-6)) ] ])]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -2115,7 +2155,7 @@ static void R_DrawColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ (((frac+(1<<16)))>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ])]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -2129,11 +2169,11 @@ static void R_DrawColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvars)
             {
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -2170,7 +2210,7 @@ static void R_DrawColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvars)
 
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ ((nextfrac)>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -2242,7 +2282,7 @@ static void R_DrawTranslatedColumn16_PointUV(draw_column_vars_t *dcvars)
       if (count <= 0) return;
    }
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -2259,9 +2299,9 @@ static void R_DrawTranslatedColumn16_PointUV(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWhole16;
       R_FlushHTColumns = R_FlushHT16;
-      R_FlushQuadColumn = R_FlushQuad16;
+      R_FlushCommonColumns = R_FlushCommon16;
 
-      dest = &short_tempbuf[dcvars->yl << 2];
+      dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
    }
    else
@@ -2275,7 +2315,7 @@ static void R_DrawTranslatedColumn16_PointUV(draw_column_vars_t *dcvars)
          commonbot = dcvars->yh;
 
 
-      dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+      dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
    }
    temp_x += 1;
@@ -2300,7 +2340,7 @@ static void R_DrawTranslatedColumn16_PointUV(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((translation[(source[(frac & ((127<<16)|0xffff))>>16])]))*64 + ((64 -1)) ]);
             ;
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -2311,7 +2351,7 @@ static void R_DrawTranslatedColumn16_PointUV(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((translation[(source[(frac)>>16])]))*64 + ((64 -1)) ]);
             ;
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -2325,11 +2365,11 @@ static void R_DrawTranslatedColumn16_PointUV(draw_column_vars_t *dcvars)
             {
                *dest = (V_Palette16[ ((translation[(source[(frac & fixedt_heightmask)>>16])]))*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ ((translation[(source[(frac & fixedt_heightmask)>>16])]))*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -2355,7 +2395,7 @@ static void R_DrawTranslatedColumn16_PointUV(draw_column_vars_t *dcvars)
 
                *dest = (V_Palette16[ ((translation[(source[(frac)>>16])]))*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
 
@@ -2418,7 +2458,7 @@ static void R_DrawTranslatedColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
       if (count <= 0) return;
    }
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -2435,9 +2475,9 @@ static void R_DrawTranslatedColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWhole16;
       R_FlushHTColumns = R_FlushHT16;
-      R_FlushQuadColumn = R_FlushQuad16;
+      R_FlushCommonColumns = R_FlushCommon16;
 
-      dest = &short_tempbuf[dcvars->yl << 2];
+      dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
    }
    else
@@ -2451,7 +2491,7 @@ static void R_DrawTranslatedColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
          commonbot = dcvars->yh;
 
 
-      dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+      dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
    }
    temp_x += 1;
@@ -2477,7 +2517,7 @@ static void R_DrawTranslatedColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ (colormap[(translation[(source[(frac & ((127<<16)|0xffff))>>16])])])*64 + ((64 -1)) ]);
             ;
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -2488,7 +2528,7 @@ static void R_DrawTranslatedColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ (colormap[(translation[(source[(frac)>>16])])])*64 + ((64 -1)) ]);
             ;
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -2502,11 +2542,11 @@ static void R_DrawTranslatedColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
             {
                *dest = (V_Palette16[ (colormap[(translation[(source[(frac & fixedt_heightmask)>>16])])])*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ (colormap[(translation[(source[(frac & fixedt_heightmask)>>16])])])*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -2527,7 +2567,7 @@ static void R_DrawTranslatedColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
             {
                *dest = (V_Palette16[ (colormap[(translation[(source[(frac)>>16])])])*64 + ((64 -1)) ]);
                ;
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
             }
          }
@@ -2592,7 +2632,7 @@ static void R_DrawTranslatedColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
 
    {
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -2609,9 +2649,9 @@ static void R_DrawTranslatedColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
 
          R_FlushWholeColumns = R_FlushWhole16;
          R_FlushHTColumns = R_FlushHT16;
-         R_FlushQuadColumn = R_FlushQuad16;
+         R_FlushCommonColumns = R_FlushCommon16;
 
-         dest = &short_tempbuf[dcvars->yl << 2];
+         dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
       }
       else
@@ -2625,7 +2665,7 @@ static void R_DrawTranslatedColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
             commonbot = dcvars->yh;
 
 
-         dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
       }
       temp_x += 1;
@@ -2658,7 +2698,7 @@ static void R_DrawTranslatedColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[(frac & ((127<<16)|0xffff))>>16])])]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -2669,7 +2709,7 @@ static void R_DrawTranslatedColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[(frac)>>16])])]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -2683,11 +2723,11 @@ static void R_DrawTranslatedColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
             {
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[(frac & fixedt_heightmask)>>16])])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[(frac & fixedt_heightmask)>>16])])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -2713,7 +2753,7 @@ static void R_DrawTranslatedColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
 
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[(frac)>>16])])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
 
@@ -2801,7 +2841,7 @@ static void R_DrawTranslatedColumn16_LinearUV(draw_column_vars_t *dcvars)
 
    {
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -2818,9 +2858,9 @@ static void R_DrawTranslatedColumn16_LinearUV(draw_column_vars_t *dcvars)
 
          R_FlushWholeColumns = R_FlushWhole16;
          R_FlushHTColumns = R_FlushHT16;
-         R_FlushQuadColumn = R_FlushQuad16;
+         R_FlushCommonColumns = R_FlushCommon16;
 
-         dest = &short_tempbuf[dcvars->yl << 2];
+         dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
       }
       else
@@ -2834,7 +2874,7 @@ static void R_DrawTranslatedColumn16_LinearUV(draw_column_vars_t *dcvars)
             commonbot = dcvars->yh;
 
 
-         dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
       }
       temp_x += 1;
@@ -2872,7 +2912,7 @@ static void R_DrawTranslatedColumn16_LinearUV(draw_column_vars_t *dcvars)
          {
             *dest = (( V_Palette16[ ((translation[(nextsource[((frac+(1<<16)) & ((127<<16)|0xffff))>>16])]))*64 + ((filter_fracu*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ ((translation[(source[((frac+(1<<16)) & ((127<<16)|0xffff))>>16])]))*64 + (((0xffff-filter_fracu)*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ ((translation[(source[(frac & ((127<<16)|0xffff))>>16])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ] + V_Palette16[ ((translation[(nextsource[(frac & ((127<<16)|0xffff))>>16])]))*64 + ((filter_fracu*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -2883,7 +2923,7 @@ static void R_DrawTranslatedColumn16_LinearUV(draw_column_vars_t *dcvars)
          {
             *dest = (( V_Palette16[ ((translation[(nextsource[((frac+(1<<16)))>>16])]))*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((translation[(source[((frac+(1<<16)))>>16])]))*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((translation[(source[(frac)>>16])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ ((translation[(nextsource[(frac)>>16])]))*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -2897,11 +2937,11 @@ static void R_DrawTranslatedColumn16_LinearUV(draw_column_vars_t *dcvars)
             {
                *dest = (( V_Palette16[ ((translation[(nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16])]))*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((translation[(source[((frac+(1<<16)) & fixedt_heightmask)>>16])]))*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((translation[(source[(frac & fixedt_heightmask)>>16])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ ((translation[(nextsource[(frac & fixedt_heightmask)>>16])]))*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (( V_Palette16[ ((translation[(nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16])]))*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((translation[(source[((frac+(1<<16)) & fixedt_heightmask)>>16])]))*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((translation[(source[(frac & fixedt_heightmask)>>16])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ ((translation[(nextsource[(frac & fixedt_heightmask)>>16])]))*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -2938,7 +2978,7 @@ static void R_DrawTranslatedColumn16_LinearUV(draw_column_vars_t *dcvars)
 
                *dest = (( V_Palette16[ ((translation[(nextsource[(nextfrac)>>16])]))*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((translation[(source[(nextfrac)>>16])]))*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((translation[(source[(frac)>>16])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ ((translation[(nextsource[(frac)>>16])]))*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -3013,7 +3053,7 @@ static void R_DrawTranslatedColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
 
    {
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -3030,9 +3070,9 @@ static void R_DrawTranslatedColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
 
          R_FlushWholeColumns = R_FlushWhole16;
          R_FlushHTColumns = R_FlushHT16;
-         R_FlushQuadColumn = R_FlushQuad16;
+         R_FlushCommonColumns = R_FlushCommon16;
 
-         dest = &short_tempbuf[dcvars->yl << 2];
+         dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
       }
       else
@@ -3046,7 +3086,7 @@ static void R_DrawTranslatedColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
             commonbot = dcvars->yh;
 
 
-         dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
       }
       temp_x += 1;
@@ -3085,7 +3125,7 @@ static void R_DrawTranslatedColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
          {
             *dest = (( V_Palette16[ (colormap[(translation[(nextsource[((frac+(1<<16)) & ((127<<16)|0xffff))>>16])])])*64 + ((filter_fracu*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(source[((frac+(1<<16)) & ((127<<16)|0xffff))>>16])])])*64 + (((0xffff-filter_fracu)*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(source[(frac & ((127<<16)|0xffff))>>16])])])*64 + (((0xffff-filter_fracu)*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(nextsource[(frac & ((127<<16)|0xffff))>>16])])])*64 + ((filter_fracu*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -3096,7 +3136,7 @@ static void R_DrawTranslatedColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
          {
             *dest = (( V_Palette16[ (colormap[(translation[(nextsource[((frac+(1<<16)))>>16])])])*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(source[((frac+(1<<16)))>>16])])])*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(source[(frac)>>16])])])*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(nextsource[(frac)>>16])])])*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -3110,11 +3150,11 @@ static void R_DrawTranslatedColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
             {
                *dest = (( V_Palette16[ (colormap[(translation[(nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16])])])*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(source[((frac+(1<<16)) & fixedt_heightmask)>>16])])])*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(source[(frac & fixedt_heightmask)>>16])])])*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(nextsource[(frac & fixedt_heightmask)>>16])])])*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (( V_Palette16[ (colormap[(translation[(nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16])])])*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(source[((frac+(1<<16)) & fixedt_heightmask)>>16])])])*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(source[(frac & fixedt_heightmask)>>16])])])*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(nextsource[(frac & fixedt_heightmask)>>16])])])*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -3151,7 +3191,7 @@ static void R_DrawTranslatedColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
 
                *dest = (( V_Palette16[ (colormap[(translation[(nextsource[(nextfrac)>>16])])])*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(source[(nextfrac)>>16])])])*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(source[(frac)>>16])])])*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ (colormap[(translation[(nextsource[(frac)>>16])])])*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -3230,7 +3270,7 @@ static void R_DrawTranslatedColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars
 
    {
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -3247,9 +3287,9 @@ static void R_DrawTranslatedColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars
 
          R_FlushWholeColumns = R_FlushWhole16;
          R_FlushHTColumns = R_FlushHT16;
-         R_FlushQuadColumn = R_FlushQuad16;
+         R_FlushCommonColumns = R_FlushCommon16;
 
-         dest = &short_tempbuf[dcvars->yl << 2];
+         dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
       }
       else
@@ -3263,7 +3303,7 @@ static void R_DrawTranslatedColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars
             commonbot = dcvars->yh;
 
 
-         dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
       }
       temp_x += 1;
@@ -3307,7 +3347,7 @@ static void R_DrawTranslatedColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars
          {
             *dest = (( V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(nextsource[((frac+(1<<16)) & ((127<<16)|0xffff))>>16])])]))*64 + ((filter_fracu*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[((frac+(1<<16)) & ((127<<16)|0xffff))>>16])])]))*64 + (((0xffff-filter_fracu)*((frac & ((127<<16)|0xffff))&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[(frac & ((127<<16)|0xffff))>>16])])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(nextsource[(frac & ((127<<16)|0xffff))>>16])])]))*64 + ((filter_fracu*(0xffff-((frac & ((127<<16)|0xffff))&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -3318,7 +3358,7 @@ static void R_DrawTranslatedColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars
          {
             *dest = (( V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(nextsource[((frac+(1<<16)))>>16])])]))*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[((frac+(1<<16)))>>16])])]))*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[(frac)>>16])])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(nextsource[(frac)>>16])])]))*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -3332,11 +3372,11 @@ static void R_DrawTranslatedColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars
             {
                *dest = (( V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16])])]))*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[((frac+(1<<16)) & fixedt_heightmask)>>16])])]))*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[(frac & fixedt_heightmask)>>16])])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(nextsource[(frac & fixedt_heightmask)>>16])])]))*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (( V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(nextsource[((frac+(1<<16)) & fixedt_heightmask)>>16])])]))*64 + ((filter_fracu*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[((frac+(1<<16)) & fixedt_heightmask)>>16])])]))*64 + (((0xffff-filter_fracu)*((frac & fixedt_heightmask)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[(frac & fixedt_heightmask)>>16])])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(nextsource[(frac & fixedt_heightmask)>>16])])]))*64 + ((filter_fracu*(0xffff-((frac & fixedt_heightmask)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -3373,7 +3413,7 @@ static void R_DrawTranslatedColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars
 
                *dest = (( V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(nextsource[(nextfrac)>>16])])]))*64 + ((filter_fracu*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[(nextfrac)>>16])])]))*64 + (((0xffff-filter_fracu)*((frac)&0xffff))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(source[(frac)>>16])])]))*64 + (((0xffff-filter_fracu)*(0xffff-((frac)&0xffff)))>>(32-6)) ] + V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(nextsource[(frac)>>16])])]))*64 + ((filter_fracu*(0xffff-((frac)&0xffff)))>>(32-6)) ]));
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -3444,7 +3484,7 @@ static void R_DrawTranslatedColumn16_RoundedUV(draw_column_vars_t *dcvars)
 
    {
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -3461,9 +3501,9 @@ static void R_DrawTranslatedColumn16_RoundedUV(draw_column_vars_t *dcvars)
 
          R_FlushWholeColumns = R_FlushWhole16;
          R_FlushHTColumns = R_FlushHT16;
-         R_FlushQuadColumn = R_FlushQuad16;
+         R_FlushCommonColumns = R_FlushCommon16;
 
-         dest = &short_tempbuf[dcvars->yl << 2];
+         dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
       }
       else
@@ -3477,7 +3517,7 @@ static void R_DrawTranslatedColumn16_RoundedUV(draw_column_vars_t *dcvars)
             commonbot = dcvars->yh;
 
 
-         dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
       }
       temp_x += 1;
@@ -3510,7 +3550,7 @@ static void R_DrawTranslatedColumn16_RoundedUV(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((translation[(filter_getScale2xQuadColors( source[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((0)>(((frac & ((127<<16)|0xffff))>>16)-1)?(0):(((frac & ((127<<16)|0xffff))>>16)-1))) ], nextsource[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((frac+(1<<16)) & ((127<<16)|0xffff))>>16) ], prevsource[ ((frac & ((127<<16)|0xffff))>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & ((127<<16)|0xffff))>>8) & 0xff)>>(8-6)) ] ])]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -3521,7 +3561,7 @@ static void R_DrawTranslatedColumn16_RoundedUV(draw_column_vars_t *dcvars)
          {
             *dest = (V_Palette16[ ((translation[(filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ (((frac+(1<<16)))>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ])]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -3535,11 +3575,11 @@ static void R_DrawTranslatedColumn16_RoundedUV(draw_column_vars_t *dcvars)
             {
                *dest = (V_Palette16[ ((translation[(filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ ((translation[(filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -3576,7 +3616,7 @@ static void R_DrawTranslatedColumn16_RoundedUV(draw_column_vars_t *dcvars)
 
                *dest = (V_Palette16[ ((translation[(filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ ((nextfrac)>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -3656,7 +3696,7 @@ static void R_DrawTranslatedColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars
 
    {
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -3673,9 +3713,9 @@ static void R_DrawTranslatedColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars
 
          R_FlushWholeColumns = R_FlushWhole16;
          R_FlushHTColumns = R_FlushHT16;
-         R_FlushQuadColumn = R_FlushQuad16;
+         R_FlushCommonColumns = R_FlushCommon16;
 
-         dest = &short_tempbuf[dcvars->yl << 2];
+         dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
       }
       else
@@ -3689,7 +3729,7 @@ static void R_DrawTranslatedColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars
             commonbot = dcvars->yh;
 
 
-         dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
       }
       temp_x += 1;
@@ -3723,7 +3763,7 @@ static void R_DrawTranslatedColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars
          {
             *dest = (V_Palette16[ (colormap[(translation[(filter_getScale2xQuadColors( source[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((0)>(((frac & ((127<<16)|0xffff))>>16)-1)?(0):(((frac & ((127<<16)|0xffff))>>16)-1))) ], nextsource[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((frac+(1<<16)) & ((127<<16)|0xffff))>>16) ], prevsource[ ((frac & ((127<<16)|0xffff))>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & ((127<<16)|0xffff))>>8) & 0xff)>>(8-6)) ] ])])])*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -3734,7 +3774,7 @@ static void R_DrawTranslatedColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars
          {
             *dest = (V_Palette16[ (colormap[(translation[(filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ (((frac+(1<<16)))>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ])])])*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -3748,11 +3788,11 @@ static void R_DrawTranslatedColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars
             {
                *dest = (V_Palette16[ (colormap[(translation[(filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ])])])*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ (colormap[(translation[(filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ])])])*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -3789,7 +3829,7 @@ static void R_DrawTranslatedColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars
 
                *dest = (V_Palette16[ (colormap[(translation[(filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ ((nextfrac)>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ])])])*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -3866,7 +3906,7 @@ static void R_DrawTranslatedColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvar
 
    {
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
             (temp_x && (temptype != (COL_OPAQUE) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -3883,9 +3923,9 @@ static void R_DrawTranslatedColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvar
 
          R_FlushWholeColumns = R_FlushWhole16;
          R_FlushHTColumns = R_FlushHT16;
-         R_FlushQuadColumn = R_FlushQuad16;
+         R_FlushCommonColumns = R_FlushCommon16;
 
-         dest = &short_tempbuf[dcvars->yl << 2];
+         dest = &short_tempbuf[dcvars->yl << TEMPBUF_BITS];
 
       }
       else
@@ -3899,7 +3939,7 @@ static void R_DrawTranslatedColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvar
             commonbot = dcvars->yh;
 
 
-         dest = &short_tempbuf[(dcvars->yl << 2) + temp_x];
+         dest = &short_tempbuf[(dcvars->yl << TEMPBUF_BITS) + temp_x];
 
       }
       temp_x += 1;
@@ -3941,7 +3981,7 @@ static void R_DrawTranslatedColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvar
          {
             *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(filter_getScale2xQuadColors( source[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((0)>(((frac & ((127<<16)|0xffff))>>16)-1)?(0):(((frac & ((127<<16)|0xffff))>>16)-1))) ], nextsource[ ((frac & ((127<<16)|0xffff))>>16) ], source[ (((frac+(1<<16)) & ((127<<16)|0xffff))>>16) ], prevsource[ ((frac & ((127<<16)|0xffff))>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & ((127<<16)|0xffff))>>8) & 0xff)>>(8-6)) ] ])])]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -3952,7 +3992,7 @@ static void R_DrawTranslatedColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvar
          {
             *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ (((frac+(1<<16)))>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ])])]))*64 + ((64 -1)) ]);
             (y++);
-            dest += 4;
+            dest += TEMPBUF_WIDTH;
             frac += fracstep;
          }
       }
@@ -3966,11 +4006,11 @@ static void R_DrawTranslatedColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvar
             {
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ])])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(filter_getScale2xQuadColors( source[ ((frac & fixedt_heightmask)>>16) ], source[ (((0)>(((frac & fixedt_heightmask)>>16)-1)?(0):(((frac & fixedt_heightmask)>>16)-1))) ], nextsource[ ((frac & fixedt_heightmask)>>16) ], source[ (((frac+(1<<16)) & fixedt_heightmask)>>16) ], prevsource[ ((frac & fixedt_heightmask)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac & fixedt_heightmask)>>8) & 0xff)>>(8-6)) ] ])])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                frac += fracstep;
             }
             if (count & 1)
@@ -4007,7 +4047,7 @@ static void R_DrawTranslatedColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvar
 
                *dest = (V_Palette16[ ((dither_colormaps[((filter_ditherMatrix[(y)&(4 -1)][(x)&(4 -1)] < (fracz)) ? 1 : 0)][(translation[(filter_getScale2xQuadColors( source[ ((frac)>>16) ], source[ (((0)>(((frac)>>16)-1)?(0):(((frac)>>16)-1))) ], nextsource[ ((frac)>>16) ], source[ ((nextfrac)>>16) ], prevsource[ ((frac)>>16) ] ) [ filter_roundedUVMap[ ((filter_fracu>>(8-6))<<6) + ((((frac)>>8) & 0xff)>>(8-6)) ] ])])]))*64 + ((64 -1)) ]);
                (y++);
-               dest += 4;
+               dest += TEMPBUF_WIDTH;
                if ((frac += fracstep) >= (int)heightmask) frac -= heightmask;;
 
                if ((nextfrac += fracstep) >= (int)heightmask) nextfrac -= heightmask;;
@@ -4082,7 +4122,7 @@ static void R_DrawFuzzColumn16_PointUV(draw_column_vars_t *dcvars)
       if (count <= 0) return;
    }
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_FUZZ) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -4097,7 +4137,7 @@ static void R_DrawFuzzColumn16_PointUV(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWholeFuzz16;
       R_FlushHTColumns = R_FlushHTFuzz16;
-      R_FlushQuadColumn = R_FlushQuadFuzz16;
+      R_FlushCommonColumns = R_FlushCommonFuzz16;
    }
    else
    {
@@ -4168,7 +4208,7 @@ static void R_DrawFuzzColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
      if (count <= 0) return;
   }
 
-  if(temp_x == 4 ||
+  if(temp_x == tempbuf_batch ||
         (temp_x && (temptype != (COL_FUZZ) || temp_x + startx != dcvars->x)))
      R_FlushColumns();
 
@@ -4183,7 +4223,7 @@ static void R_DrawFuzzColumn16_PointUV_PointZ(draw_column_vars_t *dcvars)
 
      R_FlushWholeColumns = R_FlushWholeFuzz16;
      R_FlushHTColumns = R_FlushHTFuzz16;
-     R_FlushQuadColumn = R_FlushQuadFuzz16;
+     R_FlushCommonColumns = R_FlushCommonFuzz16;
   }
   else
   {
@@ -4253,7 +4293,7 @@ static void R_DrawFuzzColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
      if (count <= 0) return;
   }
 
-  if(temp_x == 4 ||
+  if(temp_x == tempbuf_batch ||
         (temp_x && (temptype != (COL_FUZZ) || temp_x + startx != dcvars->x)))
      R_FlushColumns();
 
@@ -4270,7 +4310,7 @@ static void R_DrawFuzzColumn16_PointUV_LinearZ(draw_column_vars_t *dcvars)
 
      R_FlushWholeColumns = R_FlushWholeFuzz16;
      R_FlushHTColumns = R_FlushHTFuzz16;
-     R_FlushQuadColumn = R_FlushQuadFuzz16;
+     R_FlushCommonColumns = R_FlushCommonFuzz16;
 
 
 
@@ -4356,7 +4396,7 @@ static void R_DrawFuzzColumn16_LinearUV(draw_column_vars_t *dcvars)
      if (count <= 0) return;
   }
 
-  if(temp_x == 4 ||
+  if(temp_x == tempbuf_batch ||
         (temp_x && (temptype != (COL_FUZZ) || temp_x + startx != dcvars->x)))
      R_FlushColumns();
 
@@ -4373,7 +4413,7 @@ static void R_DrawFuzzColumn16_LinearUV(draw_column_vars_t *dcvars)
 
      R_FlushWholeColumns = R_FlushWholeFuzz16;
      R_FlushHTColumns = R_FlushHTFuzz16;
-     R_FlushQuadColumn = R_FlushQuadFuzz16;
+     R_FlushCommonColumns = R_FlushCommonFuzz16;
 
 
 
@@ -4461,7 +4501,7 @@ static void R_DrawFuzzColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
       if (count <= 0) return;
    }
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_FUZZ) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -4478,7 +4518,7 @@ static void R_DrawFuzzColumn16_LinearUV_PointZ(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWholeFuzz16;
       R_FlushHTColumns = R_FlushHTFuzz16;
-      R_FlushQuadColumn = R_FlushQuadFuzz16;
+      R_FlushCommonColumns = R_FlushCommonFuzz16;
 
 
 
@@ -4581,7 +4621,7 @@ static void R_DrawFuzzColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars)
 
    {
 
-      if(temp_x == 4 ||
+      if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_FUZZ) || temp_x + startx != dcvars->x)))
          R_FlushColumns();
 
@@ -4598,7 +4638,7 @@ static void R_DrawFuzzColumn16_LinearUV_LinearZ(draw_column_vars_t *dcvars)
 
          R_FlushWholeColumns = R_FlushWholeFuzz16;
          R_FlushHTColumns = R_FlushHTFuzz16;
-         R_FlushQuadColumn = R_FlushQuadFuzz16;
+         R_FlushCommonColumns = R_FlushCommonFuzz16;
 
 
 
@@ -4684,7 +4724,7 @@ static void R_DrawFuzzColumn16_RoundedUV(draw_column_vars_t *dcvars)
       if (count <= 0) return;
    }
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_FUZZ) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -4701,7 +4741,7 @@ static void R_DrawFuzzColumn16_RoundedUV(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWholeFuzz16;
       R_FlushHTColumns = R_FlushHTFuzz16;
-      R_FlushQuadColumn = R_FlushQuadFuzz16;
+      R_FlushCommonColumns = R_FlushCommonFuzz16;
    }
    else
    {
@@ -4782,7 +4822,7 @@ static void R_DrawFuzzColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars)
          return;
    }
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_FUZZ) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -4799,7 +4839,7 @@ static void R_DrawFuzzColumn16_RoundedUV_PointZ(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWholeFuzz16;
       R_FlushHTColumns = R_FlushHTFuzz16;
-      R_FlushQuadColumn = R_FlushQuadFuzz16;
+      R_FlushCommonColumns = R_FlushCommonFuzz16;
 
 
 
@@ -4885,7 +4925,7 @@ static void R_DrawFuzzColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvars)
       if (count <= 0) return;
    }
 
-   if(temp_x == 4 ||
+   if(temp_x == tempbuf_batch ||
          (temp_x && (temptype != (COL_FUZZ) || temp_x + startx != dcvars->x)))
       R_FlushColumns();
 
@@ -4900,7 +4940,7 @@ static void R_DrawFuzzColumn16_RoundedUV_LinearZ(draw_column_vars_t *dcvars)
 
       R_FlushWholeColumns = R_FlushWholeFuzz16;
       R_FlushHTColumns = R_FlushHTFuzz16;
-      R_FlushQuadColumn = R_FlushQuadFuzz16;
+      R_FlushCommonColumns = R_FlushCommonFuzz16;
    }
    else
    {
@@ -4985,6 +5025,64 @@ void R_SetDefaultDrawColumnVars(draw_column_vars_t *dcvars)
    dcvars->edgetype      = drawvars.sprite_edges;
 }
 
+//
+// Wall column queue
+//
+// When the view is split between render threads, the BSP walk only
+// records its wall columns; each strip's thread replays them later in
+// the original order, so the result is the same as drawing them at once.
+//
+
+typedef struct {
+   R_DrawColumn_f colfunc;
+   draw_column_vars_t dcvars;
+} queuedcolumn_t;
+
+static queuedcolumn_t *colqueue[MAX_RENDER_THREADS];
+static int colqueue_num[MAX_RENDER_THREADS], colqueue_max[MAX_RENDER_THREADS];
+static int colqueue_strips, colqueue_stripwidth;
+
+void R_SetColumnQueue(int strips, int stripwidth)
+{
+   int i;
+
+   colqueue_strips = strips > 1 ? strips : 0;
+   colqueue_stripwidth = stripwidth;
+   for (i = 0; i < MAX_RENDER_THREADS; i++)
+      colqueue_num[i] = 0;
+}
+
+void R_DrawWallColumn(R_DrawColumn_f colfunc, draw_column_vars_t *dcvars)
+{
+   int strip;
+   queuedcolumn_t *col;
+
+   if (!colqueue_strips)
+   {
+      colfunc(dcvars);
+      return;
+   }
+
+   strip = dcvars->x / colqueue_stripwidth;
+   if (colqueue_num[strip] == colqueue_max[strip])
+   {
+      colqueue_max[strip] = colqueue_max[strip] ? colqueue_max[strip]*2 : 1024;
+      colqueue[strip] = realloc(colqueue[strip], colqueue_max[strip] * sizeof *colqueue[strip]);
+   }
+   col = &colqueue[strip][colqueue_num[strip]++];
+   col->colfunc = colfunc;
+   col->dcvars = *dcvars;
+}
+
+void R_DrawColumnQueue(int strip)
+{
+   int i;
+   queuedcolumn_t *col = colqueue[strip];
+
+   for (i = colqueue_num[strip]; i > 0; i--, col++)
+      col->colfunc(&col->dcvars);
+}
+
 //
 // R_InitTranslationTables
 // Creates the translation tables to map
@@ -5314,6 +5412,41 @@ void R_DrawSpan(draw_span_vars_t *dsvars) {
   R_GetDrawSpanFunc(drawvars.filterfloor, drawvars.filterz)(dsvars);
 }
 
+// The plain C drawers, kept to check the SIMD ones against
+static R_DrawSpan_f drawspanfuncs_c[RDRAW_FILTER_MAXFILTERS][RDRAW_FILTER_MAXFILTERS];
+
+R_DrawSpan_f R_GetDrawSpanFuncC(enum draw_filter_type_e filter,
+                                enum draw_filter_type_e filterz)
+{
+  return drawspanfuncs_c[filterz][filter];
+}
+
+//
+// R_InitDrawSpanFuncs
+// Replaces the span drawers with their SSE2/NEON versions where
+// the CPU has those (see r_draw_simd.c)
+//
+
+static void R_InitDrawSpanFuncs(void)
+{
+  static dbool saved = FALSE;
+  int filter, filterz;
+
+  if (!saved)
+  {
+    memcpy(drawspanfuncs_c, drawspanfuncs, sizeof(drawspanfuncs_c));
+    saved = TRUE;
+  }
+
+  for (filterz = 0; filterz < RDRAW_FILTER_MAXFILTERS; filterz++)
+    for (filter = 0; filter < RDRAW_FILTER_MAXFILTERS; filter++)
+    {
+      R_DrawSpan_f simd = R_GetDrawSpanFuncSIMD(filter, filterz);
+      if (simd)
+        drawspanfuncs[filterz][filter] = simd;
+    }
+}
+
 //
 // R_InitBuffer
 // Creats lookup tables that avoid
@@ -5336,4 +5469,6 @@ void R_InitBuffer(int width, int height)
 
   for (i=0; i<FUZZTABLE; i++)
 	  fuzzoffset[i] = fuzzoffset_org[i] * SURFACE_SHORT_PITCH;
+
+  R_InitDrawSpanFuncs();
 }
@@ -133,6 +133,20 @@ R_DrawSpan_f R_GetDrawSpanFunc(enum draw_filter_type_e filter,
                                enum draw_filter_type_e filterz);
 void R_DrawSpan(draw_span_vars_t *dsvars);
 
+// SSE2/NEON span drawers, NULL if there's none for the filter or CPU
+R_DrawSpan_f R_GetDrawSpanFuncSIMD(enum draw_filter_type_e filter,
+                                   enum draw_filter_type_e filterz);
+// The plain C span drawer, even where R_GetDrawSpanFunc returns the
+// SIMD one (the filtered C drawers still hand minified spans on to it)
+R_DrawSpan_f R_GetDrawSpanFuncC(enum draw_filter_type_e filter,
+                                enum draw_filter_type_e filterz);
+
+// Wall columns are queued per strip while the view is split between
+// render threads, and drawn later by R_DrawColumnQueue.
+void R_SetColumnQueue(int strips, int stripwidth);
+void R_DrawWallColumn(R_DrawColumn_f colfunc, draw_column_vars_t *dcvars);
+void R_DrawColumnQueue(int strip);
+
 void R_InitBuffer(int width, int height);
 
 // Initialize color translation tables, for player rendering etc.
@@ -143,4 +157,7 @@ void R_InitTranslationTables(void);
 // column drawing.
 void R_ResetColumnBuffer(void);
 
+// Columns batched per flush, TEMPBUF_WIDTH unless lowered to time it
+int R_SetColumnBatch(int columns);
+
 #endif
@@ -0,0 +1,421 @@
+/* Emacs style mode select   -*- C++ -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *  Copyright (C) 1999 by
+ *  id Software, Chi Hoang, Lee Killough, Jim Flynn, Rand Phares, Ty Halderman
+ *  Copyright (C) 1999-2000 by
+ *  Jess Haas, Nicolas Kalkhof, Colin Phipps, Florian Schulze
+ *  Copyright 2005, 2006 by
+ *  Florian Schulze, Colin Phipps, Neil Stevens, Andrey Budko
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *      SSE2/NEON versions of the flat span drawers.
+ *      Texture coordinates, flat offsets and filter weights are worked
+ *      out for 8 pixels at a time, the texels are then looked up and
+ *      the 8 finished pixels written with a single store. The results
+ *      are the same, bit for bit, as the plain C drawers in r_draw.c.
+ *
+ *-----------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "doomstat.h"
+#include "r_main.h"
+#include "r_draw.h"
+#include "r_filter.h"
+#include "v_video.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SPAN_SSE2
+#define SPAN_SIMD_TARGET
+#elif (defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__) && !defined(__clang__)
+/* Built without -msse2 (32 bit x86): compile the SSE2 drawers anyway
+ * and only use them if the CPU turns out to have it */
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#include <emmintrin.h>
+#pragma GCC pop_options
+#define SPAN_SSE2
+#define SPAN_SSE2_RUNTIME
+#define SPAN_SIMD_TARGET __attribute__((target("sse2")))
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SPAN_NEON
+#define SPAN_SIMD_TARGET
+#endif
+
+#if defined(SPAN_SSE2) || defined(SPAN_NEON)
+
+#define SPAN_BLOCK 8
+
+// Flat offsets (into the 64x64 flat) of 8 consecutive pixels
+typedef struct {
+  uint16_t spot[SPAN_BLOCK];
+} span_point_block_t;
+
+// The four texels a bilinear filtered pixel is made of, and how much
+// each contributes (as a V_Palette16 weight, 0-63)
+typedef struct {
+  uint16_t spot[4][SPAN_BLOCK];
+  uint16_t weight[4][SPAN_BLOCK];
+} span_linear_block_t;
+
+#ifdef SPAN_SSE2
+
+static SPAN_SIMD_TARGET void R_SpanPointBlock(fixed_t xfrac, fixed_t yfrac,
+  fixed_t xstep, fixed_t ystep, span_point_block_t *b)
+{
+  const __m128i xmask = _mm_set1_epi32(63);
+  const __m128i ymask = _mm_set1_epi32(4032);
+  __m128i x0 = _mm_add_epi32(_mm_set1_epi32(xfrac),
+    _mm_set_epi32((int)(3u*xstep), (int)(2u*xstep), xstep, 0));
+  __m128i y0 = _mm_add_epi32(_mm_set1_epi32(yfrac),
+    _mm_set_epi32((int)(3u*ystep), (int)(2u*ystep), ystep, 0));
+  __m128i x1 = _mm_add_epi32(x0, _mm_set1_epi32((int)(4u*xstep)));
+  __m128i y1 = _mm_add_epi32(y0, _mm_set1_epi32((int)(4u*ystep)));
+  __m128i s0 = _mm_or_si128(_mm_and_si128(_mm_srai_epi32(x0, 16), xmask),
+                            _mm_and_si128(_mm_srai_epi32(y0, 10), ymask));
+  __m128i s1 = _mm_or_si128(_mm_and_si128(_mm_srai_epi32(x1, 16), xmask),
+                            _mm_and_si128(_mm_srai_epi32(y1, 10), ymask));
+
+  _mm_storeu_si128((__m128i *)b->spot, _mm_packs_epi32(s0, s1));
+}
+
+// Low 16 bits of each lane of a and b, as 8 16 bit lanes
+static SPAN_SIMD_TARGET __m128i R_SpanPackLow16(__m128i a, __m128i b)
+{
+  a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+  b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+  return _mm_packs_epi32(a, b);
+}
+
+static SPAN_SIMD_TARGET void R_SpanLinearBlock(fixed_t xfrac, fixed_t yfrac,
+  fixed_t xstep, fixed_t ystep, span_linear_block_t *b)
+{
+  const __m128i one = _mm_set1_epi32(FRACUNIT);
+  const __m128i xmask = _mm_set1_epi32(0x3f);
+  const __m128i ymask = _mm_set1_epi32(0xfc0);
+  __m128i x0 = _mm_add_epi32(_mm_set1_epi32(xfrac),
+    _mm_set_epi32((int)(3u*xstep), (int)(2u*xstep), xstep, 0));
+  __m128i y0 = _mm_add_epi32(_mm_set1_epi32(yfrac),
+    _mm_set_epi32((int)(3u*ystep), (int)(2u*ystep), ystep, 0));
+  __m128i x1 = _mm_add_epi32(x0, _mm_set1_epi32((int)(4u*xstep)));
+  __m128i y1 = _mm_add_epi32(y0, _mm_set1_epi32((int)(4u*ystep)));
+  __m128i xa, xb, ya, yb, fx, fy, ifx, ify;
+
+  // Texel columns and rows either side of the sample point
+  xa = _mm_packs_epi32(_mm_and_si128(_mm_srai_epi32(x0, 16), xmask),
+                       _mm_and_si128(_mm_srai_epi32(x1, 16), xmask));
+  xb = _mm_packs_epi32(_mm_and_si128(_mm_srai_epi32(_mm_add_epi32(x0, one), 16), xmask),
+                       _mm_and_si128(_mm_srai_epi32(_mm_add_epi32(x1, one), 16), xmask));
+  ya = _mm_packs_epi32(_mm_and_si128(_mm_srai_epi32(y0, 10), ymask),
+                       _mm_and_si128(_mm_srai_epi32(y1, 10), ymask));
+  yb = _mm_packs_epi32(_mm_and_si128(_mm_srai_epi32(_mm_add_epi32(y0, one), 10), ymask),
+                       _mm_and_si128(_mm_srai_epi32(_mm_add_epi32(y1, one), 10), ymask));
+
+  _mm_storeu_si128((__m128i *)b->spot[0], _mm_or_si128(xb, yb));
+  _mm_storeu_si128((__m128i *)b->spot[1], _mm_or_si128(xa, yb));
+  _mm_storeu_si128((__m128i *)b->spot[2], _mm_or_si128(xa, ya));
+  _mm_storeu_si128((__m128i *)b->spot[3], _mm_or_si128(xb, ya));
+
+  // Weights are the top 6 bits of a 16x16 bit product of the fractions
+  fx = R_SpanPackLow16(x0, x1);
+  fy = R_SpanPackLow16(y0, y1);
+  ifx = _mm_xor_si128(fx, _mm_set1_epi16(-1));
+  ify = _mm_xor_si128(fy, _mm_set1_epi16(-1));
+
+  _mm_storeu_si128((__m128i *)b->weight[0], _mm_srli_epi16(_mm_mulhi_epu16(fx, fy), 10));
+  _mm_storeu_si128((__m128i *)b->weight[1], _mm_srli_epi16(_mm_mulhi_epu16(ifx, fy), 10));
+  _mm_storeu_si128((__m128i *)b->weight[2], _mm_srli_epi16(_mm_mulhi_epu16(ifx, ify), 10));
+  _mm_storeu_si128((__m128i *)b->weight[3], _mm_srli_epi16(_mm_mulhi_epu16(fx, ify), 10));
+}
+
+static SPAN_SIMD_TARGET void R_SpanStore(uint16_t *dest, const uint16_t *pixels)
+{
+  _mm_storeu_si128((__m128i *)dest, _mm_loadu_si128((const __m128i *)pixels));
+}
+
+#else /* SPAN_NEON */
+
+static void R_SpanPointBlock(fixed_t xfrac, fixed_t yfrac,
+  fixed_t xstep, fixed_t ystep, span_point_block_t *b)
+{
+  const int32_t xoffs[4] = { 0, xstep, (int32_t)(2u*xstep), (int32_t)(3u*xstep) };
+  const int32_t yoffs[4] = { 0, ystep, (int32_t)(2u*ystep), (int32_t)(3u*ystep) };
+  const int32x4_t xmask = vdupq_n_s32(63);
+  const int32x4_t ymask = vdupq_n_s32(4032);
+  int32x4_t x0 = vaddq_s32(vdupq_n_s32(xfrac), vld1q_s32(xoffs));
+  int32x4_t y0 = vaddq_s32(vdupq_n_s32(yfrac), vld1q_s32(yoffs));
+  int32x4_t x1 = vaddq_s32(x0, vdupq_n_s32((int32_t)(4u*xstep)));
+  int32x4_t y1 = vaddq_s32(y0, vdupq_n_s32((int32_t)(4u*ystep)));
+  int32x4_t s0 = vorrq_s32(vandq_s32(vshrq_n_s32(x0, 16), xmask),
+                           vandq_s32(vshrq_n_s32(y0, 10), ymask));
+  int32x4_t s1 = vorrq_s32(vandq_s32(vshrq_n_s32(x1, 16), xmask),
+                           vandq_s32(vshrq_n_s32(y1, 10), ymask));
+
+  vst1q_u16(b->spot, vcombine_u16(vmovn_u32(vreinterpretq_u32_s32(s0)),
+                                  vmovn_u32(vreinterpretq_u32_s32(s1))));
+}
+
+static uint16x8_t R_SpanNarrow(int32x4_t a, int32x4_t b)
+{
+  return vcombine_u16(vmovn_u32(vreinterpretq_u32_s32(a)),
+                      vmovn_u32(vreinterpretq_u32_s32(b)));
+}
+
+// Top 6 bits of a 16x16 bit product of the fractions, for 8 pixels
+static uint16x8_t R_SpanWeight(uint16x8_t a, uint16x8_t b)
+{
+  uint32x4_t lo = vmull_u16(vget_low_u16(a), vget_low_u16(b));
+  uint32x4_t hi = vmull_u16(vget_high_u16(a), vget_high_u16(b));
+  return vshrq_n_u16(vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16)), 10);
+}
+
+static void R_SpanLinearBlock(fixed_t xfrac, fixed_t yfrac,
+  fixed_t xstep, fixed_t ystep, span_linear_block_t *b)
+{
+  const int32_t xoffs[4] = { 0, xstep, (int32_t)(2u*xstep), (int32_t)(3u*xstep) };
+  const int32_t yoffs[4] = { 0, ystep, (int32_t)(2u*ystep), (int32_t)(3u*ystep) };
+  const int32x4_t one = vdupq_n_s32(FRACUNIT);
+  const int32x4_t xmask = vdupq_n_s32(0x3f);
+  const int32x4_t ymask = vdupq_n_s32(0xfc0);
+  int32x4_t x0 = vaddq_s32(vdupq_n_s32(xfrac), vld1q_s32(xoffs));
+  int32x4_t y0 = vaddq_s32(vdupq_n_s32(yfrac), vld1q_s32(yoffs));
+  int32x4_t x1 = vaddq_s32(x0, vdupq_n_s32((int32_t)(4u*xstep)));
+  int32x4_t y1 = vaddq_s32(y0, vdupq_n_s32((int32_t)(4u*ystep)));
+  uint16x8_t xa, xb, ya, yb, fx, fy, ifx, ify;
+
+  // Texel columns and rows either side of the sample point
+  xa = R_SpanNarrow(vandq_s32(vshrq_n_s32(x0, 16), xmask),
+                    vandq_s32(vshrq_n_s32(x1, 16), xmask));
+  xb = R_SpanNarrow(vandq_s32(vshrq_n_s32(vaddq_s32(x0, one), 16), xmask),
+                    vandq_s32(vshrq_n_s32(vaddq_s32(x1, one), 16), xmask));
+  ya = R_SpanNarrow(vandq_s32(vshrq_n_s32(y0, 10), ymask),
+                    vandq_s32(vshrq_n_s32(y1, 10), ymask));
+  yb = R_SpanNarrow(vandq_s32(vshrq_n_s32(vaddq_s32(y0, one), 10), ymask),
+                    vandq_s32(vshrq_n_s32(vaddq_s32(y1, one), 10), ymask));
+
+  vst1q_u16(b->spot[0], vorrq_u16(xb, yb));
+  vst1q_u16(b->spot[1], vorrq_u16(xa, yb));
+  vst1q_u16(b->spot[2], vorrq_u16(xa, ya));
+  vst1q_u16(b->spot[3], vorrq_u16(xb, ya));
+
+  fx = R_SpanNarrow(x0, x1);
+  fy = R_SpanNarrow(y0, y1);
+  ifx = vmvnq_u16(fx);
+  ify = vmvnq_u16(fy);
+
+  vst1q_u16(b->weight[0], R_SpanWeight(fx, fy));
+  vst1q_u16(b->weight[1], R_SpanWeight(ifx, fy));
+  vst1q_u16(b->weight[2], R_SpanWeight(ifx, ify));
+  vst1q_u16(b->weight[3], R_SpanWeight(fx, ify));
+}
+
+static void R_SpanStore(uint16_t *dest, const uint16_t *pixels)
+{
+  vst1q_u16(dest, vld1q_u16(pixels));
+}
+
+#endif
+
+//
+// The drawers themselves. Each block of 8 pixels is written with one
+// store; a short block at the end of the span is copied instead.
+//
+
+static SPAN_SIMD_TARGET void R_SpanWrite(uint16_t *dest, const uint16_t *pixels, unsigned count)
+{
+  if (count >= SPAN_BLOCK)
+    R_SpanStore(dest, pixels);
+  else
+    memcpy(dest, pixels, count * sizeof(*dest));
+}
+
+// Colormap used by each pixel of a block. The scalar drawers step
+// through the dither matrix backwards, one entry per pixel, so the
+// pattern repeats every block of 8.
+static void R_SpanDitherColormaps(const draw_span_vars_t *dsvars,
+  const lighttable_t *colormaps[SPAN_BLOCK])
+{
+  const int fracz = (dsvars->z >> 12) & 255;
+  int i;
+
+  for (i = 0; i < SPAN_BLOCK; i++)
+    colormaps[i] = filter_getDitheredPixelLevel(dsvars->x1 - i, dsvars->y, fracz) ?
+      dsvars->nextcolormap : dsvars->colormap;
+}
+
+static SPAN_SIMD_TARGET void R_DrawSpanSIMD_PointUV(draw_span_vars_t *dsvars,
+  const lighttable_t *colormaps[SPAN_BLOCK])
+{
+  unsigned count = dsvars->x2 - dsvars->x1 + 1;
+  fixed_t xfrac = dsvars->xfrac;
+  fixed_t yfrac = dsvars->yfrac;
+  const fixed_t xstep = dsvars->xstep;
+  const fixed_t ystep = dsvars->ystep;
+  const uint8_t *source = dsvars->source;
+  uint16_t *dest = drawvars.short_topleft + dsvars->y*SCREENWIDTH + dsvars->x1;
+  span_point_block_t b;
+  uint16_t pixels[SPAN_BLOCK];
+  int i;
+
+  while (count)
+  {
+    R_SpanPointBlock(xfrac, yfrac, xstep, ystep, &b);
+    for (i = 0; i < SPAN_BLOCK; i++)
+      pixels[i] = VID_PAL16(colormaps[i][source[b.spot[i]]], VID_COLORWEIGHTMASK);
+    R_SpanWrite(dest, pixels, count);
+
+    if (count <= SPAN_BLOCK)
+      break;
+    count -= SPAN_BLOCK;
+    dest += SPAN_BLOCK;
+    xfrac += SPAN_BLOCK*xstep;
+    yfrac += SPAN_BLOCK*ystep;
+  }
+}
+
+static SPAN_SIMD_TARGET void R_DrawSpanSIMD_LinearUV(draw_span_vars_t *dsvars,
+  const lighttable_t *colormaps[SPAN_BLOCK])
+{
+  unsigned count = dsvars->x2 - dsvars->x1 + 1;
+  fixed_t xfrac = dsvars->xfrac;
+  fixed_t yfrac = dsvars->yfrac;
+  const fixed_t xstep = dsvars->xstep;
+  const fixed_t ystep = dsvars->ystep;
+  const uint8_t *source = dsvars->source;
+  uint16_t *dest = drawvars.short_topleft + dsvars->y*SCREENWIDTH + dsvars->x1;
+  span_linear_block_t b;
+  uint16_t pixels[SPAN_BLOCK];
+  int i;
+
+  while (count)
+  {
+    R_SpanLinearBlock(xfrac, yfrac, xstep, ystep, &b);
+    for (i = 0; i < SPAN_BLOCK; i++)
+      pixels[i] = VID_PAL16(colormaps[i][source[b.spot[0][i]]], b.weight[0][i]) +
+                  VID_PAL16(colormaps[i][source[b.spot[1][i]]], b.weight[1][i]) +
+                  VID_PAL16(colormaps[i][source[b.spot[2][i]]], b.weight[2][i]) +
+                  VID_PAL16(colormaps[i][source[b.spot[3][i]]], b.weight[3][i]);
+    R_SpanWrite(dest, pixels, count);
+
+    if (count <= SPAN_BLOCK)
+      break;
+    count -= SPAN_BLOCK;
+    dest += SPAN_BLOCK;
+    xfrac += SPAN_BLOCK*xstep;
+    yfrac += SPAN_BLOCK*ystep;
+  }
+}
+
+static void R_DrawSpanSIMD_PointUV_PointZ(draw_span_vars_t *dsvars)
+{
+  const lighttable_t *colormaps[SPAN_BLOCK];
+  int i;
+
+  for (i = 0; i < SPAN_BLOCK; i++)
+    colormaps[i] = dsvars->colormap;
+  R_DrawSpanSIMD_PointUV(dsvars, colormaps);
+}
+
+static void R_DrawSpanSIMD_PointUV_LinearZ(draw_span_vars_t *dsvars)
+{
+  const lighttable_t *colormaps[SPAN_BLOCK];
+
+  R_SpanDitherColormaps(dsvars, colormaps);
+  R_DrawSpanSIMD_PointUV(dsvars, colormaps);
+}
+
+static void R_DrawSpanSIMD_LinearUV_PointZ(draw_span_vars_t *dsvars)
+{
+  const lighttable_t *colormaps[SPAN_BLOCK];
+  int i;
+
+  if ((D_abs(dsvars->xstep) > drawvars.mag_threshold)
+      || (D_abs(dsvars->ystep) > drawvars.mag_threshold))
+  {
+    R_GetDrawSpanFunc(RDRAW_FILTER_POINT, drawvars.filterz)(dsvars);
+    return;
+  }
+
+  for (i = 0; i < SPAN_BLOCK; i++)
+    colormaps[i] = dsvars->colormap;
+  R_DrawSpanSIMD_LinearUV(dsvars, colormaps);
+}
+
+static void R_DrawSpanSIMD_LinearUV_LinearZ(draw_span_vars_t *dsvars)
+{
+  const lighttable_t *colormaps[SPAN_BLOCK];
+
+  if ((D_abs(dsvars->xstep) > drawvars.mag_threshold)
+      || (D_abs(dsvars->ystep) > drawvars.mag_threshold))
+  {
+    R_GetDrawSpanFunc(RDRAW_FILTER_POINT, drawvars.filterz)(dsvars);
+    return;
+  }
+
+  R_SpanDitherColormaps(dsvars, colormaps);
+  R_DrawSpanSIMD_LinearUV(dsvars, colormaps);
+}
+
+static dbool R_HaveSIMD(void)
+{
+#ifdef SPAN_SSE2_RUNTIME
+  return __builtin_cpu_supports("sse2");
+#else
+  return true;
+#endif
+}
+
+#endif /* SPAN_SSE2 || SPAN_NEON */
+
+//
+// R_GetDrawSpanFuncSIMD
+// Returns the SIMD drawer for a filter combination, or NULL when there
+// isn't one or the CPU can't run it. The rounded filter has no SIMD
+// version; its texel choice depends on the texels themselves.
+//
+
+R_DrawSpan_f R_GetDrawSpanFuncSIMD(enum draw_filter_type_e filter,
+                                   enum draw_filter_type_e filterz)
+{
+#if defined(SPAN_SSE2) || defined(SPAN_NEON)
+  if (!R_HaveSIMD())
+    return NULL;
+
+  if (filterz == RDRAW_FILTER_POINT)
+  {
+    if (filter == RDRAW_FILTER_POINT)
+      return R_DrawSpanSIMD_PointUV_PointZ;
+    if (filter == RDRAW_FILTER_LINEAR)
+      return R_DrawSpanSIMD_LinearUV_PointZ;
+  }
+  else if (filterz == RDRAW_FILTER_LINEAR)
+  {
+    if (filter == RDRAW_FILTER_POINT)
+      return R_DrawSpanSIMD_PointUV_LinearZ;
+    if (filter == RDRAW_FILTER_LINEAR)
+      return R_DrawSpanSIMD_LinearUV_LinearZ;
+  }
+#endif
+  return NULL;
+}
@@ -30,6 +30,7 @@
 
 #include "doomtype.h"
 #include "r_filter.h"
+#include "r_thread.h"
 
 #define DMR 16
 uint8_t filter_ditherMatrix[DITHER_DIM][DITHER_DIM] = {
@@ -99,8 +100,8 @@ uint8_t *filter_getScale2xQuadColors(uint8_t e, uint8_t b, uint8_t f, uint8_t h,
   // D E F
   // G H I
   // perform the Scale2x algorithm (quickly) to get the new quad to represent E
-  static uint8_t quad[5];
-  static uint8_t rowColors[3];
+  static R_THREADLOCAL uint8_t quad[5];
+  static R_THREADLOCAL uint8_t rowColors[3];
   int code;
   
   rowColors[0] = d;
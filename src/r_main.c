@@ -53,6 +53,8 @@
 #include "g_game.h"
 #include "r_demo.h"
 #include "r_fps.h"
+#include "r_thread.h"
+#include "d_bench.h"
 
 // Fineangles in the SCREENWIDTH wide window.
 #define FIELDOFVIEW 2048
@@ -623,13 +625,64 @@ int autodetect_hom = 0;       // killough 2/7/98: HOM autodetection flag
 // R_ShowStats
 //
 int rendered_visplanes, rendered_segs, rendered_vissprites;
+int rendered_visplane_chain; // longest visplane hash chain searched
 dbool   rendering_stats;
 
+//
+// Split-screen rendering
+//
+// With several render threads the view is cut into vertical strips,
+// one per thread. Walls and sprites are drawn a column at a time and
+// so go to the strip owning the column; visplanes are drawn a row at
+// a time, so each thread takes a band of rows for those instead. Each
+// pass finishes before the next starts, so every pixel is still drawn
+// by the same calls in the same order as when drawing serially. The
+// spectre fuzz pattern runs on from one column to the next, so a
+// masked pass with fuzz in it is drawn serially.
+//
+
+static int strip_width, band_height;
+
+static void R_GetRenderStrip(int strip, int *x1, int *x2)
+{
+  *x1 = strip * strip_width;
+  *x2 = *x1 + strip_width - 1;
+  if (*x2 >= viewwidth)
+    *x2 = viewwidth-1;
+}
+
+static void R_DrawWallsStrip(int strip)
+{
+  R_DrawColumnQueue(strip);
+  R_ResetColumnBuffer();
+}
+
+static void R_DrawPlanesBand(int band)
+{
+  int y1 = band * band_height;
+  int y2 = band == render_threads-1 ? viewheight-1 : y1 + band_height - 1;
+
+  R_DrawPlanesRange(y1, y2);
+  R_ResetColumnBuffer();
+}
+
+static void R_DrawMaskedStrip(int strip)
+{
+  int x1, x2;
+
+  R_GetRenderStrip(strip, &x1, &x2);
+  if (x1 <= x2)
+    R_DrawMaskedRange(x1, x2);
+  R_ResetColumnBuffer();
+}
+
 //
 // R_RenderView
 //
 void R_RenderPlayerView (player_t* player)
 {
+  int strips = render_threads;
+
   R_SetupFrame (player);
 
   // Clear buffers.
@@ -639,6 +692,13 @@ void R_RenderPlayerView (player_t* player)
   R_ClearSprites ();
 
   rendered_segs = rendered_visplanes = 0;
+
+  // Strips start on a 32 pixel boundary so that no two threads
+  // write to the same cache line
+  strip_width = ((viewwidth + strips - 1) / strips + 31) & ~31;
+  band_height = viewheight / strips;
+  R_SetColumnQueue(strips, strip_width);
+
     if (autodetect_hom)
     { // killough 2/10/98: add flashing red HOM indicators
       unsigned char color=(gametic % 20) < 9 ? 0xb0 : 0;
@@ -651,23 +711,52 @@ void R_RenderPlayerView (player_t* player)
 #endif
 
   // The head node is the last node output.
+  BENCH_BEGIN(BENCH_BSP);
   R_RenderBSPNode (numnodes-1);
   R_ResetColumnBuffer();
+  if (strips > 1)
+    R_RunRenderThreads (R_DrawWallsStrip);
+  BENCH_END(BENCH_BSP);
 
   // Check for new console commands.
 #ifdef HAVE_NET
   NetUpdate ();
 #endif
 
+  if (strips > 1)
+  {
+    BENCH_BEGIN(BENCH_PLANES);
+    R_SetupDrawPlanes ();
+    R_RunRenderThreads (R_DrawPlanesBand);
+    BENCH_END(BENCH_PLANES);
+
+    BENCH_BEGIN(BENCH_MASKED);
+    R_SortVisSprites ();
+    if (R_MaskedFuzz ())
+    {
+      R_DrawMaskedRange (0, viewwidth-1);
+      R_ResetColumnBuffer();
+    }
+    else
+      R_RunRenderThreads (R_DrawMaskedStrip);
+    BENCH_END(BENCH_MASKED);
+  }
+  else
+  {
+    BENCH_BEGIN(BENCH_PLANES);
     R_DrawPlanes ();
+    BENCH_END(BENCH_PLANES);
 
   // Check for new console commands.
 #ifdef HAVE_NET
-  NetUpdate ();
+    NetUpdate ();
 #endif
 
+    BENCH_BEGIN(BENCH_MASKED);
     R_DrawMasked ();
     R_ResetColumnBuffer();
+    BENCH_END(BENCH_MASKED);
+  }
 
   // Check for new console commands.
 #ifdef HAVE_NET
@@ -61,6 +61,7 @@ extern fixed_t skyiscale;
 //
 
 extern int rendered_visplanes, rendered_segs, rendered_vissprites;
+extern int rendered_visplane_chain;
 extern dbool   rendering_stats;
 
 //
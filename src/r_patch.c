@@ -695,7 +695,12 @@ const rpatch_t *R_CachePatchNum(int id) {
   }
 
   if (!patches[id].data)
+  {
+    cachestats.misses++;
     createPatch(id);
+  }
+  else
+    cachestats.hits++;
 
   /* cph - if wasn't locked but now is, tell z_zone to hold it */
   if (!patches[id].locks && locks) {
@@ -725,7 +730,12 @@ const rpatch_t *R_CacheTextureCompositePatchNum(int id) {
     I_Error("R_CacheTextureCompositePatchNum: Composite patches not initialized");
 
   if (!texture_composites[id].data)
+  {
+    cachestats.misses++;
     createTextureCompositePatch(id);
+  }
+  else
+    cachestats.hits++;
 
   /* cph - if wasn't locked but now is, tell z_zone to hold it */
   if (!texture_composites[id].locks && locks) {
@@ -31,10 +31,10 @@
  *       while maintaining a per column clipping list only.
  *      Moreover, the sky areas have to be determined.
  *
- * MAXVISPLANES is no longer a limit on the number of visplanes,
- * but a limit on the number of hash slots; larger numbers mean
- * better performance usually but after a point they are wasted,
- * and memory and time overheads creep in.
+ * The number of hash slots follows the number of visplanes in the
+ * previous frame (and grows during a frame that needs many more), so
+ * chains stay short at any resolution. Visplanes and their columns
+ * come from an arena that is rewound every frame.
  *
  * For more information on visplanes, see:
  *
@@ -56,20 +56,43 @@
 #include "r_sky.h"
 #include "r_plane.h"
 #include "v_video.h"
+#include "r_thread.h"
 #include "lprintf.h"
 
-#define MAXVISPLANES 128    /* must be a power of 2 */
+#define MINVISPLANEHASH 128    /* must be a power of 2 */
+#define PLANEBLOCK 64          /* visplanes per arena block */
 
-static visplane_t *visplanes[MAXVISPLANES];   // killough
-static visplane_t *freetail;                  // killough
-static visplane_t **freehead = &freetail;     // killough
+static visplane_t **visplanes;                // killough
+static unsigned numvisplanehash;              // slots in visplanes[]
+static int visplanehashshift;                 // 32 - log2(numvisplanehash)
 visplane_t *floorplane, *ceilingplane;
 
+// Every visplane of this frame, in the order they were made, or sorted
+// by flat and light level when r_sortvisplanes is set
+dbool r_sortvisplanes = true;
+static visplane_t **planelist;
+static int numplanes, maxplanes;
+
+// Per-frame arena the visplanes and their columns are carved from
+typedef struct planeblock_s {
+  struct planeblock_s *next;
+} planeblock_t;
+
+#define PLANEBLOCKHEADER ((sizeof(planeblock_t) + 7) & ~7)
+
+static planeblock_t *planeblocks;
+static planeblock_t *curblock;
+static int curslot;
+static int planearenawidth;
+static size_t planeslotsize;
+
 // killough -- hash function for visplanes
-// Empirically verified to be fairly uniform:
+// Empirically verified to be fairly uniform; the multiply spreads it
+// over the top bits, which index tables of any size
 
 #define visplane_hash(picnum,lightlevel,height) \
-  ((unsigned)((picnum)*3+(lightlevel)+(height)*7) & (MAXVISPLANES-1))
+  ((((unsigned)(picnum)*3+(lightlevel)+((height)>>FRACBITS)*7) * 2654435761u) \
+   >> visplanehashshift)
 
 size_t maxopenings;
 int *openings,*lastopening; // dropoff overflow
@@ -82,14 +105,14 @@ int floorclip[MAX_SCREENWIDTH], ceilingclip[MAX_SCREENWIDTH]; // dropoff overflo
 
 // spanstart holds the start of a plane span; initialized to 0 at start
 
-static int spanstart[MAX_SCREENHEIGHT];                // killough 2/8/98
+static R_THREADLOCAL int spanstart[MAX_SCREENHEIGHT];                // killough 2/8/98
 
 //
 // texture mapping
 //
 
-static const lighttable_t **planezlight;
-static fixed_t planeheight;
+static R_THREADLOCAL const lighttable_t **planezlight;
+static R_THREADLOCAL fixed_t planeheight;
 
 // killough 2/8/98: make variables static
 
@@ -98,7 +121,11 @@ static fixed_t cachedheight[MAX_SCREENHEIGHT];
 static fixed_t cacheddistance[MAX_SCREENHEIGHT];
 static fixed_t cachedxstep[MAX_SCREENHEIGHT];
 static fixed_t cachedystep[MAX_SCREENHEIGHT];
-static fixed_t xoffs,yoffs;    // killough 2/28/98: flat offsets
+static R_THREADLOCAL fixed_t xoffs,yoffs;    // killough 2/28/98: flat offsets
+
+// Rows R_DoDrawPlane may draw; render threads each take a band of rows,
+// which also keeps their use of the cached* arrays above apart
+static R_THREADLOCAL int spany1, spany2;
 
 fixed_t yslope[MAX_SCREENHEIGHT], distscale[MAX_SCREENWIDTH];
 
@@ -135,6 +162,9 @@ static void R_MapPlane(int y, int x1, int x2, draw_span_vars_t *dsvars)
    int dx, dy;
    unsigned index;
 
+   if (y < spany1 || y > spany2)
+      return;
+
    if ((dy = abs(centery - y)) == 0)
       return; // skip early if there's no change
 
@@ -182,6 +212,70 @@ static void R_MapPlane(int y, int x1, int x2, draw_span_vars_t *dsvars)
    R_DrawSpan(dsvars);
 }
 
+//
+// R_ResizePlaneHash
+// Sets the number of hash slots and rehashes this frame's visplanes
+//
+
+static void R_ResizePlaneHash(unsigned size)
+{
+  int i;
+
+  free(visplanes);
+  visplanes = calloc(size, sizeof *visplanes);
+  numvisplanehash = size;
+  for (visplanehashshift = 32; size > 1; size >>= 1)
+    visplanehashshift--;
+
+  for (i = 0; i < numplanes; i++)
+  {
+    visplane_t *pl = planelist[i];
+    unsigned hash = visplane_hash(pl->picnum, pl->lightlevel, pl->height);
+    pl->next = visplanes[hash];
+    visplanes[hash] = pl;
+  }
+}
+
+//
+// R_ClearPlaneArena
+// Rewinds the visplane arena, sizes the hash table for about as many
+// visplanes as the last frame had and starts a new frame's plane list.
+//
+
+static void R_ClearPlaneArena(void)
+{
+  unsigned size = MINVISPLANEHASH;
+
+  while (size < (unsigned)numplanes)
+    size <<= 1;
+
+  numplanes = 0;
+  rendered_visplane_chain = 0;
+
+  // Shrink only well below the current size so it doesn't flip-flop
+  if (size > numvisplanehash || size * 4 <= numvisplanehash)
+    R_ResizePlaneHash(size);
+  else
+    memset(visplanes, 0, numvisplanehash * sizeof *visplanes);
+
+  // Column arrays are viewwidth long, start over when that changes
+  if (planearenawidth != viewwidth)
+  {
+    while (planeblocks)
+    {
+      planeblock_t *next = planeblocks->next;
+      free(planeblocks);
+      planeblocks = next;
+    }
+    planearenawidth = viewwidth;
+    // top and bottom with a pad either side, after the visplane itself
+    planeslotsize = (sizeof(visplane_t) + (viewwidth + 2) * 2 * sizeof(unsigned int) + 7) & ~7;
+  }
+
+  curblock = NULL;
+  curslot = PLANEBLOCK;
+}
+
 //
 // R_ClearPlanes
 // At begining of frame.
@@ -198,9 +292,7 @@ void R_ClearPlanes(void)
       ceilingclip[i] = -1;
    }
 
-   for (i=0;i<MAXVISPLANES;i++)    // new code -- killough
-      for (*freehead = visplanes[i], visplanes[i] = NULL; *freehead; )
-         freehead = &(*freehead)->next;
+   R_ClearPlaneArena();
 
    lastopening = openings;
 
@@ -214,14 +306,52 @@ void R_ClearPlanes(void)
 
 // New function, by Lee Killough
 
-static visplane_t *new_visplane(unsigned hash)
+static visplane_t *new_visplane(int picnum, int lightlevel, fixed_t height)
 {
-  visplane_t *check = freetail;
-  if (!check)
-    check = calloc(1, sizeof *check);
-  else
-    if (!(freetail = freetail->next))
-      freehead = &freetail;
+  visplane_t *check;
+  unsigned int *columns;
+  unsigned hash;
+
+  // Frame with far more visplanes than the last one; don't wait for
+  // the next frame to make room
+  if ((unsigned)numplanes >= numvisplanehash * 2)
+    R_ResizePlaneHash(numvisplanehash * 4);
+
+  if (curslot == PLANEBLOCK)
+  {
+    planeblock_t *next = curblock ? curblock->next : planeblocks;
+
+    if (!next)
+    {
+      next = malloc(PLANEBLOCKHEADER + PLANEBLOCK * planeslotsize);
+      next->next = NULL;
+      if (curblock)
+        curblock->next = next;
+      else
+        planeblocks = next;
+    }
+    curblock = next;
+    curslot = 0;
+  }
+
+  check = (visplane_t *)((char *)curblock + PLANEBLOCKHEADER +
+                         curslot++ * planeslotsize);
+  columns = (unsigned int *)(check + 1);
+  check->top = columns + 1;
+  check->bottom = columns + viewwidth + 3;
+  check->bottom[-1] = check->bottom[viewwidth] = 0;
+  check->picnum = picnum;
+  check->lightlevel = lightlevel;
+  check->height = height;
+
+  if (numplanes == maxplanes)
+  {
+    maxplanes = maxplanes ? maxplanes * 2 : 128;
+    planelist = realloc(planelist, maxplanes * sizeof *planelist);
+  }
+  planelist[numplanes++] = check;
+
+  hash = visplane_hash(picnum, lightlevel, height);
   check->next = visplanes[hash];
   visplanes[hash] = check;
   return check;
@@ -234,17 +364,13 @@ static visplane_t *new_visplane(unsigned hash)
  */
 visplane_t *R_DupPlane(const visplane_t *pl, int start, int stop)
 {
-      unsigned hash = visplane_hash(pl->picnum, pl->lightlevel, pl->height);
-      visplane_t *new_pl = new_visplane(hash);
+      visplane_t *new_pl = new_visplane(pl->picnum, pl->lightlevel, pl->height);
 
-      new_pl->height = pl->height;
-      new_pl->picnum = pl->picnum;
-      new_pl->lightlevel = pl->lightlevel;
       new_pl->xoffs = pl->xoffs;           // killough 2/28/98
       new_pl->yoffs = pl->yoffs;
       new_pl->minx = start;
       new_pl->maxx = stop;
-      memset(new_pl->top, 0xff, sizeof new_pl->top);
+      memset(new_pl->top, 0xff, viewwidth * sizeof *new_pl->top);
       return new_pl;
 }
 //
@@ -257,6 +383,7 @@ visplane_t *R_FindPlane(fixed_t height, int picnum, int lightlevel,
 {
    visplane_t *check;
    unsigned hash;                      // killough
+   int chain = 0;
 
    if (picnum == skyflatnum || picnum & PL_SKYFLAT)
       height = lightlevel = 0;         // killough 7/19/98: most skies map together
@@ -264,25 +391,27 @@ visplane_t *R_FindPlane(fixed_t height, int picnum, int lightlevel,
    // New visplane algorithm uses hash table -- killough
    hash = visplane_hash(picnum,lightlevel,height);
 
-   for (check=visplanes[hash]; check; check=check->next)  // killough
+   for (check=visplanes[hash]; check; check=check->next, chain++)  // killough
       if (height == check->height &&
             picnum == check->picnum &&
             lightlevel == check->lightlevel &&
             xoffs == check->xoffs &&      // killough 2/28/98: Add offset checks
             yoffs == check->yoffs)
-         return check;
+         break;
 
-   check = new_visplane(hash);         // killough
+   if (chain > rendered_visplane_chain)
+      rendered_visplane_chain = chain;
+   if (check)
+      return check;
+
+   check = new_visplane(picnum, lightlevel, height);   // killough
 
-   check->height = height;
-   check->picnum = picnum;
-   check->lightlevel = lightlevel;
    check->minx = viewwidth; // Was SCREENWIDTH -- killough 11/98
    check->maxx = -1;
    check->xoffs = xoffs;               // killough 2/28/98: Save offsets
    check->yoffs = yoffs;
 
-   memset (check->top, 0xff, sizeof check->top);
+   memset (check->top, 0xff, viewwidth * sizeof *check->top);
 
    return check;
 }
@@ -351,8 +480,9 @@ static void R_MakeSpans(int x, unsigned int t1, unsigned int b1,
 }
 
 // New function, by Lee Killough
+// flat is the plane's flat, already locked by the caller
 
-static void R_DoDrawPlane(visplane_t *pl)
+static void R_DoDrawPlane(visplane_t *pl, const uint8_t *flat)
 {
    int x;
    draw_column_vars_t dcvars;
@@ -431,27 +561,37 @@ static void R_DoDrawPlane(visplane_t *pl)
          dcvars.texheight = textureheight[texture]>>FRACBITS; // killough
          dcvars.iscale = skyiscale;
 
+         R_LockRenderCache();
          tex_patch = R_CacheTextureCompositePatchNum(texture);
+         R_UnlockRenderCache();
 
          // killough 10/98: Use sky scrolling offset, and possibly flip picture
          for (x = pl->minx; (dcvars.x = x) <= pl->maxx; x++)
             if ((dcvars.yl = pl->top[x]) != -1 && dcvars.yl <= (dcvars.yh = pl->bottom[x])) // dropoff overflow
             {
+               if (dcvars.yl < spany1)
+                  dcvars.yl = spany1;
+               if (dcvars.yh > spany2)
+                  dcvars.yh = spany2;
+               if (dcvars.yl > dcvars.yh)
+                  continue;
+
                dcvars.source = R_GetTextureColumn(tex_patch, ((an + xtoviewangle[x])^flip) >> ANGLETOSKYSHIFT);
                dcvars.prevsource = R_GetTextureColumn(tex_patch, ((an + xtoviewangle[x-1])^flip) >> ANGLETOSKYSHIFT);
                dcvars.nextsource = R_GetTextureColumn(tex_patch, ((an + xtoviewangle[x+1])^flip) >> ANGLETOSKYSHIFT);
                colfunc(&dcvars);
             }
 
+         R_LockRenderCache();
          R_UnlockTextureCompositePatchNum(texture);
-
+         R_UnlockRenderCache();
       }
       else
       {     // regular flat
          int stop, light;
          draw_span_vars_t dsvars;
 
-         dsvars.source = W_CacheLumpNum(firstflat + flattranslation[pl->picnum]);
+         dsvars.source = flat;
 
          xoffs = pl->xoffs;  // killough 2/28/98: Add offsets
          yoffs = pl->yoffs;
@@ -466,13 +606,10 @@ static void R_DoDrawPlane(visplane_t *pl)
 
          stop = pl->maxx + 1;
          planezlight = zlight[light];
-         pl->top[pl->minx-1] = pl->top[stop] = 0xffffffffu; // dropoff overflow
 
          for (x = pl->minx ; x <= stop ; x++)
             R_MakeSpans(x,pl->top[x-1],pl->bottom[x-1],
                   pl->top[x],pl->bottom[x], &dsvars);
-
-         W_UnlockLumpNum(firstflat + flattranslation[pl->picnum]);
       }
    }
 }
@@ -483,13 +620,87 @@ static void R_DoDrawPlane(visplane_t *pl)
 //
 
 void R_DrawPlanes (void)
+{
+  R_SetupDrawPlanes();
+  R_DrawPlanesRange(0, viewheight-1);
+}
+
+//
+// R_SetupDrawPlanes
+// Prepares the visplanes for R_DrawPlanesRange; called once per frame
+// before the planes are drawn, from the main thread.
+//
+
+static int R_CompareVisplanes(const void *a, const void *b)
+{
+  const visplane_t *x = *(const visplane_t *const *)a;
+  const visplane_t *y = *(const visplane_t *const *)b;
+
+  if (x->picnum != y->picnum)
+    return x->picnum < y->picnum ? -1 : 1;
+  if (x->lightlevel != y->lightlevel)
+    return x->lightlevel < y->lightlevel ? -1 : 1;
+  return x->height < y->height ? -1 : x->height > y->height;
+}
+
+void R_SetupDrawPlanes (void)
 {
   int i;
-  visplane_t *pl;
 
-  for (i=0;i<MAXVISPLANES;i++)
+  // Planes never overlap on screen, so any order draws the same
+  // picture; grouping them keeps each flat and colormap hot
+  if (r_sortvisplanes)
+    qsort(planelist, numplanes, sizeof *planelist, R_CompareVisplanes);
+
+  for (i=0;i<numplanes;i++)
+  {
+     visplane_t *pl = planelist[i];
+     if (pl->minx <= pl->maxx)
+        pl->top[pl->minx-1] = pl->top[pl->maxx+1] = 0xffffffffu; // dropoff overflow
+  }
+  rendered_visplanes = numplanes;
+}
+
+//
+// R_DrawPlanesRange
+// Draws the part of every visplane that lies on rows y1 to y2.
+// Each render thread draws its own band of rows this way.
+//
+
+void R_DrawPlanesRange (int y1, int y2)
+{
+  int i;
+  int flatlump = -1;
+  const uint8_t *flat = NULL;
+
+  spany1 = y1;
+  spany2 = y2;
+
+  for (i=0;i<numplanes;i++)
+  {
+     visplane_t *pl = planelist[i];
+
+     // Keep the flat locked while consecutive planes use it
+     if (pl->minx <= pl->maxx && pl->picnum != skyflatnum && !(pl->picnum & PL_SKYFLAT))
+     {
+        int lump = firstflat + flattranslation[pl->picnum];
+
+        if (lump != flatlump)
+        {
+           R_LockRenderCache();
+           if (flatlump >= 0)
+              W_UnlockLumpNum(flatlump);
+           flat = W_CacheLumpNum(flatlump = lump);
+           R_UnlockRenderCache();
+        }
+     }
+     R_DoDrawPlane(pl, flat);
+  }
+
+  if (flatlump >= 0)
   {
-     for (pl=visplanes[i]; pl; pl=pl->next, rendered_visplanes++)
-        R_DoDrawPlane(pl);
+     R_LockRenderCache();
+     W_UnlockLumpNum(flatlump);
+     R_UnlockRenderCache();
   }
 }
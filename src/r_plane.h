@@ -45,9 +45,13 @@ extern int *lastopening; // dropoff overflow
 extern int floorclip[], ceilingclip[]; // dropoff overflow
 extern fixed_t yslope[], distscale[];
 
+extern dbool r_sortvisplanes; /* draw visplanes grouped by flat */
+
 void R_InitPlanes(void);
 void R_ClearPlanes(void);
 void R_DrawPlanes (void);
+void R_SetupDrawPlanes (void);
+void R_DrawPlanesRange (int y1, int y2);
 
 visplane_t *R_FindPlane(
                         fixed_t height,
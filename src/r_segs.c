@@ -73,11 +73,11 @@ static int      rw_stopx;
 static angle_t  rw_centerangle;
 static fixed_t  rw_offset;
 static fixed_t  rw_scale;
-static fixed_t  rw_scalestep;
+static R_THREADLOCAL fixed_t rw_scalestep; // also used by masked drawing
 static fixed_t  rw_midtexturemid;
 static fixed_t  rw_toptexturemid;
 static fixed_t  rw_bottomtexturemid;
-static int      rw_lightlevel;
+static R_THREADLOCAL int rw_lightlevel;
 static int      worldtop;
 static int      worldbottom;
 static int      worldhigh;
@@ -90,7 +90,7 @@ static fixed_t  topfrac;
 static fixed_t  topstep;
 static fixed_t  bottomfrac;
 static fixed_t  bottomstep;
-static int      *maskedtexturecol; // dropoff overflow
+static R_THREADLOCAL int *maskedtexturecol; // dropoff overflow
 
 //
 // R_FixWiggle()
@@ -280,7 +280,9 @@ void R_RenderMaskedSegRange(drawseg_t *ds, int x1, int x2)
       dcvars.nextcolormap = dcvars.colormap; // for filtering -- POPE
    }
 
+   R_LockRenderCache();
    patch = R_CacheTextureCompositePatchNum(texnum);
+   R_UnlockRenderCache();
 
    /* draw the columns */
 
@@ -342,7 +344,9 @@ void R_RenderMaskedSegRange(drawseg_t *ds, int x1, int x2)
       maskedtexturecol[dcvars.x] = INT_MAX; // dropoff overflow
    }
 
+   R_LockRenderCache();
    R_UnlockTextureCompositePatchNum(texnum);
+   R_UnlockRenderCache();
 
    curline = NULL; /* cph 2001/11/18 - must clear curline now we're done with it, so R_ColourMap doesn't try using it for other things */
 }
@@ -447,7 +451,7 @@ static void R_RenderSegLoop (void)
          dcvars.prevsource = R_GetTextureColumn(tex_patch, texturecolumn-1);
          dcvars.nextsource = R_GetTextureColumn(tex_patch, texturecolumn+1);
          dcvars.texheight = midtexheight;
-         colfunc (&dcvars);
+         R_DrawWallColumn(colfunc, &dcvars);
          R_UnlockTextureCompositePatchNum(midtexture);
          tex_patch = NULL;
          ceilingclip[rw_x] = viewheight;
@@ -476,7 +480,7 @@ static void R_RenderSegLoop (void)
                dcvars.prevsource = R_GetTextureColumn(tex_patch,texturecolumn-1);
                dcvars.nextsource = R_GetTextureColumn(tex_patch,texturecolumn+1);
                dcvars.texheight = toptexheight;
-               colfunc (&dcvars);
+               R_DrawWallColumn(colfunc, &dcvars);
                R_UnlockTextureCompositePatchNum(toptexture);
                tex_patch = NULL;
                ceilingclip[rw_x] = mid;
@@ -510,7 +514,7 @@ static void R_RenderSegLoop (void)
                dcvars.prevsource = R_GetTextureColumn(tex_patch, texturecolumn-1);
                dcvars.nextsource = R_GetTextureColumn(tex_patch, texturecolumn+1);
                dcvars.texheight = bottomtexheight;
-               colfunc (&dcvars);
+               R_DrawWallColumn(colfunc, &dcvars);
                R_UnlockTextureCompositePatchNum(bottomtexture);
                tex_patch = NULL;
                floorclip[rw_x] = mid;
@@ -40,6 +40,7 @@
 #include "r_things.h"
 #include "r_fps.h"
 #include "v_video.h"
+#include "r_cache.h"
 #include "lprintf.h"
 
 #define MINZ        (FRACUNIT*4)
@@ -164,7 +165,8 @@ static void R_InitSpriteDefs(const char * const * namelist)
 
    numsprites = i;
 
-   sprites = Z_Malloc(numsprites *sizeof(*sprites), PU_STATIC, NULL);
+   // sprites with no lumps at all are left with no frames
+   sprites = Z_Calloc(numsprites, sizeof(*sprites), PU_STATIC, NULL);
 
    // Create hash table based on just the first four letters of each sprite
    // killough 1/31/98
@@ -275,7 +277,11 @@ void R_InitSprites(const char * const *namelist)
    int i;
    for (i=0; i<MAX_SCREENWIDTH; i++)    // killough 2/8/98
       negonearray[i] = -1;
-   R_InitSpriteDefs(namelist);
+   if (!R_LoadCachedSprites(namelist))
+   {
+      R_InitSpriteDefs(namelist);
+      R_CacheSprites(namelist);
+   }
 }
 
 //
@@ -315,10 +321,10 @@ static vissprite_t *R_NewVisSprite(void)
 //  in posts/runs of opaque pixels.
 //
 
-int   *mfloorclip;   // dropoff overflow
-int   *mceilingclip; // dropoff overflow
-fixed_t spryscale;
-fixed_t sprtopscreen;
+R_THREADLOCAL int   *mfloorclip;   // dropoff overflow
+R_THREADLOCAL int   *mceilingclip; // dropoff overflow
+R_THREADLOCAL fixed_t spryscale;
+R_THREADLOCAL fixed_t sprtopscreen;
 
 void R_DrawMaskedColumn(
       const rpatch_t *patch,
@@ -374,18 +380,23 @@ void R_DrawMaskedColumn(
 //
 // R_DrawVisSprite
 //  mfloorclip and mceilingclip should also be set.
+//  Only columns x1 to x2 of the sprite are drawn.
 //
 // CPhipps - new wad lump handling, *'s to const*'s
 static void R_DrawVisSprite(vissprite_t *vis, int x1, int x2)
 {
   int      texturecolumn;
   fixed_t  frac;
-  const rpatch_t *patch = R_CachePatchNum(vis->patch+firstspritelump);
+  const rpatch_t *patch;
   R_DrawColumn_f colfunc;
   draw_column_vars_t dcvars;
   enum draw_filter_type_e filter;
   enum draw_filter_type_e filterz;
 
+  R_LockRenderCache();
+  patch = R_CachePatchNum(vis->patch+firstspritelump);
+  R_UnlockRenderCache();
+
   R_SetDefaultDrawColumnVars(&dcvars);
   if (vis->mobjflags & MF_PLAYERSPRITE) {
     dcvars.edgetype = drawvars.patch_edges;
@@ -418,7 +429,7 @@ static void R_DrawVisSprite(vissprite_t *vis, int x1, int x2)
   // proff 11/06/98: Changed for high-res
   dcvars.iscale = FixedDiv (FRACUNIT, vis->scale);
   dcvars.texturemid = vis->texturemid;
-  frac = vis->startfrac;
+  frac = vis->startfrac + (x1 - vis->x1)*vis->xiscale;
   if (filter == RDRAW_FILTER_LINEAR)
     frac -= (FRACUNIT>>1);
   spryscale = vis->scale;
@@ -431,7 +442,7 @@ static void R_DrawVisSprite(vissprite_t *vis, int x1, int x2)
     sprtopscreen += (viewheight/2 - centery)<<FRACBITS;
   }
 
-  for (dcvars.x=vis->x1 ; dcvars.x<=vis->x2 ; dcvars.x++, frac += vis->xiscale)
+  for (dcvars.x=x1 ; dcvars.x<=x2 ; dcvars.x++, frac += vis->xiscale)
   {
     texturecolumn = frac>>FRACBITS;
     dcvars.texu = frac;
@@ -445,7 +456,9 @@ static void R_DrawVisSprite(vissprite_t *vis, int x1, int x2)
       R_GetPatchColumnClamped(patch, texturecolumn+1)
     );
   }
+  R_LockRenderCache();
   R_UnlockPatchNum(vis->patch+firstspritelump); // cph - release lump
+  R_UnlockRenderCache();
 }
 
 //
@@ -675,7 +688,7 @@ void R_AddSprites(subsector_t* subsec, int lightlevel)
 // R_DrawPSprite
 //
 
-static void R_DrawPSprite (pspdef_t *psp, int lightlevel)
+static void R_DrawPSprite (pspdef_t *psp, int lightlevel, int clipx1, int clipx2)
 {
    int           x1, x2;
    spritedef_t   *sprdef;
@@ -697,9 +710,13 @@ static void R_DrawPSprite (pspdef_t *psp, int lightlevel)
    flip = (dbool) sprframe->flip[0];
 
    {
-      const rpatch_t* patch = R_CachePatchNum(lump+firstspritelump);
+      const rpatch_t* patch;
       // calculate edges of the shape
       fixed_t       tx;
+
+      R_LockRenderCache();
+      patch = R_CachePatchNum(lump+firstspritelump);
+      R_UnlockRenderCache();
       tx = psp->sx-160*FRACUNIT;
 
       tx -= patch->leftoffset<<FRACBITS;
@@ -710,7 +727,9 @@ static void R_DrawPSprite (pspdef_t *psp, int lightlevel)
 
       width = patch->width;
       topoffset = patch->topoffset<<FRACBITS;
+      R_LockRenderCache();
       R_UnlockPatchNum(lump+firstspritelump);
+      R_UnlockRenderCache();
    }
 
    // off the side
@@ -756,15 +775,22 @@ static void R_DrawPSprite (pspdef_t *psp, int lightlevel)
       vis->colormap = R_ColourMap(lightlevel,
             FixedMul(pspritescale, 0x2b000));  // local light
 
+   if (clipx1 < vis->x1)
+      clipx1 = vis->x1;
+   if (clipx2 > vis->x2)
+      clipx2 = vis->x2;
+
    // proff 11/99: don't use software stuff in OpenGL
-   R_DrawVisSprite(vis, vis->x1, vis->x2);
+   if (clipx1 <= clipx2)
+      R_DrawVisSprite(vis, clipx1, clipx2);
 }
 
 //
 // R_DrawPlayerSprites
+// Draws columns x1 to x2 of the player's weapon sprites.
 //
 
-void R_DrawPlayerSprites(void)
+void R_DrawPlayerSprites(int x1, int x2)
 {
    int i, lightlevel = viewplayer->mo->subsector->sector->lightlevel;
    pspdef_t *psp;
@@ -776,7 +802,7 @@ void R_DrawPlayerSprites(void)
    // add all active psprites
    for (i=0, psp=viewplayer->psprites; i<NUMPSPRITES; i++,psp++)
       if (psp->state)
-         R_DrawPSprite (psp, lightlevel);
+         R_DrawPSprite (psp, lightlevel, x1, x2);
 }
 
 //
@@ -849,13 +875,16 @@ void R_SortVisSprites (void)
 
       msort(vissprite_ptrs, vissprite_ptrs + num_vissprite, num_vissprite);
    }
+
+   rendered_vissprites = num_vissprite;
 }
 
 //
 // R_DrawSprite
+// Draws columns x1 to x2 of a sprite, clipped against the drawsegs.
 //
 
-static void R_DrawSprite (vissprite_t* spr)
+static void R_DrawSprite (vissprite_t* spr, int x1, int x2)
 {
    drawseg_t *ds;
    int     clipbot[MAX_SCREENWIDTH]; // killough 2/8/98: // dropoff overflow
@@ -866,7 +895,7 @@ static void R_DrawSprite (vissprite_t* spr)
    fixed_t scale;
    fixed_t lowscale;
 
-   for (x = spr->x1 ; x<=spr->x2 ; x++)
+   for (x = x1 ; x<=x2 ; x++)
       clipbot[x] = cliptop[x] = -2;
 
    // Scan drawsegs from end to start for obscuring segs.
@@ -880,12 +909,12 @@ static void R_DrawSprite (vissprite_t* spr)
 
    for (ds=ds_p ; ds-- > drawsegs ; )  // new -- killough
    {      // determine if the drawseg obscures the sprite
-      if (ds->x1 > spr->x2 || ds->x2 < spr->x1 ||
+      if (ds->x1 > x2 || ds->x2 < x1 ||
             (!ds->silhouette && !ds->maskedtexturecol))
          continue;      // does not cover sprite
 
-      r1 = ds->x1 < spr->x1 ? spr->x1 : ds->x1;
-      r2 = ds->x2 > spr->x2 ? spr->x2 : ds->x2;
+      r1 = ds->x1 < x1 ? x1 : ds->x1;
+      r2 = ds->x2 > x2 ? x2 : ds->x2;
 
       if (ds->scale1 > ds->scale2)
       {
@@ -935,13 +964,13 @@ static void R_DrawSprite (vissprite_t* spr)
             (h >>= FRACBITS) < viewheight) {
          if (mh <= 0 || (phs != -1 && viewz > sectors[phs].floorheight))
          {                          // clip bottom
-            for (x=spr->x1 ; x<=spr->x2 ; x++)
+            for (x=x1 ; x<=x2 ; x++)
                if (clipbot[x] == -2 || h < clipbot[x])
                   clipbot[x] = h;
          }
          else                        // clip top
             if (phs != -1 && viewz <= sectors[phs].floorheight) // killough 11/98
-               for (x=spr->x1 ; x<=spr->x2 ; x++)
+               for (x=x1 ; x<=x2 ; x++)
                   if (cliptop[x] == -2 || h > cliptop[x])
                      cliptop[x] = h;
       }
@@ -951,12 +980,12 @@ static void R_DrawSprite (vissprite_t* spr)
             (h >>= FRACBITS) < viewheight) {
          if (phs != -1 && viewz >= sectors[phs].ceilingheight)
          {                         // clip bottom
-            for (x=spr->x1 ; x<=spr->x2 ; x++)
+            for (x=x1 ; x<=x2 ; x++)
                if (clipbot[x] == -2 || h < clipbot[x])
                   clipbot[x] = h;
          }
          else                       // clip top
-            for (x=spr->x1 ; x<=spr->x2 ; x++)
+            for (x=x1 ; x<=x2 ; x++)
                if (cliptop[x] == -2 || h > cliptop[x])
                   cliptop[x] = h;
       }
@@ -966,7 +995,7 @@ static void R_DrawSprite (vissprite_t* spr)
    // all clipping has been performed, so draw the sprite
    // check for unclipped columns
 
-   for (x = spr->x1 ; x<=spr->x2 ; x++) {
+   for (x = x1 ; x<=x2 ; x++) {
       if (clipbot[x] == -2)
          clipbot[x] = viewheight;
 
@@ -976,7 +1005,7 @@ static void R_DrawSprite (vissprite_t* spr)
 
    mfloorclip = clipbot;
    mceilingclip = cliptop;
-   R_DrawVisSprite (spr, spr->x1, spr->x2);
+   R_DrawVisSprite (spr, x1, x2);
 }
 
 //
@@ -984,17 +1013,52 @@ static void R_DrawSprite (vissprite_t* spr)
 //
 
 void R_DrawMasked(void)
+{
+   R_SortVisSprites();
+   R_DrawMaskedRange(0, viewwidth-1);
+}
+
+//
+// R_MaskedFuzz
+// Whether the masked pass draws any spectre fuzz this frame. The fuzz
+// pattern carries on from column to column in drawing order, so a pass
+// with fuzz in it has to be drawn in one go.
+//
+
+dbool R_MaskedFuzz(void)
+{
+   size_t i;
+
+   for (i = 0; i < num_vissprite; i++)
+      if (!vissprites[i].colormap)
+         return TRUE;
+
+   return !viewangleoffset && !viewpitchoffset &&
+          (viewplayer->powers[pw_invisibility] > 4*32 ||
+           viewplayer->powers[pw_invisibility] & 8);
+}
+
+//
+// R_DrawMaskedRange
+// Draws columns x1 to x2 of the sprites, masked mid textures and
+// psprites; R_SortVisSprites must have been called for the frame.
+//
+
+void R_DrawMaskedRange(int x1, int x2)
 {
    int i;
    drawseg_t *ds;
 
-   R_SortVisSprites();
-
    // draw all vissprites back to front
 
-   rendered_vissprites = num_vissprite;
    for (i = num_vissprite ;--i>=0; )
-      R_DrawSprite(vissprite_ptrs[i]);         // killough
+   {
+      vissprite_t *spr = vissprite_ptrs[i];
+
+      if (spr->x1 <= x2 && spr->x2 >= x1)
+         R_DrawSprite(spr, spr->x1 > x1 ? spr->x1 : x1,
+                      spr->x2 < x2 ? spr->x2 : x2);         // killough
+   }
 
    // render any remaining masked mid textures
 
@@ -1005,11 +1069,12 @@ void R_DrawMasked(void)
    //    for (ds=ds_p-1 ; ds >= drawsegs ; ds--)    old buggy code
 
    for (ds=ds_p ; ds-- > drawsegs ; )  // new -- killough
-      if (ds->maskedtexturecol)
-         R_RenderMaskedSegRange(ds, ds->x1, ds->x2);
+      if (ds->maskedtexturecol && ds->x1 <= x2 && ds->x2 >= x1)
+         R_RenderMaskedSegRange(ds, ds->x1 > x1 ? ds->x1 : x1,
+                                ds->x2 < x2 ? ds->x2 : x2);
 
    // draw the psprites on top of everything
    //  but does not draw on side views
    if (!viewangleoffset && !viewpitchoffset)
-      R_DrawPlayerSprites ();
+      R_DrawPlayerSprites (x1, x2);
 }
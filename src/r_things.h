@@ -35,6 +35,7 @@
 #define __R_THINGS__
 
 #include "r_draw.h"
+#include "r_thread.h"
 
 /* Constant arrays used for psprite clipping and initializing clipping. */
 
@@ -43,10 +44,10 @@ extern int screenheightarray[MAX_SCREENWIDTH]; /* change to MAX_*  */ // dropoff
 
 /* Vars for R_DrawMaskedColumn */
 
-extern int     *mfloorclip;    // dropoff overflow
-extern int     *mceilingclip;  // dropoff overflow
-extern fixed_t spryscale;
-extern fixed_t sprtopscreen;
+extern R_THREADLOCAL int     *mfloorclip;    // dropoff overflow
+extern R_THREADLOCAL int     *mceilingclip;  // dropoff overflow
+extern R_THREADLOCAL fixed_t spryscale;
+extern R_THREADLOCAL fixed_t sprtopscreen;
 extern fixed_t pspritescale;
 extern fixed_t pspriteiscale;
 /* proff 11/06/98: Added for high-res */
@@ -60,9 +61,11 @@ void R_DrawMaskedColumn(const rpatch_t *patch,
                         const rcolumn_t *nextcolumn);
 void R_SortVisSprites(void);
 void R_AddSprites(subsector_t* subsec, int lightlevel);
-void R_DrawPlayerSprites(void);
+void R_DrawPlayerSprites(int x1, int x2);
 void R_InitSprites(const char * const * namelist);
 void R_ClearSprites(void);
 void R_DrawMasked(void);
+void R_DrawMaskedRange(int x1, int x2);
+dbool R_MaskedFuzz(void);
 
 #endif
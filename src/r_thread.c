@@ -0,0 +1,203 @@
+/* Emacs style mode select   -*- C++ -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *  Copyright (C) 1999 by
+ *  id Software, Chi Hoang, Lee Killough, Jim Flynn, Rand Phares, Ty Halderman
+ *  Copyright (C) 1999-2000 by
+ *  Jess Haas, Nicolas Kalkhof, Colin Phipps, Florian Schulze
+ *  Copyright 2005, 2006 by
+ *  Florian Schulze, Colin Phipps, Neil Stevens, Andrey Budko
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *      Render worker threads for split-screen drawing.
+ *      The main thread always draws strip 0 itself; strips 1..n-1
+ *      are handed to a small pool of persistent worker threads.
+ *
+ *-----------------------------------------------------------------------------*/
+
+#include "config.h"
+#include "r_thread.h"
+#include "lprintf.h"
+
+int render_threads = 1;
+
+#ifdef RENDER_THREADS
+
+#include <pthread.h>
+
+typedef struct {
+  pthread_t thread;
+  int       strip;
+  unsigned  generation;  // last job generation this worker has run
+} render_worker_t;
+
+static render_worker_t workers[MAX_RENDER_THREADS];
+static int num_workers;
+
+static pthread_mutex_t job_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  job_cond  = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  done_cond = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void (*job_func)(int strip);
+static unsigned job_generation;
+static int jobs_pending;
+static dbool   workers_quit;
+
+static void *R_RenderWorker(void *arg)
+{
+  render_worker_t *worker = arg;
+
+  pthread_mutex_lock(&job_mutex);
+  while (1)
+  {
+    void (*job)(int strip);
+
+    while (!workers_quit && worker->generation == job_generation)
+      pthread_cond_wait(&job_cond, &job_mutex);
+
+    if (workers_quit)
+      break;
+
+    worker->generation = job_generation;
+    job = job_func;
+    pthread_mutex_unlock(&job_mutex);
+
+    job(worker->strip);
+
+    pthread_mutex_lock(&job_mutex);
+    if (--jobs_pending == 0)
+      pthread_cond_signal(&done_cond);
+  }
+  pthread_mutex_unlock(&job_mutex);
+
+  return NULL;
+}
+
+void R_ShutdownRenderThreads(void)
+{
+  int i;
+
+  if (!num_workers)
+    return;
+
+  pthread_mutex_lock(&job_mutex);
+  workers_quit = TRUE;
+  pthread_cond_broadcast(&job_cond);
+  pthread_mutex_unlock(&job_mutex);
+
+  for (i = 0; i < num_workers; i++)
+    pthread_join(workers[i].thread, NULL);
+
+  num_workers = 0;
+  workers_quit = FALSE;
+  render_threads = 1;
+}
+
+void R_InitRenderThreads(int count)
+{
+  if (count < 1)
+    count = 1;
+  if (count > MAX_RENDER_THREADS)
+    count = MAX_RENDER_THREADS;
+
+  if (count == render_threads)
+    return;
+
+  R_ShutdownRenderThreads();
+
+  while (num_workers < count-1)
+  {
+    render_worker_t *worker = &workers[num_workers];
+
+    worker->strip = num_workers+1;
+    worker->generation = job_generation;
+    if (pthread_create(&worker->thread, NULL, R_RenderWorker, worker))
+    {
+      lprintf(LO_WARN, "R_InitRenderThreads: Could only start %d of %d render threads\n",
+              num_workers+1, count);
+      break;
+    }
+    num_workers++;
+  }
+
+  render_threads = num_workers+1;
+}
+
+void R_RunRenderThreads(void (*job)(int strip))
+{
+  if (!num_workers)
+  {
+    job(0);
+    return;
+  }
+
+  pthread_mutex_lock(&job_mutex);
+  job_func = job;
+  job_generation++;
+  jobs_pending = num_workers;
+  pthread_cond_broadcast(&job_cond);
+  pthread_mutex_unlock(&job_mutex);
+
+  job(0);
+
+  pthread_mutex_lock(&job_mutex);
+  while (jobs_pending)
+    pthread_cond_wait(&done_cond, &job_mutex);
+  pthread_mutex_unlock(&job_mutex);
+}
+
+void R_LockRenderCache(void)
+{
+  if (num_workers)
+    pthread_mutex_lock(&cache_mutex);
+}
+
+void R_UnlockRenderCache(void)
+{
+  if (num_workers)
+    pthread_mutex_unlock(&cache_mutex);
+}
+
+#else
+
+void R_InitRenderThreads(int count)
+{
+}
+
+void R_ShutdownRenderThreads(void)
+{
+}
+
+void R_RunRenderThreads(void (*job)(int strip))
+{
+  job(0);
+}
+
+void R_LockRenderCache(void)
+{
+}
+
+void R_UnlockRenderCache(void)
+{
+}
+
+#endif
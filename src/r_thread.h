@@ -0,0 +1,73 @@
+/* Emacs style mode select   -*- C++ -*-
+ *-----------------------------------------------------------------------------
+ *
+ *
+ *  PrBoom: a Doom port merged with LxDoom and LSDLDoom
+ *  based on BOOM, a modified and improved DOOM engine
+ *  Copyright (C) 1999 by
+ *  id Software, Chi Hoang, Lee Killough, Jim Flynn, Rand Phares, Ty Halderman
+ *  Copyright (C) 1999-2000 by
+ *  Jess Haas, Nicolas Kalkhof, Colin Phipps, Florian Schulze
+ *  Copyright 2005, 2006 by
+ *  Florian Schulze, Colin Phipps, Neil Stevens, Andrey Budko
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+ *  02111-1307, USA.
+ *
+ * DESCRIPTION:
+ *      Render worker threads for split-screen drawing
+ *
+ *-----------------------------------------------------------------------------*/
+
+#ifndef __R_THREAD__
+#define __R_THREAD__
+
+#include "doomtype.h"
+
+/* The BSP walk always runs on the main thread; only the drawing of
+ * walls, planes and masked things is split into vertical strips.
+ * Not available with MEMORY_LOW, where cache purging could release
+ * texture data that a queued wall column still points at. */
+#if defined(HAVE_RENDER_THREADS) && !defined(MEMORY_LOW)
+#define RENDER_THREADS
+#endif
+
+#define MAX_RENDER_THREADS 8
+
+/* Drawing state that each render thread needs its own copy of */
+#ifdef RENDER_THREADS
+#ifdef _MSC_VER
+#define R_THREADLOCAL __declspec(thread)
+#else
+#define R_THREADLOCAL __thread
+#endif
+#else
+#define R_THREADLOCAL
+#endif
+
+/* Number of strips the view is split into, 1 when drawing serially */
+extern int render_threads;
+
+void R_InitRenderThreads(int count);
+void R_ShutdownRenderThreads(void);
+
+/* Runs job(strip) for every strip and returns once all are done */
+void R_RunRenderThreads(void (*job)(int strip));
+
+/* Serialises zone and cache access from inside a render job */
+void R_LockRenderCache(void);
+void R_UnlockRenderCache(void);
+
+#endif
@@ -43,6 +43,89 @@
 int sts_always_red;      //jff 2/18/98 control to disable status color changes
 int sts_pct_always_gray; // killough 2/21/98: always gray %'s? bug or feature?
 
+//
+// Dirty-region tracking
+//
+// SC holds the status bar, already scaled, as it was after the last
+// ST_Drawer. The widgets record every area they draw to in FG, and only
+// those areas are copied to SC at the end of the frame; when the whole
+// bar has to be refreshed, ST_Drawer can then put SC back instead of
+// drawing the background and every widget through V_DrawNumPatch.
+//
+
+#define ST_MAXDIRTY 32
+
+typedef struct {
+  int x1, y1, x2, y2; // screen pixels, x2/y2 exclusive
+} st_rect_t;
+
+static st_rect_t st_dirty[ST_MAXDIRTY];
+static int st_numdirty;
+
+//
+// STlib_markDirty()
+//
+// Records that a widget drew the given area, in 320x200 coordinates
+//
+void STlib_markDirty(int x, int y, int w, int h)
+{
+  st_rect_t *r;
+
+  if (st_numdirty == ST_MAXDIRTY)
+  { // too many, take the whole bar
+    st_numdirty = 0;
+    x = 0; y = ST_Y; w = ST_WIDTH; h = ST_HEIGHT;
+  }
+
+  if (x < 0)
+    w += x, x = 0;
+  if (y < ST_Y)
+    h += y - ST_Y, y = ST_Y;
+  if (x + w > ST_WIDTH)
+    w = ST_WIDTH - x;
+  if (y + h > 200)
+    h = 200 - y;
+  if (w <= 0 || h <= 0)
+    return;
+
+  r = &st_dirty[st_numdirty++];
+  r->x1 = x*SCREENWIDTH/320;
+  r->x2 = (x+w)*SCREENWIDTH/320;
+  r->y1 = y*SCREENHEIGHT/200;
+  r->y2 = (y+h)*SCREENHEIGHT/200;
+}
+
+//
+// STlib_flushDirty()
+//
+// Copies this frame's dirty areas of the status bar from FG to SC
+//
+void STlib_flushDirty(void)
+{
+  int i, y;
+
+  for (i = 0; i < st_numdirty; i++)
+  {
+    const st_rect_t *r = &st_dirty[i];
+    size_t len = (r->x2 - r->x1) * SURFACE_PIXEL_DEPTH;
+
+    for (y = r->y1; y < r->y2; y++)
+      memcpy(screens[SC].data + (y - ST_SCALED_Y) * SURFACE_BYTE_PITCH + r->x1 * SURFACE_PIXEL_DEPTH,
+             screens[FG].data + y * SURFACE_BYTE_PITCH + r->x1 * SURFACE_PIXEL_DEPTH, len);
+  }
+  st_numdirty = 0;
+}
+
+//
+// STlib_restoreBar()
+//
+// Puts the status bar as it was last drawn back on FG
+//
+void STlib_restoreBar(void)
+{
+  V_CopyRect(0, 0, SC, SCREENWIDTH, ST_SCALED_HEIGHT, 0, ST_SCALED_Y, FG, VPT_NONE);
+}
+
 //
 // STlib_init()
 //
@@ -129,6 +212,7 @@ static void STlib_drawNum
   x = n->x - numdigits*w;
 
   V_CopyRect(x, n->y - ST_Y, BG, w*numdigits, h, x, n->y, FG, VPT_STRETCH);
+  STlib_markDirty(x, n->y, w*numdigits, h);
 
   // if non-number, do not draw it
   if (num == 1994)
@@ -227,6 +311,8 @@ void STlib_updatePercent
     V_DrawNumPatch(per->n.x, per->n.y, FG, per->p->lumpnum,
        sts_pct_always_gray ? CR_GRAY : cm,
        (sts_always_red ? VPT_NONE : VPT_TRANS) | VPT_STRETCH);
+    STlib_markDirty(per->n.x - per->p->leftoffset, per->n.y - per->p->topoffset,
+                    per->p->width, per->p->height);
   }
 
   STlib_updateNum(&per->n, cm, refresh);
@@ -287,9 +373,14 @@ void STlib_updateMultIcon
       h = mi->p[mi->oldinum].height;
 
       V_CopyRect(x, y-ST_Y, BG, w, h, x, y, FG, VPT_STRETCH);
+      STlib_markDirty(x, y, w, h);
     }
     if (*mi->inum != -1)  // killough 2/16/98: redraw only if != -1
-      V_DrawNumPatch(mi->x, mi->y, FG, mi->p[*mi->inum].lumpnum, CR_DEFAULT, VPT_STRETCH);
+    {
+      const patchnum_t *p = &mi->p[*mi->inum];
+      V_DrawNumPatch(mi->x, mi->y, FG, p->lumpnum, CR_DEFAULT, VPT_STRETCH);
+      STlib_markDirty(mi->x - p->leftoffset, mi->y - p->topoffset, p->width, p->height);
+    }
     mi->oldinum = *mi->inum;
   }
 }
@@ -353,6 +444,7 @@ void STlib_updateBinIcon
       V_DrawNumPatch(bi->x, bi->y, FG, bi->p->lumpnum, CR_DEFAULT, VPT_STRETCH);
     else
       V_CopyRect(x, y-ST_Y, BG, w, h, x, y, FG, VPT_STRETCH);
+    STlib_markDirty(x, y, w, h);
 
     bi->oldval = *bi->val;
   }
@@ -43,6 +43,7 @@
 //
 #define BG 4
 #define FG 0
+#define SC 5  // the status bar as last drawn, see STlib_markDirty
 
 //
 // Typedefs of widgets
@@ -206,4 +207,9 @@ void STlib_updateBinIcon
 ( st_binicon_t* bi,
   dbool   refresh );
 
+// Dirty-region tracking of the composited status bar
+void STlib_markDirty(int x, int y, int w, int h);
+void STlib_flushDirty(void);
+void STlib_restoreBar(void);
+
 #endif
@@ -248,6 +248,11 @@ static player_t *plyr;
 // ST_Start() has just been called
 static dbool st_firsttime;
 
+// SC and BG hold the status bar as last drawn, valid while
+// V_CacheStamp is still st_cachestamp
+static dbool st_cachevalid;
+static unsigned st_cachestamp;
+
 // used to execute ST_Init() only once
 static int veryfirsttime = 1;
 
@@ -852,13 +857,31 @@ void ST_Drawer(dbool statusbaron, dbool refresh, dbool fullmenu)
   ST_doPaletteStuff();  // Do red-/gold-shifts from damage/items
 
   if (statusbaron) {
-    if (st_firsttime)
+    if (st_firsttime && st_cachevalid && st_cachestamp == V_CacheStamp)
+    {
+      /* Nothing behind the widgets changed since the bar was last drawn;
+       * put that back and update just the widgets that changed since */
+      st_firsttime = FALSE;
+      if (!fullmenu)
+      {
+        STlib_restoreBar();
+        ST_drawWidgets(FALSE);
+      }
+      else
+        V_CopyRect(ST_X, 0, BG, ST_SCALED_WIDTH, ST_SCALED_HEIGHT, ST_X, ST_SCALED_Y, FG, VPT_NONE);
+    }
+    else if (st_firsttime)
     {
       /* If just after ST_Start(), refresh all */
       st_firsttime = FALSE;
       ST_refreshBackground(); // draw status bar background to off-screen buff
       if (!fullmenu)
+      {
         ST_drawWidgets(TRUE); // and refresh all widgets
+        STlib_markDirty(0, ST_Y, ST_WIDTH, ST_HEIGHT);
+        st_cachevalid = TRUE;
+        st_cachestamp = V_CacheStamp;
+      }
     }
     else
     {
@@ -866,6 +889,7 @@ void ST_Drawer(dbool statusbaron, dbool refresh, dbool fullmenu)
       if (!fullmenu)
         ST_drawWidgets(FALSE); // update all widgets
     }
+    STlib_flushDirty();
   }
 }
 
@@ -978,6 +1002,7 @@ static void ST_initData(void)
   int i;
 
   st_firsttime = TRUE;
+  st_cachevalid = FALSE;
   plyr = &players[displayplayer];            // killough 3/7/98
 
   st_clock = 0;
@@ -360,7 +360,7 @@ void V_Init (void)
 //  means that their inner loops weren't so well optimised, so merging code may even speed them).
 //
 //
-static void V_DrawMemPatch(int x, int y, int scrn, const rpatch_t *patch,
+static void V_DrawMemPatch(int x, int y, uint16_t *dest, const rpatch_t *patch,
         int cm, enum patch_translation_e flags)
 {
    int   left, right, top, bottom;
@@ -395,8 +395,8 @@ static void V_DrawMemPatch(int x, int y, int scrn, const rpatch_t *patch,
 
    R_SetDefaultDrawColumnVars(&dcvars);
 
-   drawvars.short_topleft = (uint16_t*)screens[scrn].data;
-   drawvars.int_topleft   = (uint32_t*)screens[scrn].data;
+   drawvars.short_topleft = dest;
+   drawvars.int_topleft   = (uint32_t*)dest;
 
    if (!(flags & VPT_STRETCH))
    {
@@ -498,6 +498,265 @@ static void V_DrawMemPatch(int x, int y, int scrn, const rpatch_t *patch,
    drawvars = olddrawvars;
 }
 
+//
+// Pre-scaled patch cache
+//
+// At the resolutions offered, which are all whole multiples of 320x200,
+// a stretched patch comes out the same wherever it is drawn, as long as
+// it isn't clipped. So patches that fit on screen are captured once,
+// scaled and in RGB565: drawn into a scratch buffer over two different
+// backgrounds, keeping every pixel that comes out the same both times as
+// runs of opaque pixels. Later draws of the same lump, translation and
+// palette only copy those runs. The least recently used entries go once
+// the cache holds more than V_PATCHCACHE_LIMIT bytes.
+//
+
+#ifdef MEMORY_LOW
+#define V_PATCHCACHE_LIMIT (4<<20)
+#else
+#define V_PATCHCACHE_LIMIT (32<<20)
+#endif
+#define V_PATCHCACHE_HASH 256
+
+typedef struct {
+  int y, x, len;      // in the scaled patch
+} v_patchrun_t;
+
+typedef struct v_cachedpatch_s {
+  struct v_cachedpatch_s *next;               // hash chain
+  struct v_cachedpatch_s *lruprev, *lrunext;  // most recently used first
+
+  // what was drawn
+  int lump, cm;
+  enum patch_translation_e flags;
+  const uint16_t *palette;
+  enum draw_filter_type_e filter;
+  enum sloped_edge_type_e edges;
+
+  int leftoffset, topoffset;  // unscaled
+  int width, height;          // scaled
+  int numruns;
+  size_t size;
+  v_patchrun_t *runs;
+  uint16_t *pixels;           // the pixels of all runs, one after another
+} v_cachedpatch_t;
+
+static v_cachedpatch_t *patchcache[V_PATCHCACHE_HASH];
+static v_cachedpatch_t patchlru = { .lruprev = &patchlru, .lrunext = &patchlru };
+static size_t patchcachesize;
+static uint16_t *patchscratch;
+static size_t patchscratchsize;
+
+static void V_UnlinkCachedPatch(v_cachedpatch_t *p)
+{
+  p->lruprev->lrunext = p->lrunext;
+  p->lrunext->lruprev = p->lruprev;
+}
+
+static void V_LinkCachedPatch(v_cachedpatch_t *p)
+{
+  p->lrunext = patchlru.lrunext;
+  p->lruprev = &patchlru;
+  patchlru.lrunext->lruprev = p;
+  patchlru.lrunext = p;
+}
+
+static void V_FreeCachedPatch(v_cachedpatch_t *p)
+{
+  v_cachedpatch_t **link = &patchcache[(unsigned)p->lump % V_PATCHCACHE_HASH];
+
+  while (*link != p)
+    link = &(*link)->next;
+  *link = p->next;
+  V_UnlinkCachedPatch(p);
+  patchcachesize -= p->size;
+  free(p);
+}
+
+//
+// V_FreePatchCache
+//
+// Drops every cached patch, for when the resolution, the gamma or the
+// loaded wads change
+//
+void V_FreePatchCache(void)
+{
+  while (patchlru.lrunext != &patchlru)
+    V_FreeCachedPatch(patchlru.lrunext);
+  free(patchscratch);
+  patchscratch = NULL;
+  patchscratchsize = 0;
+}
+
+//
+// V_CachePatch
+//
+// Captures the stretched patch, or returns NULL if it isn't worth keeping
+//
+static v_cachedpatch_t *V_CachePatch(const rpatch_t *patch, int lump, int cm,
+        enum patch_translation_e flags)
+{
+  const int w = patch->width * (SCREENWIDTH / 320);
+  const int h = patch->height * (SCREENHEIGHT / 200);
+  const size_t area = (size_t)SURFACE_SHORT_PITCH * h;
+  uint16_t *a, *b;
+  v_cachedpatch_t *p;
+  int x, y, numruns = 0, numpixels = 0;
+  size_t size;
+
+  if (2 * area > patchscratchsize)
+  {
+    patchscratchsize = 2 * area;
+    patchscratch = realloc(patchscratch, patchscratchsize * sizeof(*patchscratch));
+  }
+  a = patchscratch;
+  b = patchscratch + area;
+
+  // Draw the patch at the scratch buffers' top left, once over black...
+  memset(a, 0, area * sizeof(*a));
+  V_DrawMemPatch(patch->leftoffset, patch->topoffset, a, patch, cm, flags);
+  // ...and once over white
+  memset(b, 0xff, area * sizeof(*b));
+  V_DrawMemPatch(patch->leftoffset, patch->topoffset, b, patch, cm, flags);
+
+  for (y = 0; y < h; y++)
+  {
+    const uint16_t *ra = a + y * SURFACE_SHORT_PITCH;
+    const uint16_t *rb = b + y * SURFACE_SHORT_PITCH;
+
+    for (x = 0; x < w; x++)
+      if (ra[x] == rb[x])
+      {
+        numpixels++;
+        if (!x || ra[x-1] != rb[x-1])
+          numruns++;
+      }
+  }
+
+  size = sizeof(*p) + numruns * sizeof(*p->runs) + numpixels * sizeof(*p->pixels);
+  if (size > V_PATCHCACHE_LIMIT / 4)
+    return NULL;
+
+  while (patchcachesize + size > V_PATCHCACHE_LIMIT)
+    V_FreeCachedPatch(patchlru.lruprev);
+
+  p = malloc(size);
+  p->lump = lump;
+  p->cm = cm;
+  p->flags = flags;
+  p->palette = V_Palette16;
+  p->filter = drawvars.filterpatch;
+  p->edges = drawvars.patch_edges;
+  p->leftoffset = patch->leftoffset;
+  p->topoffset = patch->topoffset;
+  p->width = w;
+  p->height = h;
+  p->numruns = 0;
+  p->size = size;
+  p->runs = (v_patchrun_t *)(p + 1);
+  p->pixels = (uint16_t *)(p->runs + numruns);
+
+  numpixels = 0;
+  for (y = 0; y < h; y++)
+  {
+    const uint16_t *ra = a + y * SURFACE_SHORT_PITCH;
+    const uint16_t *rb = b + y * SURFACE_SHORT_PITCH;
+
+    for (x = 0; x < w; )
+    {
+      v_patchrun_t *run;
+
+      if (ra[x] != rb[x])
+      {
+        x++;
+        continue;
+      }
+      run = &p->runs[p->numruns++];
+      run->y = y;
+      run->x = x;
+      for (; x < w && ra[x] == rb[x]; x++)
+        p->pixels[numpixels++] = ra[x];
+      run->len = x - run->x;
+    }
+  }
+
+  p->next = patchcache[(unsigned)lump % V_PATCHCACHE_HASH];
+  patchcache[(unsigned)lump % V_PATCHCACHE_HASH] = p;
+  V_LinkCachedPatch(p);
+  patchcachesize += size;
+  return p;
+}
+
+//
+// V_DrawCachedPatch
+//
+// Draws a stretched patch from the cache, capturing it first if needed.
+// Returns false if the patch has to be drawn the usual way instead.
+//
+static dbool V_DrawCachedPatch(int x, int y, int scrn, int lump,
+        int cm, enum patch_translation_e flags)
+{
+  const int kx = SCREENWIDTH / 320;
+  const int ky = SCREENHEIGHT / 200;
+  const uint16_t *pixels;
+  uint16_t *dest;
+  v_cachedpatch_t *p;
+  int i;
+
+  if (!(flags & VPT_STRETCH) || (kx == 1 && ky == 1) ||
+      SCREENWIDTH % 320 || SCREENHEIGHT % 200)
+    return false;
+
+  if (!(flags & VPT_TRANS))
+    cm = CR_DEFAULT;
+  flags &= VPT_FLIP | VPT_TRANS | VPT_STRETCH;
+
+  for (p = patchcache[(unsigned)lump % V_PATCHCACHE_HASH]; p; p = p->next)
+    if (p->lump == lump && p->cm == cm && p->flags == flags &&
+        p->palette == V_Palette16 && p->filter == drawvars.filterpatch &&
+        p->edges == drawvars.patch_edges)
+      break;
+
+  if (p)
+  {
+    V_UnlinkCachedPatch(p);
+    V_LinkCachedPatch(p);
+  }
+  else
+  {
+    const rpatch_t *patch = R_CachePatchNum(lump);
+    const int left = (x - patch->leftoffset) * kx;
+    const int top = (y - patch->topoffset) * ky;
+
+    // clipped patches are drawn the usual way
+    if (left >= 0 && top >= 0 &&
+        left + patch->width * kx <= SCREENWIDTH &&
+        top + patch->height * ky <= SCREENHEIGHT)
+      p = V_CachePatch(patch, lump, cm, flags);
+    R_UnlockPatchNum(lump);
+    if (!p)
+      return false;
+  }
+
+  x = (x - p->leftoffset) * kx;
+  y = (y - p->topoffset) * ky;
+  if (x < 0 || y < 0 ||
+      x + p->width > SCREENWIDTH || y + p->height > SCREENHEIGHT)
+    return false;
+
+  dest = (uint16_t *)screens[scrn].data + y * SURFACE_SHORT_PITCH + x;
+  pixels = p->pixels;
+  for (i = 0; i < p->numruns; i++)
+  {
+    const v_patchrun_t *run = &p->runs[i];
+
+    memcpy(dest + run->y * SURFACE_SHORT_PITCH + run->x, pixels,
+           run->len * sizeof(*pixels));
+    pixels += run->len;
+  }
+  return true;
+}
+
 // CPhipps - some simple, useful wrappers for that function, for drawing patches from wads
 
 // CPhipps - GNU C only suppresses generating a copy of a function if it is
@@ -513,11 +772,16 @@ void V_DrawNumPatch(int x, int y, int scrn, int lump,
     return;
   }
     
-  V_DrawMemPatch(x, y, scrn, R_CachePatchNum(lump), cm, flags);
+  if (V_DrawCachedPatch(x, y, scrn, lump, cm, flags))
+    return;
+
+  V_DrawMemPatch(x, y, (uint16_t *)screens[scrn].data, R_CachePatchNum(lump),
+                 cm, flags);
   R_UnlockPatchNum(lump);
 }
 
 uint16_t *V_Palette16 = NULL;
+unsigned V_CacheStamp;
 static uint16_t *Palettes16 = NULL;
 static int currentPaletteIndex = 0;
 
@@ -541,6 +805,7 @@ void V_UpdateTrueColorPalette(void) {
   int numPals = W_LumpLength(pplump) / (3*256);
   
   if (usegammaOnLastPaletteGeneration != usegamma) {
+    V_FreePatchCache();
     if (Palettes16) free(Palettes16);
     Palettes16 = NULL;
     usegammaOnLastPaletteGeneration = usegamma;      
@@ -588,6 +853,7 @@ void V_UpdateTrueColorPalette(void) {
   }
 
   V_Palette16 = Palettes16 + paletteNum*256*VID_NUMCOLORWEIGHTS;
+  V_CacheStamp++;
    
   W_UnlockLumpNum(pplump);
   W_UnlockLumpNum(gtlump);
@@ -599,6 +865,7 @@ void V_UpdateTrueColorPalette(void) {
 //---------------------------------------------------------------------------
 static void V_DestroyTrueColorPalette(void)
 {
+    V_FreePatchCache();
     if (Palettes16) free(Palettes16);
     Palettes16 = NULL;
     V_Palette16 = NULL;
@@ -682,6 +949,7 @@ void V_AllocScreens(void) {
 
   for (i=0; i<NUM_SCREENS; i++)
     V_AllocScreen(&screens[i]);
+  V_CacheStamp++;
 }
 
 //
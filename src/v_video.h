@@ -135,6 +135,9 @@ extern void V_DrawNumPatch(int x, int y, int scrn,
 // V_DrawNamePatch - Draws the patch from lump "name"
 #define V_DrawNamePatch(x,y,s,n,t,f) V_DrawNumPatch(x,y,s,W_GetNumForName(n),t,f)
 
+// V_FreePatchCache - Forgets the patches V_DrawNumPatch kept pre-scaled
+void V_FreePatchCache(void);
+
 /* cph -
  * Functions to return width & height of a patch.
  * Doesn't really belong here, but is often used in conjunction with
@@ -150,6 +153,11 @@ void V_DestroyUnusedTrueColorPalettes(void);
 // CPhipps - function to set the palette to palette number pal.
 void V_SetPalette(int pal);
 
+// Changes whenever previously drawn RGB565 pixels may no longer match
+// a redraw (new palette or gamma, reallocated screens); used to check
+// the status bar and HUD caches
+extern unsigned V_CacheStamp;
+
 // CPhipps - function to plot a pixel
 
 // V_PlotPixel
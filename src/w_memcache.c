@@ -65,6 +65,29 @@ void W_DoneCache(void)
       free(cachelump);
 }
 
+#ifdef WAD_DATA
+/* Lumps at a multiple of this in the wad are used in place, the rest
+ * get an aligned copy for the structures cast over them */
+#define LUMP_ALIGN 4
+#endif
+
+/* W_LumpInPlace
+ *
+ * If the whole wad is in memory, read in or mapped by W_AddFile, lumps
+ * can be handed out straight from it instead of copied into the zone a
+ * second time. Returns NULL for a lump that has to be read in.
+ */
+const void *W_LumpInPlace(int lump)
+{
+#ifdef WAD_DATA
+  const lumpinfo_t *l = &lumpinfo[lump];
+
+  if (l->wadfile && l->wadfile->data && !(l->position & (LUMP_ALIGN-1)))
+    return l->wadfile->data + l->position;
+#endif
+  return NULL;
+}
+
 /* W_CacheLumpNum
  * killough 4/25/98: simplified
  * CPhipps - modified for new lump locking scheme
@@ -75,8 +98,20 @@ const void *W_CacheLumpNum(int lump)
 {
   const int locks = 1;
 
+#ifdef WAD_DATA
+  const void *data = W_LumpInPlace(lump);
+
+  if (data)
+    return data;
+#endif
+
   if (!cachelump[lump].cache)      // read the lump in
+  {
+    cachestats.misses++;
     W_ReadLump(lump, Z_Malloc(W_LumpLength(lump), PU_CACHE, &cachelump[lump].cache));
+  }
+  else
+    cachestats.hits++;
 
   /* cph - if wasn't locked but now is, tell z_zone to hold it */
   if (!cachelump[lump].locks && locks) {
@@ -105,6 +140,11 @@ void W_UnlockLumpNum(int lump)
   // invalid lump, ignore unlock
   if (lump < 0) return;
 
+#ifdef WAD_DATA
+  if (W_LumpInPlace(lump))
+    return;
+#endif
+
   cachelump[lump].locks -= unlocks;
   /* cph - Note: must only tell z_zone to make purgeable if currently locked,
    * else it might already have been purged
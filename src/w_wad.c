@@ -48,6 +48,10 @@
 #include "lprintf.h"
 
 #include <sys/stat.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include <streams/file_stream.h>
 
@@ -65,6 +69,50 @@ int64_t rfseek(RFILE* stream, int64_t offset, int origin);
 lumpinfo_t *lumpinfo;
 int        numlumps;         // killough
 
+#ifdef HAVE_MMAP
+//
+// W_MapFile
+// Maps the wad read-only, so it needn't be read in up front and the OS
+// pages it in and out as needed, sharing the pages between everything
+// that has the same wad open. Leaves data NULL if the file can't be
+// mapped, e.g. when only the frontend's VFS knows the path.
+//
+static void W_MapFile(wadfile_info_t *wadfile)
+{
+   struct stat st;
+   void *data;
+   int fd = open(wadfile->name, O_RDONLY);
+
+   if (fd < 0)
+      return;
+   if (!fstat(fd, &st) && st.st_size > 0 && st.st_size <= INT_MAX)
+   {
+      data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED)
+      {
+         wadfile->data   = data;
+         wadfile->length = st.st_size;
+         wadfile->mapped = TRUE;
+      }
+   }
+   close(fd);
+}
+#endif
+
+#ifdef WAD_DATA
+static void W_FreeFileData(wadfile_info_t *wadfile)
+{
+#ifdef HAVE_MMAP
+   if (wadfile->mapped)
+      munmap(wadfile->data, wadfile->length);
+   else
+#endif
+      free(wadfile->data);
+   wadfile->data   = NULL;
+   wadfile->mapped = FALSE;
+}
+#endif
+
 void ExtractFileBase (const char *path, char *dest)
 {
   int length;
@@ -154,12 +202,22 @@ static void W_AddFile(wadfile_info_t *wadfile)
       return;
    }
 
+#ifdef WAD_DATA
+   wadfile->data = NULL;
+   wadfile->mapped = FALSE;
+#ifdef HAVE_MMAP
+   W_MapFile(wadfile);
+#endif
 #ifndef MEMORY_LOW
-   // precache into memory instead of reading from disk
-   wadfile->length = filestream_get_size(wadfile->handle);
-   wadfile->data = malloc(wadfile->length);
-   if ( rfread(wadfile->data, wadfile->length, 1, wadfile->handle) != 1)
-      I_Error("W_AddFile: couldn't read wad data");
+   if (!wadfile->data)
+   {
+      // precache into memory instead of reading from disk
+      wadfile->length = filestream_get_size(wadfile->handle);
+      wadfile->data = malloc(wadfile->length);
+      if ( rfread(wadfile->data, wadfile->length, 1, wadfile->handle) != 1)
+         I_Error("W_AddFile: couldn't read wad data");
+   }
+#endif
 #endif
 
    //jff 8/3/98 use logical output routine
@@ -176,23 +234,25 @@ static void W_AddFile(wadfile_info_t *wadfile)
       // single lump file
       fileinfo = &singleinfo;
       singleinfo.filepos = 0;
-#ifdef MEMORY_LOW
-      singleinfo.size = LONG(filestream_get_size(wadfile->handle));
-#else
-      singleinfo.size = wadfile->length;
+#ifdef WAD_DATA
+      if (wadfile->data)
+         singleinfo.size = wadfile->length;
+      else
 #endif
+         singleinfo.size = LONG(filestream_get_size(wadfile->handle));
       ExtractFileBase(wadfile->name, singleinfo.name);
       numlumps++;
    }
    else
    {
       // WAD file
-#ifdef MEMORY_LOW
+#ifdef WAD_DATA
+      if (wadfile->data)
+         memcpy(&header, wadfile->data, sizeof(header));
+      else
+#endif
       if (rfread(&header, sizeof(header), 1, wadfile->handle) <= 0)
          I_Error("W_AddFile: read failed");
-#else
-      memcpy(&header, wadfile->data, sizeof(header));
-#endif
       if (strncmp(header.identification,"IWAD",4) &&
             strncmp(header.identification,"PWAD",4))
          I_Error("W_AddFile: Wad file %s doesn't have IWAD or PWAD id", wadfile->name);
@@ -200,13 +260,16 @@ static void W_AddFile(wadfile_info_t *wadfile)
       header.infotableofs = LONG(header.infotableofs);
       length = header.numlumps*sizeof(filelump_t);
       fileinfo2free = fileinfo = malloc(length);    // killough
-#ifdef MEMORY_LOW
-      rfseek(wadfile->handle, header.infotableofs, SEEK_SET);
-      if (rfread(fileinfo, length, 1, wadfile->handle) <= 0)
-         I_Error("W_AddFile: read failed");
-#else
-      memcpy(fileinfo, &wadfile->data[header.infotableofs], length);
+#ifdef WAD_DATA
+      if (wadfile->data)
+         memcpy(fileinfo, &wadfile->data[header.infotableofs], length);
+      else
 #endif
+      {
+         rfseek(wadfile->handle, header.infotableofs, SEEK_SET);
+         if (rfread(fileinfo, length, 1, wadfile->handle) <= 0)
+            I_Error("W_AddFile: read failed");
+      }
       numlumps += header.numlumps;
    }
 
@@ -298,25 +361,50 @@ static void W_CoalesceMarkedResource(const char *start_marker,
     }
 }
 
-// Hash function used for lump names.
-// Must be mod'ed with table size.
-// Can be used for any 8-character names.
-// by Lee Killough
+// Lump names canonicalized into a 64-bit key: up to 8 characters,
+// uppercased, zero padded. Two names are the same lump name, as far
+// as strncasecmp(a, b, 8) is concerned, exactly when their keys are equal.
 
-unsigned W_LumpNameHash(const char *s)
+uint64_t W_LumpNameKey(const char *name)
 {
-  unsigned hash;
-  if (!s[0]) return 0;
-  (void) ((hash =        toupper(s[0]), s[1]) &&
-          (hash = hash*3+toupper(s[1]), s[2]) &&
-          (hash = hash*2+toupper(s[2]), s[3]) &&
-          (hash = hash*2+toupper(s[3]), s[4]) &&
-          (hash = hash*2+toupper(s[4]), s[5]) &&
-          (hash = hash*2+toupper(s[5]), s[6]) &&
-          (hash = hash*2+toupper(s[6]),
-           hash = hash*2+toupper(s[7]))
-         );
-  return hash;
+  uint64_t key = 0;
+  int i;
+
+  for (i = 0; i < 8 && name[i]; i++)
+  {
+    unsigned char c = name[i];
+    if (c >= 'a' && c <= 'z')
+      c -= 'a' - 'A';
+    key |= (uint64_t) c << (i*8);
+  }
+  return key;
+}
+
+// Spreads a key over 32 bits, for tables indexed with the top bits of
+// the hash (see W_KeySlot) or with a modulo (see R_CheckTextureNumForName)
+
+unsigned W_LumpKeyHash(uint64_t key)
+{
+  return (unsigned)((key * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+// One open-addressing table per namespace, holding the last lump of each
+// name; the earlier lumps of that name and namespace chain off it
+// through lumpinfo[].next.
+
+#define NUMNAMESPACES (ns_prboom+1)
+
+typedef struct {
+  int *slots;                  // lump numbers, -1 where empty
+  unsigned mask;               // number of slots - 1
+  unsigned shift;              // 32 - log2(number of slots)
+} lumptable_t;
+
+static lumptable_t lumptables[NUMNAMESPACES];
+
+static INLINE unsigned W_KeySlot(const lumptable_t *table, uint64_t key)
+{
+  return W_LumpKeyHash(key) >> table->shift;
 }
 
 //
@@ -329,10 +417,11 @@ unsigned W_LumpNameHash(const char *s)
 // lump name lookup is used so often, and the original Doom used a sequential
 // search. For large wads with > 1000 lumps this meant an average of over
 // 500 were probed during every search. Now the average is under 2 probes per
-// search. There is no significant benefit to packing the names into longwords
-// with this new hashing algorithm, because the work to do the packing is
-// just as much work as simply doing the string comparisons with the new
-// algorithm, which minimizes the expected number of comparisons to under 2.
+// search.
+//
+// Names are now packed into 64-bit keys once, when the lumps are hashed, so
+// a probe is a single integer compare rather than a strncasecmp; only the
+// name being looked up still has to be packed.
 //
 // killough 4/17/98: add namespace parameter to prevent collisions
 // between different resources such as flats, sprites, colormaps
@@ -343,29 +432,23 @@ unsigned W_LumpNameHash(const char *s)
 //
 int (W_FindNumFromName)(const char *name, lumpinfo_namespace_t li_namespace, int i)
 {
-  // Hash function maps the name to one of possibly numlump chains.
-  // It has been tuned so that the average chain length never exceeds 2.
+  const lumptable_t *table = &lumptables[li_namespace];
+  uint64_t key;
+  unsigned slot;
 
   // proff 2001/09/07 - check numlumps==0, this happens when called before WAD loaded
-  if (numlumps == 0)
-    i = -1;
-  else
-  {
-    if (i < 0)
-      i = lumpinfo[W_LumpNameHash(name) % (unsigned) numlumps].index;
-    else
-      i = lumpinfo[i].next;
+  if (numlumps == 0 || !table->slots)
+    return -1;
 
-  // We search along the chain until end, looking for case-insensitive
-  // matches which also match a namespace tag. Separate hash tables are
-  // not used for each namespace, because the performance benefit is not
-  // worth the overhead, considering namespace collisions are rare in
-  // Doom wads.
+  // the next older lump of the same name and namespace
+  if (i >= 0)
+    return lumpinfo[i].next;
 
-  while (i >= 0 && (strncasecmp(lumpinfo[i].name, name, 8) ||
-                    lumpinfo[i].li_namespace != li_namespace))
-    i = lumpinfo[i].next;
-  }
+  key = W_LumpNameKey(name);
+  for (slot = W_KeySlot(table, key); (i = table->slots[slot]) >= 0;
+       slot = (slot + 1) & table->mask)
+    if (lumpinfo[i].key == key)
+      break;
 
   // Return the matching lump, or -1 if none found.
 
@@ -378,21 +461,56 @@ int (W_FindNumFromName)(const char *name, lumpinfo_namespace_t li_namespace, int
 
 void W_HashLumps(void)
 {
+  int counts[NUMNAMESPACES];
   int i;
 
+  memset(counts, 0, sizeof(counts));
   for (i=0; i<numlumps; i++)
-    lumpinfo[i].index = -1;                     // mark slots empty
+  {
+    lumpinfo[i].key = W_LumpNameKey(lumpinfo[i].name);
+    counts[lumpinfo[i].li_namespace]++;
+  }
 
-  // Insert nodes to the beginning of each chain, in first-to-last
-  // lump order, so that the last lump of a given name appears first
-  // in any chain, observing pwad ordering rules. killough
+  // Keep each table at most half full
+  for (i=0; i<NUMNAMESPACES; i++)
+  {
+    lumptable_t *table = &lumptables[i];
+    unsigned size = 16, shift = 28;
+
+    while (size < 2 * (unsigned) counts[i])
+      size <<= 1, shift--;
+    table->slots = realloc(table->slots, size * sizeof(*table->slots));
+    memset(table->slots, -1, size * sizeof(*table->slots));
+    table->mask = size - 1;
+    table->shift = shift;
+  }
+
+  // Insert in first-to-last lump order, so that the last lump of a
+  // given name ends up in the table, with the earlier ones behind it,
+  // observing pwad ordering rules. killough
 
   for (i=0; i<numlumps; i++)
-    {                                           // hash function:
-      int j = W_LumpNameHash(lumpinfo[i].name) % (unsigned) numlumps;
-      lumpinfo[i].next = lumpinfo[j].index;     // Prepend to list
-      lumpinfo[j].index = i;
-    }
+  {
+    lumptable_t *table = &lumptables[lumpinfo[i].li_namespace];
+    uint64_t key = lumpinfo[i].key;
+    unsigned slot = W_KeySlot(table, key);
+
+    while (table->slots[slot] >= 0 && lumpinfo[table->slots[slot]].key != key)
+      slot = (slot + 1) & table->mask;
+    lumpinfo[i].next = table->slots[slot];
+    table->slots[slot] = i;
+  }
+}
+
+static void W_FreeHash(void)
+{
+  int i;
+
+  for (i=0; i<NUMNAMESPACES; i++)
+  {
+    free(lumptables[i].slots);
+    lumptables[i].slots = NULL;
+  }
 }
 
 // End of lump hashing -- killough 1/31/98
@@ -494,9 +612,8 @@ void W_Exit(void)
       if (wadfiles[i].handle)
       {
          filestream_close(wadfiles[i].handle);
-#ifndef MEMORY_LOW
-         free(wadfiles[i].data);
-         wadfiles[i].data = NULL;
+#ifdef WAD_DATA
+         W_FreeFileData(&wadfiles[i]);
 #endif
          wadfiles[i].handle = NULL;
       }
@@ -513,9 +630,8 @@ void W_ReleaseAllWads(void)
       if(wadfiles[i].handle)
       {
          filestream_close(wadfiles[i].handle);
-#ifndef MEMORY_LOW
-         free(wadfiles[i].data);
-         wadfiles[i].data = NULL;
+#ifdef WAD_DATA
+         W_FreeFileData(&wadfiles[i]);
 #endif
          wadfiles[i].handle = NULL;
       }
@@ -527,6 +643,7 @@ void W_ReleaseAllWads(void)
    numlumps = 0;
    free(lumpinfo);
    lumpinfo = NULL;
+   W_FreeHash();
 }
 
 //
@@ -552,7 +669,11 @@ void W_ReadLump(int lump, void *dest)
 
    if (l->wadfile)
    {
-#ifdef MEMORY_LOW
+#ifdef WAD_DATA
+      if (l->wadfile->data)
+         memcpy(dest, &l->wadfile->data[l->position], l->size);
+      else
+#endif
       if (l->size > 0)
       {
          rfseek(l->wadfile->handle, l->position, SEEK_SET);
@@ -561,8 +682,5 @@ void W_ReadLump(int lump, void *dest)
       }
       else
          I_Error("W_ReadLump: attempt to read lump of zero size");
-#else
-      memcpy(dest, &l->wadfile->data[l->position], l->size);
-#endif
    }
 }
@@ -35,6 +35,7 @@
 #ifndef __W_WAD__
 #define __W_WAD__
 
+#include <stdint.h>
 #include <streams/file_stream.h>
 
 //
@@ -81,6 +82,12 @@ typedef enum {
   ns_prboom
 } lumpinfo_namespace_t;
 
+// Wads are mapped where HAVE_MMAP allows, else read into memory whole,
+// or with MEMORY_LOW read from the file a lump at a time
+#if !defined(MEMORY_LOW) || defined(HAVE_MMAP)
+#define WAD_DATA
+#endif
+
 // CPhipps - changed wad init
 // We _must_ have the wadfiles[] the same as those actually loaded, so there 
 // is no point having these separate entities. This belongs here.
@@ -88,10 +95,11 @@ typedef struct {
   const char* name;
   wad_source_t src;
   RFILE* handle;
-#ifndef MEMORY_LOW
-  unsigned char *data;
+#ifdef WAD_DATA
+  unsigned char *data; // the whole file, or NULL if read lump by lump
   int position;
   int length;
+  int mapped;          // data is a read-only mapping of the file
 #endif
 } wadfile_info_t;
 
@@ -112,7 +120,8 @@ typedef struct
   int   size;
 
   // killough 1/31/98: hash table fields, used for ultra-fast hash table lookup
-  int index, next;
+  uint64_t key;        // name packed by W_LumpNameKey
+  int next;            // earlier lump of the same name and namespace
 
   // haleyjd 05/21/02: renamed from "namespace"
   lumpinfo_namespace_t li_namespace;
@@ -140,6 +149,7 @@ int     W_LumpLength (int lump);
 void    W_ReadLump (int lump, void *dest);
 // CPhipps - modified for 'new' lump locking
 const void* W_CacheLumpNum (int lump);
+const void* W_LumpInPlace(int lump); // NULL unless used straight from the wad
 const void* W_LockLumpNum(int lump);
 void    W_UnlockLumpNum(int lump);
 
@@ -152,7 +162,8 @@ void    W_UnlockLumpNum(int lump);
 
 char *AddDefaultExtension(char *, const char *);  // killough 1/18/98
 void ExtractFileBase(const char *, char *);       // killough
-unsigned W_LumpNameHash(const char *s);           // killough 1/31/98
+uint64_t W_LumpNameKey(const char *name);
+unsigned W_LumpKeyHash(uint64_t key);
 void W_HashLumps(void);                           // cph 2001/07/07 - made public
 
 void W_Exit(void);
@@ -37,6 +37,7 @@
 #include "w_wad.h"
 #include "g_game.h"
 #include "r_main.h"
+#include "r_data.h"
 #include "v_video.h"
 #include "wi_stuff.h"
 #include "s_sound.h"
@@ -1952,6 +1953,7 @@ void WI_Ticker(void)
   }
 
   WI_checkForAccelerate();
+  R_PrefetchTic();
 
   switch (state)
   {
@@ -2100,6 +2102,9 @@ void WI_Start(wbstartstruct_t* wbstartstruct)
   WI_initVariables(wbstartstruct);
   WI_loadData();
 
+  R_StartPrefetch(wbs->nextep+1, wbs->next+1,
+                  G_SkyTexture(wbs->nextmapinfo, wbs->nextep+1, wbs->next+1));
+
   if (deathmatch)
     WI_initDeathmatchStats();
   else if (netgame)
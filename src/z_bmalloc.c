@@ -41,75 +41,78 @@
 typedef struct bmalpool_s {
   struct bmalpool_s *nextpool;
   size_t             blocks;
-  uint8_t            used[0];
 } bmalpool_t;
 
-static INLINE void* getelem(bmalpool_t *p, size_t size, size_t n)
-{
-  return (((uint8_t*)p) + sizeof(bmalpool_t) + sizeof(uint8_t)*(p->blocks) + size*n);
-}
-
-static INLINE int iselem(const bmalpool_t *pool, size_t size, const void* p)
-{
-  // CPhipps - need portable # of bytes between pointers
-  int dif = (const char*)p - (const char*)pool;
+/* Each block is preceded by the zone it belongs to, so a block can be
+ * freed without knowing its zone and a free to the wrong zone is caught.
+ */
+typedef union {
+  struct block_memory_alloc_s *zone;
+  int64_t align;
+} bmalheader_t;
 
-  dif -= sizeof(bmalpool_t);
-  dif -= pool->blocks;
-  if (dif<0) return -1;
-  dif /= size;
-  return (((size_t)dif >= pool->blocks) ? -1 : dif);
-}
+#define BLOCKSIZE(pzone) (sizeof(bmalheader_t) + (pzone)->size)
 
-enum { unused_block = 0, used_block = 1};
+/* Free blocks are kept on a list threaded through their first word, so
+ * neither allocating nor freeing has to search the pools. Pools are only
+ * given back when their tag is freed; until then a freed block is handed
+ * out again before any fresh one, which keeps the live blocks packed.
+ */
 
 void* Z_BMalloc(struct block_memory_alloc_s *pzone)
 {
-   register bmalpool_t **pool = (bmalpool_t **)&(pzone->firstpool);
-   while (*pool != NULL)
-   {
-      uint8_t *p = memchr((*pool)->used, unused_block, (*pool)->blocks); // Scan for unused marker
-      if (p) {
-         int n = p - (*pool)->used;
-         (*pool)->used[n] = used_block;
-         return getelem(*pool, pzone->size, n);
-      } else
-         pool = &((*pool)->nextpool);
-   }
+   void *p = pzone->freelist;
 
+   if (!p)
    {
       // Nothing available, must allocate a new pool
-      bmalpool_t *newpool;
-
-      // CPhipps: Allocate new memory, initialised to 0
-
-      *pool = newpool = Z_Calloc(sizeof(*newpool) + (sizeof(uint8_t) + pzone->size)*(pzone->perpool),
-            1,  pzone->tag, NULL);
-      newpool->nextpool = NULL; // NULL = (void*)0 so this is redundant
+      bmalpool_t *newpool = Z_Malloc(sizeof(*newpool) + BLOCKSIZE(pzone)*pzone->perpool,
+            pzone->tag, NULL);
+      uint8_t *first = (uint8_t *)newpool + sizeof(*newpool);
+      uint8_t *elem = first + BLOCKSIZE(pzone)*pzone->perpool;
 
-      // Return element 0 from this pool to satisfy the request
-      newpool->used[0] = used_block;
+      newpool->nextpool = pzone->firstpool;
       newpool->blocks = pzone->perpool;
-      return getelem(newpool, pzone->size, 0);
+      pzone->firstpool = newpool;
+      pzone->pools++;
+
+      // Thread the new blocks so they are handed out in address order
+      while (elem > first)
+      {
+         elem -= BLOCKSIZE(pzone);
+         ((bmalheader_t *)elem)->zone = pzone;
+         *(void **)(elem + sizeof(bmalheader_t)) = p;
+         p = elem + sizeof(bmalheader_t);
+      }
    }
+
+   pzone->freelist = *(void **)p;
+   if (++pzone->inuse > pzone->peak)
+      pzone->peak = pzone->inuse;
+   return p;
 }
 
 void Z_BFree(struct block_memory_alloc_s *pzone, void* p)
 {
-  register bmalpool_t **pool = (bmalpool_t**)&(pzone->firstpool);
+   if (Z_BZoneOf(p) != pzone)
+      I_Error("Z_BFree: Free not in zone %s", pzone->desc);
 
-  while (*pool != NULL) {
-    int n = iselem(*pool, pzone->size, p);
-    if (n >= 0) {
-      (*pool)->used[n] = unused_block;
-      if (memchr(((*pool)->used), used_block, (*pool)->blocks) == NULL) {
-  // Block is all unused, can be freed
-  bmalpool_t *oldpool = *pool;
-  *pool = (*pool)->nextpool;
-  Z_Free(oldpool);
-      }
-      return;
-    } else pool = &((*pool)->nextpool);
-  }
-  I_Error("Z_BFree: Free not in zone %s", pzone->desc);
+   *(void **)p = pzone->freelist;
+   pzone->freelist = p;
+   pzone->inuse--;
+}
+
+struct block_memory_alloc_s *Z_BZoneOf(const void *p)
+{
+   return ((const bmalheader_t *)p - 1)->zone;
+}
+
+void Z_BDumpStats(const struct block_memory_alloc_s *pzone)
+{
+   if (pzone->pools)
+      lprintf(LO_DEBUG, "%s: %lu of %lu blocks in use, peak %lu, %lu pools of %lu bytes\n",
+            pzone->desc, (unsigned long) pzone->inuse,
+            (unsigned long) (pzone->pools*pzone->perpool),
+            (unsigned long) pzone->peak, (unsigned long) pzone->pools,
+            (unsigned long) (BLOCKSIZE(pzone)*pzone->perpool));
 }
@@ -40,12 +40,15 @@ struct block_memory_alloc_s {
   size_t perpool;
   int    tag;
   const char *desc;
+  void  *freelist;
+  size_t inuse, peak, pools;
 };
 
 #define DECLARE_BLOCK_MEMORY_ALLOC_ZONE(name) extern struct block_memory_alloc_s name
 #define IMPLEMENT_BLOCK_MEMORY_ALLOC_ZONE(name, size, tag, num, desc) \
-struct block_memory_alloc_s name = { NULL, size, num, tag, desc}
-#define NULL_BLOCK_MEMORY_ALLOC_ZONE(name) name.firstpool = NULL
+struct block_memory_alloc_s name = { NULL, size, num, tag, desc, NULL, 0, 0, 0 }
+#define NULL_BLOCK_MEMORY_ALLOC_ZONE(name) \
+(name.firstpool = name.freelist = NULL, name.inuse = name.peak = name.pools = 0)
 
 void* Z_BMalloc(struct block_memory_alloc_s *pzone);
 
@@ -54,4 +57,10 @@ static INLINE void* Z_BCalloc(struct block_memory_alloc_s *pzone)
 
 void Z_BFree(struct block_memory_alloc_s *pzone, void* p);
 
+// The zone a block was allocated from
+struct block_memory_alloc_s *Z_BZoneOf(const void *p);
+
+// Prints how full the zone's pools are, at LO_DEBUG
+void Z_BDumpStats(const struct block_memory_alloc_s *pzone);
+
 #endif
@@ -75,13 +75,34 @@
 // Number of mallocs & frees kept in history buffer (must be a power of 2)
 #define ZONE_HISTORY 4
 
+// Size of the chunks PU_LEVEL and PU_LEVSPEC blocks are carved from
+#ifdef MEMORY_LOW
+#define ARENA_CHUNK_SIZE (64*1024)
+#else
+#define ARENA_CHUNK_SIZE (256*1024)
+#endif
+
+// Level blocks up to this size are carved from shared chunks and kept
+// for reuse by the next allocation of the same size once they are
+// freed; bigger ones get a chunk of their own, given back when freed
+#define ARENA_MAX_REUSE 4096
+
 // End Tunables
 
+#define ARENA_BINS (ARENA_MAX_REUSE/CHUNK_SIZE)
+
+// Tags whose blocks live in an arena and are all released in one go
+#define ARENA_TAG(tag) ((tag) == PU_LEVEL || (tag) == PU_LEVSPEC)
+
+// Where the memory of a block came from
+enum {BLOCK_HEAP, BLOCK_ARENA, BLOCK_LARGE};
+
 typedef struct memblock {
   struct memblock *next,*prev;
   size_t size;
   void **user;
   unsigned char tag;
+  unsigned char arena;
 
 } memblock_t;
 
@@ -92,6 +113,37 @@ static const size_t HEADER_SIZE = (sizeof(memblock_t)+CHUNK_SIZE-1) & ~(CHUNK_SI
 
 static memblock_t *blockbytag[PU_MAX];
 
+/* Arenas
+ * Level data is allocated by the thousand and freed all at once on level
+ * exit, so instead of a malloc per block it is bump-allocated from large
+ * chunks. Blocks keep their usual header and stay linked into blockbytag,
+ * so Z_Free and Z_Realloc work on them as before; a freed block goes on a
+ * free list for its size, and one too large for those lists gives its own
+ * chunk back, so no freed block is left unused until the level ends.
+ * Z_FreeTags then drops the whole arena without visiting every block.
+ */
+
+typedef struct arenachunk {
+  struct arenachunk *next,*prev;
+  size_t size;                 // bytes available after the chunk header
+  size_t used;                 // bytes handed out so far
+} arenachunk_t;
+
+static const size_t CHUNK_HEADER_SIZE = (sizeof(arenachunk_t)+CHUNK_SIZE-1) & ~(CHUNK_SIZE-1);
+
+typedef struct {
+  arenachunk_t *chunks;        // shared chunks, the one in use first
+  arenachunk_t *large;         // chunks holding a single large block
+  memblock_t *freebin[ARENA_BINS]; // freed blocks by size
+  int users;                   // live blocks with a user pointer
+
+  // statistics since the arena was last released
+  unsigned allocs, reused;
+  size_t inuse, highwater, chunkbytes;
+} arena_t;
+
+static arena_t arenas[PU_MAX];
+
 // 0 means unlimited, any other value is a hard limit
 #ifdef MEMORY_LOW
 /* Set a default limit of 16 MB; smaller values
@@ -106,10 +158,82 @@ static int memory_size = 0;
 static int free_memory = 0;
 
 
+zonestats_t zonestats[PU_MAX];
+
+static const char *const tagnames[PU_MAX] = {
+   "FREE", "STATIC", "SOUND", "MUSIC", "LEVEL", "LEVSPEC", "CACHE"
+};
+
+const char *Z_TagName(int tag)
+{
+   return tagnames[tag];
+}
+
+static void Z_AddStats(int tag, size_t size)
+{
+   zonestats_t *stats = &zonestats[tag];
+
+   stats->live += size;
+   stats->blocks++;
+   if (stats->live > stats->peak)
+      stats->peak = stats->live;
+}
+
+static void Z_SubStats(int tag, size_t size)
+{
+   zonestats[tag].live -= size;
+   zonestats[tag].blocks--;
+}
+
+/* Z_NextTic
+ * Called once per game tic to close the allocation count for the tic.
+ */
+
+void Z_NextTic(void)
+{
+   int tag;
+
+   for (tag = 0; tag < PU_MAX; tag++)
+   {
+      zonestats_t *stats = &zonestats[tag];
+
+      stats->lasttic = stats->allocs;
+      if (stats->allocs > stats->maxtic)
+         stats->maxtic = stats->allocs;
+      stats->allocs = 0;
+   }
+}
+
+/* Z_DumpHistory
+ * Logs the accounting of every tag, then starts the peaks afresh from
+ * what is live now. Called on level change. buf is unused.
+ */
+
 void Z_DumpHistory(char *buf)
 {
+   size_t live = 0, peak = 0;
+   int tag;
+
+   lprintf(LO_DEBUG, "Z_DumpHistory: tag       live KB  peak KB   blocks  allocs/tic (max)\n");
+   for (tag = PU_FREE+1; tag < PU_MAX; tag++)
+   {
+      zonestats_t *stats = &zonestats[tag];
+
+      lprintf(LO_DEBUG, "Z_DumpHistory: %-8s %8lu %8lu %8u %7u (%u)\n",
+            tagnames[tag], (unsigned long) stats->live >> 10,
+            (unsigned long) stats->peak >> 10, stats->blocks,
+            stats->lasttic, stats->maxtic);
+      live += stats->live;
+      peak += stats->peak;
+      stats->peak = stats->live;
+      stats->maxtic = stats->lasttic;
+   }
+   lprintf(LO_DEBUG, "Z_DumpHistory: total    %8lu %8lu, %d KB from the system, limit %d KB\n",
+         (unsigned long) live >> 10, (unsigned long) peak >> 10,
+         -free_memory >> 10, memory_size >> 10);
 }
 
+static void Z_ArenaRelease(int tag, bool keepchunk);
 
 void Z_Close(void)
 {
@@ -117,7 +241,16 @@ void Z_Close(void)
     * close content if we free memory
     * here while running on Windows... */
 #if !defined(_WIN32)
-   Z_FreeTags(PU_FREE, PU_MAX);
+   int tag;
+   /* Highest tags and newest blocks first: a block's user pointer can
+    * live in an older block, e.g. the lump cache array, and that one
+    * must still be there when the block goes */
+   for (tag = PU_MAX-1; tag > PU_FREE; tag--)
+      if (ARENA_TAG(tag))
+         Z_ArenaRelease(tag, false);
+      else
+         while (blockbytag[tag])
+            (Z_Free)((uint8_t*) blockbytag[tag]->prev + HEADER_SIZE);
 #endif
    memory_size = 0;
    free_memory = 0;
@@ -128,10 +261,207 @@ bool Z_Init(void)
    unsigned i;
    for (i = 0; i < PU_MAX; i++)
       blockbytag[i] = NULL;
+   memset(arenas, 0, sizeof(arenas));
+   memset(zonestats, 0, sizeof(zonestats));
 
    return true;
 }
 
+cachestats_t cachestats;
+
+/* Z_Evict
+ * Purges PU_CACHE blocks until at least the given number of bytes has been
+ * freed, or the cache is empty. Blocks join the tail of the PU_CACHE list
+ * when the last lock on them is released (see Z_ChangeTag), so starting
+ * from the head throws out the least recently used data first.
+ */
+
+static void Z_Evict(size_t bytes)
+{
+   size_t freed = 0;
+
+   while (freed < bytes && blockbytag[PU_CACHE])
+   {
+      memblock_t *block = blockbytag[PU_CACHE];
+      freed += block->size;
+      cachestats.evictions++;
+      cachestats.evicted += block->size;
+      (Z_Free)((uint8_t*) block + HEADER_SIZE);
+   }
+}
+
+/* Z_SysMalloc
+ * Gets memory from the system, evicting cache blocks first if that would
+ * go over the purge limit, and again for as long as malloc fails.
+ */
+
+static void *Z_SysMalloc(size_t bytes)
+{
+   void *p;
+
+   if (memory_size > 0 && ((free_memory + memory_size) < (int)bytes))
+      Z_Evict(bytes - (free_memory + memory_size));
+
+   while (!(p = (malloc)(bytes))) {
+      if (!blockbytag[PU_CACHE])
+         I_Error ("Z_Malloc: Failure trying to allocate %lu bytes"
+               ,(unsigned long) bytes
+               );
+      Z_Evict(bytes);
+   }
+
+   return p;
+}
+
+static arenachunk_t *Z_NewChunk(arena_t *arena, size_t size)
+{
+   size_t bytes = CHUNK_HEADER_SIZE + size;
+   arenachunk_t *chunk = Z_SysMalloc(bytes);
+
+   chunk->size = size;
+   chunk->used = 0;
+   free_memory -= bytes;
+   arena->chunkbytes += bytes;
+   return chunk;
+}
+
+static void Z_FreeChunk(arena_t *arena, arenachunk_t *chunk)
+{
+   size_t bytes = CHUNK_HEADER_SIZE + chunk->size;
+
+   free_memory += bytes;
+   arena->chunkbytes -= bytes;
+   (free)(chunk);
+}
+
+static memblock_t *Z_ArenaAlloc(arena_t *arena, size_t size)
+{
+   size_t bytes = size + HEADER_SIZE;
+   arenachunk_t *chunk;
+   memblock_t *block;
+
+   arena->allocs++;
+   arena->inuse += size;
+   if (arena->inuse > arena->highwater)
+      arena->highwater = arena->inuse;
+
+   if (size <= ARENA_MAX_REUSE && (block = arena->freebin[size/CHUNK_SIZE-1]))
+   {
+      arena->freebin[size/CHUNK_SIZE-1] = block->next;
+      arena->reused++;
+      return block;
+   }
+
+   // Blocks too large for the free lists get a chunk of their own, so
+   // they can be given back
+   if (size > ARENA_MAX_REUSE)
+   {
+      chunk = Z_NewChunk(arena, bytes);
+      chunk->used = bytes;
+      chunk->prev = NULL;
+      chunk->next = arena->large;
+      if (arena->large)
+         arena->large->prev = chunk;
+      arena->large = chunk;
+      block = (memblock_t *)((uint8_t*) chunk + CHUNK_HEADER_SIZE);
+      block->arena = BLOCK_LARGE;
+      return block;
+   }
+
+   chunk = arena->chunks;
+   if (!chunk || chunk->used + bytes > chunk->size)
+   {
+      chunk = Z_NewChunk(arena, ARENA_CHUNK_SIZE - CHUNK_HEADER_SIZE);
+      chunk->next = arena->chunks;
+      arena->chunks = chunk;
+   }
+   block = (memblock_t *)((uint8_t*) chunk + CHUNK_HEADER_SIZE + chunk->used);
+   chunk->used += bytes;
+   block->arena = BLOCK_ARENA;
+   return block;
+}
+
+static void Z_ArenaFree(arena_t *arena, memblock_t *block)
+{
+   arena->inuse -= block->size;
+
+   if (block->arena == BLOCK_LARGE)
+   {
+      arenachunk_t *chunk = (arenachunk_t *)((uint8_t*) block - CHUNK_HEADER_SIZE);
+      if (chunk->prev)
+         chunk->prev->next = chunk->next;
+      else
+         arena->large = chunk->next;
+      if (chunk->next)
+         chunk->next->prev = chunk->prev;
+      Z_FreeChunk(arena, chunk);
+   }
+   else
+   {
+      block->next = arena->freebin[block->size/CHUNK_SIZE-1];
+      arena->freebin[block->size/CHUNK_SIZE-1] = block;
+   }
+}
+
+/* Z_ArenaRelease
+ * Frees every block of an arena tag. Only the blocks' users need
+ * visiting, and only if there are any; one chunk is kept for the
+ * next level unless the zone is shutting down.
+ */
+
+static void Z_ArenaRelease(int tag, bool keepchunk)
+{
+   arena_t *arena = &arenas[tag];
+   arenachunk_t *chunk;
+
+   if (arena->users)
+   {
+      memblock_t *block = blockbytag[tag];
+      do {
+         if (block->user)
+            *block->user = NULL;
+         block = block->next;
+      } while (block != blockbytag[tag]);
+   }
+   blockbytag[tag] = NULL;
+   zonestats[tag].live = 0;
+   zonestats[tag].blocks = 0;
+
+   if (arena->allocs)
+      lprintf(LO_DEBUG, "Z_FreeTags: tag %d: %u allocations (%u reused), "
+            "high water %lu KB in %lu KB of chunks\n", tag,
+            arena->allocs, arena->reused,
+            (unsigned long) arena->highwater >> 10,
+            (unsigned long) arena->chunkbytes >> 10);
+
+   while ((chunk = arena->large))
+   {
+      arena->large = chunk->next;
+      Z_FreeChunk(arena, chunk);
+   }
+
+   chunk = arena->chunks;
+   if (chunk && keepchunk)
+   {
+      chunk = chunk->next;
+      arena->chunks->next = NULL;
+      arena->chunks->used = 0;
+   }
+   else
+      arena->chunks = NULL;
+   while (chunk)
+   {
+      arenachunk_t *next = chunk->next;
+      Z_FreeChunk(arena, chunk);
+      chunk = next;
+   }
+
+   memset(arena->freebin, 0, sizeof(arena->freebin));
+   arena->users = 0;
+   arena->allocs = arena->reused = 0;
+   arena->inuse = arena->highwater = 0;
+}
+
 /* Z_Malloc
  * You can pass a NULL user if the tag is < PU_PURGELEVEL.
  *
@@ -153,31 +483,17 @@ void *Z_Malloc(size_t size, int tag, void **user)
 
    size = (size+CHUNK_SIZE-1) & ~(CHUNK_SIZE-1);  // round to chunk size
 
-   if (memory_size > 0 && ((free_memory + memory_size) < (int)(size + HEADER_SIZE)))
+   if (ARENA_TAG(tag))
    {
-      memblock_t *end_block;
-      block = blockbytag[PU_CACHE];
-      if (block)
-      {
-         end_block = block->prev;
-         while (1)
-         {
-            memblock_t *next = block->next;
-            (Z_Free)((uint8_t*) block + HEADER_SIZE);
-            if (((free_memory + memory_size) >= (int)(size + HEADER_SIZE)) || (block == end_block))
-               break;
-            block = next;               // Advance to next block
-         }
-      }
-      block = NULL;
+      block = Z_ArenaAlloc(&arenas[tag], size);
+      if (user)
+         arenas[tag].users++;
    }
-
-   while (!(block = (malloc)(size + HEADER_SIZE))) {
-      if (!blockbytag[PU_CACHE])
-         I_Error ("Z_Malloc: Failure trying to allocate %lu bytes"
-               ,(unsigned long) size
-               );
-      Z_FreeTags(PU_CACHE,PU_CACHE);
+   else
+   {
+      block = Z_SysMalloc(size + HEADER_SIZE);
+      block->arena = BLOCK_HEAP;
+      free_memory -= size;
    }
 
    if (!blockbytag[tag])
@@ -194,8 +510,8 @@ void *Z_Malloc(size_t size, int tag, void **user)
    }
 
    block->size = size;
-
-   free_memory -= block->size;
+   Z_AddStats(tag, size);
+   zonestats[tag].allocs++;
 
    block->tag = tag;           // tag
    block->user = user;         // user
@@ -223,6 +539,15 @@ void Z_Free(void *p)
          blockbytag[block->tag] = block->next;
    block->prev->next = block->next;
    block->next->prev = block->prev;
+   Z_SubStats(block->tag, block->size);
+
+   if (block->arena != BLOCK_HEAP)
+   {
+      if (block->user)
+         arenas[block->tag].users--;
+      Z_ArenaFree(&arenas[block->tag], block);
+      return;
+   }
 
    free_memory += block->size;
 
@@ -241,6 +566,13 @@ void Z_FreeTags(int lowtag, int hightag)
    for (;lowtag <= hightag; lowtag++)
    {
       memblock_t *block, *end_block;
+
+      if (ARENA_TAG(lowtag))
+      {
+         Z_ArenaRelease(lowtag, true);
+         continue;
+      }
+
       block = blockbytag[lowtag];
       if (!block)
          continue;
@@ -276,6 +608,15 @@ void Z_ChangeTag(void *ptr, int tag)
    if (tag == block->tag)
       return;
 
+   // arena memory can't change hands, nor can heap blocks join an arena.
+   // Nothing asks for that: the only callers are the lump and patch
+   // caches locking and unlocking their blocks, PU_CACHE <-> PU_STATIC.
+   if (block->arena != BLOCK_HEAP || ARENA_TAG(tag))
+   {
+      I_Error("Z_ChangeTag: Cannot change tag %d to %d", block->tag, tag);
+      return;
+   }
+
    if (block == block->next)
       blockbytag[block->tag] = NULL;
    else
@@ -297,6 +638,8 @@ void Z_ChangeTag(void *ptr, int tag)
       blockbytag[tag]->prev = block;
    }
 
+   Z_SubStats(block->tag, block->size);
+   Z_AddStats(tag, block->size);
    block->tag = tag;
 }
 
@@ -334,8 +677,67 @@ char *Z_Strdup(const char *s, int tag, void **user)
    return strcpy((Z_Malloc)(strlen(s)+1, tag, user DA(file, line)), s);
 }
 
+/* Z_CheckHeap
+ * Walks every tag's block list, checking the links, the tags and that the
+ * accounting matches what is really there. Only built with ZONEIDCHECK
+ * (see config.h) or INSTRUMENTED.
+ */
+
 void Z_CheckHeap(void)
 {
+#if defined(ZONEIDCHECK) || defined(INSTRUMENTED)
+   int tag;
+
+   for (tag = PU_FREE+1; tag < PU_MAX; tag++)
+   {
+      memblock_t *block = blockbytag[tag];
+      size_t live = 0;
+      unsigned blocks = 0;
+
+      if (block)
+         do {
+            if (block->tag != tag || block->next->prev != block)
+            {
+               I_Error("Z_CheckHeap: Block list of tag %s is corrupt", tagnames[tag]);
+               return;
+            }
+            live += block->size;
+            blocks++;
+            block = block->next;
+         } while (block != blockbytag[tag]);
+
+      if (live != zonestats[tag].live || blocks != zonestats[tag].blocks)
+         I_Error("Z_CheckHeap: Tag %s holds %u blocks of %lu bytes, accounted %u of %lu",
+               tagnames[tag], blocks, (unsigned long) live,
+               zonestats[tag].blocks, (unsigned long) zonestats[tag].live);
+   }
+#endif
+}
+
+/* Z_PrintCacheStats
+ * Reports how the caches fared since the last call, against the purge
+ * limit if there is one, and starts counting afresh.
+ */
+
+void Z_PrintCacheStats(void)
+{
+   size_t cached = 0;
+   memblock_t *block = blockbytag[PU_CACHE];
+
+   if (block)
+      do {
+         cached += block->size;
+         block = block->next;
+      } while (block != blockbytag[PU_CACHE]);
+
+   if (cachestats.hits || cachestats.misses)
+      lprintf(LO_DEBUG, "Z_PrintCacheStats: %u hits, %u misses, "
+            "%u evictions (%lu KB), %lu KB purgeable, limit %d KB\n",
+            cachestats.hits, cachestats.misses, cachestats.evictions,
+            (unsigned long) cachestats.evicted >> 10,
+            (unsigned long) cached >> 10, memory_size >> 10);
+
+   memset(&cachestats, 0, sizeof(cachestats));
 }
 
 void Z_SetPurgeLimit(int size)
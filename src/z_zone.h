@@ -77,6 +77,30 @@ void (Z_CheckHeap)(DAC(const char *,int));   // killough 3/22/98: add file/line
 void Z_DumpHistory(char *);
 void Z_SetPurgeLimit(int size);
 
+/* PU_CACHE statistics, for tuning the purge limit. The caches built on
+ * PU_CACHE count their own hits and misses, Z_Malloc counts evictions */
+typedef struct {
+  unsigned hits, misses, evictions;
+  size_t evicted;
+} cachestats_t;
+
+extern cachestats_t cachestats;
+void Z_PrintCacheStats(void);
+
+/* Memory accounting per tag, for sizing the MEMORY_LOW budgets */
+typedef struct {
+  size_t live;        /* bytes in live blocks */
+  size_t peak;        /* most live bytes since the last Z_DumpHistory */
+  unsigned blocks;    /* live blocks */
+  unsigned allocs;    /* allocations so far this tic */
+  unsigned lasttic;   /* allocations in the last tic */
+  unsigned maxtic;    /* most allocations in a tic since Z_DumpHistory */
+} zonestats_t;
+
+extern zonestats_t zonestats[PU_MAX];
+const char *Z_TagName(int tag);
+void Z_NextTic(void);
+
 // Remove all definitions before including system definitions
 
 #undef malloc